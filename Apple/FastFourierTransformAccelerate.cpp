@@ -25,9 +25,11 @@
  
  */
 
+#include <algorithm>
 #include <dsperados/math/interleave.hpp>
 #include <stdexcept>
 
+#include "../FastFourierTransformPlanCache.hpp"
 #include "FastFourierTransformAccelerate.hpp"
 
 using namespace math;
@@ -40,7 +42,17 @@ namespace dsp
         evenFloat(size / 2),
         oddFloat(size / 2),
         evenDouble(size / 2),
-        oddDouble(size / 2)
+        oddDouble(size / 2),
+        inverseRealFloat(size / 2 + 1),
+        inverseImaginaryFloat(size / 2 + 1),
+        inverseRealDouble(size / 2 + 1),
+        inverseImaginaryDouble(size / 2 + 1),
+        setups(FastFourierTransformPlanCache<Setups>::get(size))
+    {
+        
+    }
+    
+    FastFourierTransformAccelerate::Setups::Setups(size_t size)
     {
         floatSetup.forward = vDSP_DFT_zrop_CreateSetup(nullptr, size, vDSP_DFT_FORWARD);
         floatSetup.inverse = vDSP_DFT_zrop_CreateSetup(nullptr, size, vDSP_DFT_INVERSE);
@@ -67,7 +79,7 @@ namespace dsp
         math::deinterleave(input, input + size, evenFloat.begin(), oddFloat.begin());
 
         // Do the transform
-        vDSP_DFT_Execute(floatSetup.forward, evenFloat.data(), oddFloat.data(), real, imaginary);
+        vDSP_DFT_Execute(setups->floatSetup.forward, evenFloat.data(), oddFloat.data(), real, imaginary);
 
         // In the forward direction, the scale is 2 (for some reason), so scale back by a half
         // Probably because both the negative and positive frequencies get summed, or something. The complex-to-complex
@@ -92,7 +104,7 @@ namespace dsp
         math::deinterleave(input, input + size, evenDouble.begin(), oddDouble.begin());
         
         // Do the transform
-        vDSP_DFT_ExecuteD(doubleSetup.forward, evenDouble.data(), oddDouble.data(), real, imaginary);
+        vDSP_DFT_ExecuteD(setups->doubleSetup.forward, evenDouble.data(), oddDouble.data(), real, imaginary);
         
         // In the forward direction, the scale is 2 (for some reason), so scale back by a half
         // Probably because both the negative and positive frequencies get summed, or something. The complex-to-complex
@@ -113,19 +125,21 @@ namespace dsp
     
     void FastFourierTransformAccelerate::inverse(const float* real, const float* imaginary, float* output)
     {
-        // Copy the input reals and imaginaries, so that we can change the format around to
-        // the way vDSP accepts it
-        vector<float> real_(real, real + size / 2 + 1);
-        vector<float> imaginary_(imaginary, imaginary + size / 2 + 1);
+        // Copy the input reals and imaginaries into preallocated buffers, so that we can change
+        // the format around to the way vDSP accepts it
+        auto& real_ = inverseRealFloat;
+        auto& imaginary_ = inverseImaginaryFloat;
+        std::copy(real, real + size / 2 + 1, real_.begin());
+        std::copy(imaginary, imaginary + size / 2 + 1, imaginary_.begin());
 
         // Re[Nyquist] is supposed to be stored in Im[0] for vDSP
         imaginary_[0] = real[size / 2];
 
         // Do the transform
-        vDSP_DFT_Execute(floatSetup.inverse, real_.data(), imaginary_.data(), real_.data(), imaginary_.data());
+        vDSP_DFT_Execute(setups->floatSetup.inverse, real_.data(), imaginary_.data(), real_.data(), imaginary_.data());
 
         // Combine the even and odd output signals into one interleaved output signal
-        math::interleave(real_.begin(), real_.end(), imaginary_.begin(), output);
+        math::interleave(real_.begin(), real_.begin() + size / 2, imaginary_.begin(), output);
 
         // For inverse DFT, the scaling is Size, so scale back by multiplying with its reciprocal
         const float factor = 1.0 / size;
@@ -134,19 +148,21 @@ namespace dsp
     
     void FastFourierTransformAccelerate::inverse(const double* real, const double* imaginary, double* output)
     {
-        // Copy the input reals and imaginaries, so that we can change the format around to
-        // the way vDSP accepts it
-        vector<double> real_(real, real + (size / 2 + 1));
-        vector<double> imaginary_(imaginary, imaginary + (size / 2 + 1));
+        // Copy the input reals and imaginaries into preallocated buffers, so that we can change
+        // the format around to the way vDSP accepts it
+        auto& real_ = inverseRealDouble;
+        auto& imaginary_ = inverseImaginaryDouble;
+        std::copy(real, real + size / 2 + 1, real_.begin());
+        std::copy(imaginary, imaginary + size / 2 + 1, imaginary_.begin());
         
         // Re[Nyquist] is supposed to be stored in Im[0] for vDSP
         imaginary_[0] = real[size / 2];
         
         // Do the transform
-        vDSP_DFT_ExecuteD(doubleSetup.inverse, real_.data(), imaginary_.data(), real_.data(), imaginary_.data());
+        vDSP_DFT_ExecuteD(setups->doubleSetup.inverse, real_.data(), imaginary_.data(), real_.data(), imaginary_.data());
         
         // Combine the even and odd output signals into one interleaved output signal
-        math::interleave(real_.begin(), real_.end(), imaginary_.begin(), output);
+        math::interleave(real_.begin(), real_.begin() + size / 2, imaginary_.begin(), output);
         
         // For inverse DFT, the scaling is Size, so scale back by multiplying with its reciprocal
         const double factor = 1.0 / size;
@@ -156,19 +172,19 @@ namespace dsp
     void FastFourierTransformAccelerate::forwardComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary)
     {
         // Do the transform
-        vDSP_DFT_Execute(floatComplexSetup.forward, inReal, inImaginary, outReal, outImaginary);
+        vDSP_DFT_Execute(setups->floatComplexSetup.forward, inReal, inImaginary, outReal, outImaginary);
     }
     
     void FastFourierTransformAccelerate::forwardComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary)
     {
         // Do the transform
-        vDSP_DFT_ExecuteD(doubleComplexSetup.forward, inReal, inImaginary, outReal, outImaginary);
+        vDSP_DFT_ExecuteD(setups->doubleComplexSetup.forward, inReal, inImaginary, outReal, outImaginary);
     }
     
     void FastFourierTransformAccelerate::inverseComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary)
     {
         // Do the transform
-        vDSP_DFT_Execute(floatComplexSetup.inverse, inReal, inImaginary, outReal, outImaginary);
+        vDSP_DFT_Execute(setups->floatComplexSetup.inverse, inReal, inImaginary, outReal, outImaginary);
         
         // For inverse DFT, the scaling is Size, so scale back by multiplying with its reciprocal
         const float factor = 1.0 / size;
@@ -179,7 +195,7 @@ namespace dsp
     void FastFourierTransformAccelerate::inverseComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary)
     {
         // Do the transform
-        vDSP_DFT_ExecuteD(doubleComplexSetup.inverse, inReal, inImaginary, outReal, outImaginary);
+        vDSP_DFT_ExecuteD(setups->doubleComplexSetup.inverse, inReal, inImaginary, outReal, outImaginary);
         
         // For inverse DFT, the scaling is Size, so scale back by multiplying with its reciprocal
         const double factor = 1.0 / size;
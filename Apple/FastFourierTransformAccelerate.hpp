@@ -30,6 +30,7 @@
 
 #include <Accelerate/Accelerate.h>
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "../FastFourierTransformBase.hpp"
@@ -66,6 +67,12 @@ namespace dsp
         std::vector<double> evenDouble;
         std::vector<double> oddDouble;
         
+        std::vector<float> inverseRealFloat;
+        std::vector<float> inverseImaginaryFloat;
+        
+        std::vector<double> inverseRealDouble;
+        std::vector<double> inverseImaginaryDouble;
+        
         struct SetupFloat
         {
             ~SetupFloat()
@@ -79,7 +86,7 @@ namespace dsp
             
             vDSP_DFT_Setup forward = nullptr;
             vDSP_DFT_Setup inverse = nullptr;
-        } floatSetup, floatComplexSetup;
+        };
         
         struct SetupDouble
         {
@@ -94,7 +101,18 @@ namespace dsp
             
             vDSP_DFT_SetupD forward = nullptr;
             vDSP_DFT_SetupD inverse = nullptr;
-        } doubleSetup, doubleComplexSetup;
+        };
+        
+        //! All vDSP setups for one size, shared through FastFourierTransformPlanCache
+        struct Setups
+        {
+            Setups(std::size_t size);
+            
+            SetupFloat floatSetup, floatComplexSetup;
+            SetupDouble doubleSetup, doubleComplexSetup;
+        };
+        
+        std::shared_ptr<const Setups> setups;
     };
 }
 
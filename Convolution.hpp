@@ -29,15 +29,24 @@
 #define GRIZZLY_CONVOLUTION_HPP
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
 #include <gsl/gsl>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
-#include "Delay.hpp"
+#include "FastFourierTransform.hpp"
+#include "PackedSpectrum.hpp"
 
 namespace dsp
 {
     //! Convolution, in the mathematical sense
+    /*! The input history is kept twice in a row, oldest sample first, so the last kernel-size samples are always
+        contiguous. Together with a reversed copy of the kernel, every output sample is a straight dot product, which is
+        spread over a vector's worth of partial sums so that it vectorizes without reordering the additions. */
     template <class T>
     class Convolution
     {
@@ -51,25 +60,16 @@ namespace dsp
         
         //! Construct with a kernel
         template <typename Iterator>
-        Convolution(Iterator begin, Iterator end) :
-            delay(std::distance(begin, end)),
-            kernel(begin, end)
+        Convolution(Iterator begin, Iterator end)
         {
-            
+            setKernel(begin, end);
         }
         
         //! Process a single sample
         T process(const T& x)
         {
-            // Write the input into the delay line
-            delay.write(x);
-            
-            // Convolve the past N samples with the kernel and sum them
-            T sum = 0;
-            for (auto h = 0; h < kernel.size(); ++h)
-                sum += kernel[h] * delay.read(h);
-            
-            return sum;
+            write(x);
+            return dot(history.data() + position);
         }
         
         //! Process a single sample
@@ -78,54 +78,256 @@ namespace dsp
             return process(x);
         }
         
+        //! Process a block of samples
+        /*! @note: The output may point to the input */
+        void processBlock(const T* input, T* output, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                write(input[i]);
+                output[i] = dot(history.data() + position);
+            }
+        }
+        
         //! Change the kernel
+        /*! The input history is kept, as far as the new kernel reaches */
         template <typename Iterator>
         void setKernel(Iterator begin, Iterator end)
         {
             kernel.assign(begin, end);
-            delay.resize(kernel.size());
+            reversedKernel.assign(kernel.rbegin(), kernel.rend());
+            
+            // Copy the latest samples, oldest first, into the new history
+            const auto size = std::max<std::size_t>(kernel.size(), 1);
+            std::vector<T> newHistory(2 * size, T(0));
+            const auto kept = std::min(size, length);
+            for (std::size_t i = 0; i < kept; ++i)
+                newHistory[size - kept + i] = newHistory[2 * size - kept + i] = history[position + length - kept + i];
+            
+            history = std::move(newHistory);
+            length = size;
+            position = 0;
         }
         
         //! Return the kernel
         const std::vector<T>& getKernel() const { return kernel; }
         
+        //! Clear the input history
+        void reset()
+        {
+            std::fill(history.begin(), history.end(), T(0));
+            position = 0;
+        }
+        
     private:
-        //! Delay line used for input
-        Delay<T> delay;
+        //! Write a sample into both halves of the history, after which the latest samples start at the position
+        void write(const T& x)
+        {
+            history[position] = x;
+            history[position + length] = x;
+            position = (position + 1 == length) ? 0 : position + 1;
+        }
         
+        //! Return the dot product of the reversed kernel with the latest samples
+        T dot(const T* latest) const
+        {
+            constexpr std::size_t lanes = 8;
+            const auto size = reversedKernel.size();
+            const T* taps = reversedKernel.data();
+            
+            T sum[lanes] = {};
+            const auto blocks = size / lanes;
+            for (std::size_t block = 0; block < blocks; ++block)
+            {
+                const T* t = taps + block * lanes;
+                const T* x = latest + block * lanes;
+                for (std::size_t lane = 0; lane < lanes; ++lane)
+                    sum[lane] += t[lane] * x[lane];
+            }
+            
+            // The remainder goes into a separate sum, as indexing the lanes at runtime would keep them out of registers
+            T total = 0;
+            for (auto i = blocks * lanes; i < size; ++i)
+                total += taps[i] * latest[i];
+            
+            for (std::size_t lane = 0; lane < lanes; ++lane)
+                total += sum[lane];
+            
+            return total;
+        }
+        
+    private:
         //! The convolution kernel
         std::vector<T> kernel;
+        
+        //! The kernel back to front, to line up with the history
+        std::vector<T> reversedKernel;
+        
+        //! The input history, twice in a row
+        std::vector<T> history;
+        
+        //! The length of the history, the kernel size (at least 1)
+        std::size_t length = 0;
+        
+        //! Where the latest length samples start, oldest first, and where the next sample is written
+        std::size_t position = 0;
     };
     
-    //! Convolve two buffers, return a buffer with size input + kernel - 1
-    template <typename InputIterator, typename KernelIterator>
-    static std::vector<std::common_type_t<typename InputIterator::value_type, typename KernelIterator::value_type>>
-    convolve(InputIterator inBegin, InputIterator inEnd, KernelIterator kernelBegin, KernelIterator kernelEnd)
+    //! Convolve two buffers directly, in O(inputSize * kernelSize) time
+    /*! @param output: Receives inputSize + kernelSize - 1 samples */
+    template <typename T>
+    void convolveDirect(const T* input, std::size_t inputSize, const T* kernel, std::size_t kernelSize, T* output)
     {
-        const auto inputSize = std::distance(inBegin, inEnd);
-        const auto kernelSize = std::distance(kernelBegin, kernelEnd);
-        
-        std::vector<std::common_type_t<typename InputIterator::value_type, typename KernelIterator::value_type>> output(inputSize + kernelSize - 1);
+        std::fill_n(output, inputSize + kernelSize - 1, T(0));
         
-        InputIterator input = inBegin;
-        for (int sample = 0; sample < output.size(); ++sample)
+        // Scale the input by each tap and add it in place, which leaves the inner loop without any bounds to check.
+        // The input is taken in chunks, so the output they add to stays in the cache for all taps.
+        const std::size_t chunkSize = 2048;
+        for (std::size_t begin = 0; begin < inputSize; begin += chunkSize)
         {
-            InputIterator input2 = input++;
-            KernelIterator kernel = kernelBegin;
+            const auto count = std::min(chunkSize, inputSize - begin);
+            const T* chunk = input + begin;
             
-            for (int h = 0; h < kernelSize; ++h)
+            for (std::size_t h = 0; h < kernelSize; ++h)
+            {
+                const auto tap = kernel[h];
+                T* destination = output + begin + h;
+                for (std::size_t i = 0; i < count; ++i)
+                    destination[i] += tap * chunk[i];
+            }
+        }
+    }
+    
+    //! Return the Fourier size that convolves most efficiently by overlap-add, from the sizes of the longest and shortest buffer
+    /*! Each block of size - shortest + 1 samples costs a forward and an inverse transform of the given size, so
+        bigger transforms amortize the shortest buffer better, up to the point where a single block covers all */
+    inline std::size_t getFourierConvolutionSize(std::size_t longest, std::size_t shortest)
+    {
+        std::size_t size = 2;
+        while (size < 2 * shortest)
+            size *= 2;
+        
+        auto bestSize = size;
+        auto bestCost = std::numeric_limits<double>::max();
+        for (; size < 2 * (longest + shortest); size *= 2)
+        {
+            const auto blockSize = size - shortest + 1;
+            const auto blockCount = (longest + blockSize - 1) / blockSize;
+            const auto cost = blockCount * size * (std::log2(size) + 1);
+            if (cost < bestCost)
             {
-                auto input3 = input2--;
-                if (sample - h < 0)
-                    continue;
-                
-                if (sample - h >= inputSize)
-                    continue;
-                
-                output[sample] += (*kernel++) * (*input3);
+                bestCost = cost;
+                bestSize = size;
             }
         }
         
+        return bestSize;
+    }
+    
+    //! Convolve two buffers by overlap-add with the Fourier transform, in O(n log n) time
+    /*! The output equals that of convolveDirect() up to rounding errors, relative to the largest output sample
+        @param output: Receives inputSize + kernelSize - 1 samples */
+    template <typename T>
+    void convolveFourier(const T* input, std::size_t inputSize, const T* kernel, std::size_t kernelSize, T* output)
+    {
+        // Convolution commutes, so partition the longest buffer and transform the shortest once
+        if (kernelSize > inputSize)
+        {
+            std::swap(input, kernel);
+            std::swap(inputSize, kernelSize);
+        }
+        
+        const auto outputSize = inputSize + kernelSize - 1;
+        const auto size = getFourierConvolutionSize(inputSize, kernelSize);
+        const auto blockSize = size - kernelSize + 1;
+        const auto fourier = createFastFourierTransform(size);
+        
+        std::vector<T> kernelSpectrum(size);
+        std::copy_n(kernel, kernelSize, kernelSpectrum.begin());
+        fourier->forwardPacked(kernelSpectrum.data(), kernelSpectrum.data());
+        
+        std::fill_n(output, outputSize, T(0));
+        
+        std::vector<T> block(size);
+        for (std::size_t begin = 0; begin < inputSize; begin += blockSize)
+        {
+            // Zero-pad each block, so its circular convolution with the kernel doesn't wrap around
+            const auto count = std::min(blockSize, inputSize - begin);
+            std::copy_n(input + begin, count, block.begin());
+            std::fill(block.begin() + count, block.end(), T(0));
+            
+            fourier->forwardPacked(block.data(), block.data());
+            multiplyPacked(block.data(), kernelSpectrum.data(), block.data(), size);
+            fourier->inversePacked(block.data(), block.data());
+            
+            // Add the block to the tails of the ones before it
+            const auto end = std::min(begin + count + kernelSize - 1, outputSize);
+            for (auto i = begin; i < end; ++i)
+                output[i] += block[i - begin];
+        }
+    }
+    
+    //! Return whether convolving buffers of the given sizes is faster with convolveFourier() than with convolveDirect()
+    /*! The costs, in nanoseconds per multiply-add and per transformed sample plus the setup of the transform, are
+        fitted to benchmark/Convolution.cpp. The direct path wins up to kernels of 32 to 64 taps. */
+    inline bool isFourierConvolutionFaster(std::size_t inputSize, std::size_t kernelSize)
+    {
+        const auto longest = std::max(inputSize, kernelSize);
+        const auto shortest = std::min(inputSize, kernelSize);
+        if (shortest < 2)
+            return false;
+        
+        const double directCost = 0.25 * longest * shortest;
+        
+        const auto size = getFourierConvolutionSize(longest, shortest);
+        const auto blockCount = (longest + size - shortest) / (size - shortest + 1);
+        const double fourierCost = 0.8 * blockCount * size * (std::log2(size) + 1) + 1000;
+        
+        return fourierCost < directCost;
+    }
+    
+    //! Convolve two buffers, with whichever of convolveDirect() and convolveFourier() is fastest for their sizes
+    /*! @param output: Receives inputSize + kernelSize - 1 samples */
+    template <typename T>
+    void convolve(const T* input, std::size_t inputSize, const T* kernel, std::size_t kernelSize, T* output)
+    {
+        // Only float and double have Fourier transforms, see the overloads below
+        convolveDirect(input, inputSize, kernel, kernelSize, output);
+    }
+    
+    //! Convolve two buffers, with whichever of convolveDirect() and convolveFourier() is fastest for their sizes
+    inline void convolve(const float* input, std::size_t inputSize, const float* kernel, std::size_t kernelSize, float* output)
+    {
+        if (isFourierConvolutionFaster(inputSize, kernelSize))
+            convolveFourier(input, inputSize, kernel, kernelSize, output);
+        else
+            convolveDirect(input, inputSize, kernel, kernelSize, output);
+    }
+    
+    //! Convolve two buffers, with whichever of convolveDirect() and convolveFourier() is fastest for their sizes
+    inline void convolve(const double* input, std::size_t inputSize, const double* kernel, std::size_t kernelSize, double* output)
+    {
+        if (isFourierConvolutionFaster(inputSize, kernelSize))
+            convolveFourier(input, inputSize, kernel, kernelSize, output);
+        else
+            convolveDirect(input, inputSize, kernel, kernelSize, output);
+    }
+    
+    //! Convolve two buffers, return a buffer with size input + kernel - 1
+    template <typename InputIterator, typename KernelIterator>
+    static std::vector<std::common_type_t<typename std::iterator_traits<InputIterator>::value_type, typename std::iterator_traits<KernelIterator>::value_type>>
+    convolve(InputIterator inBegin, InputIterator inEnd, KernelIterator kernelBegin, KernelIterator kernelEnd)
+    {
+        using T = std::common_type_t<typename std::iterator_traits<InputIterator>::value_type, typename std::iterator_traits<KernelIterator>::value_type>;
+        
+        const std::vector<T> input(inBegin, inEnd);
+        const std::vector<T> kernel(kernelBegin, kernelEnd);
+        if (input.empty() || kernel.empty())
+            return {};
+        
+        std::vector<T> output(input.size() + kernel.size() - 1);
+        convolve(input.data(), input.size(), kernel.data(), kernel.size(), output.data());
+        
         return output;
     }
 }
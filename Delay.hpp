@@ -28,6 +28,10 @@
 #ifndef GRIZZLY_DELAY_HPP
 #define GRIZZLY_DELAY_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
 #include <dsperados/math/interpolation.hpp>
 
 #include "CircularBuffer.hpp"
@@ -55,10 +59,11 @@ namespace dsp
         }
         
         //! Read from the delay line
+        /*! Whole sample delays are read directly, fractional ones are interpolated */
         template <class Index, class Interpolator = math::LinearInterpolation>
         T read(Index index, Interpolator interpolator = Interpolator()) const
         {
-            return interpolate(data.rbegin(), data.rend(), index, interpolator, math::ClampedAccess());
+            return read(index, interpolator, std::is_integral<Index>());
         }
         
         //! Set the maximum delay
@@ -70,6 +75,22 @@ namespace dsp
         //! Return the maximum number of delay samples
         std::size_t getMaximumDelayTime() const { return data.size() - 1; }
         
+    private:
+        //! Read a fractional delay, by interpolation
+        template <class Index, class Interpolator>
+        T read(Index index, Interpolator interpolator, std::false_type) const
+        {
+            return interpolate(data.rbegin(), data.rend(), index, interpolator, math::ClampedAccess());
+        }
+        
+        //! Read a whole sample delay, clamped to the delay line like the interpolation is
+        template <class Index, class Interpolator>
+        T read(Index index, Interpolator, std::true_type) const
+        {
+            const auto delay = (index < 0) ? std::size_t(0) : std::min<std::size_t>(index, data.size() - 1);
+            return data[data.size() - 1 - delay];
+        }
+        
     private:
         //! The data in the delay line
         CircularBuffer<T> data;
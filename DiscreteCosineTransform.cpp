@@ -0,0 +1,163 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "DiscreteCosineTransform.hpp"
+#include "FastFourierTransformPlanCache.hpp"
+#include "Ooura/TrigonometricTablesOoura.hpp"
+#include "Ooura/fftsg.h"
+
+using namespace std;
+
+namespace dsp
+{
+    //! Return a table in the form Ooura's routines expect
+    /*! The tables are fully initialized up front, so the routines only read them even though they take mutable pointers */
+    template <typename T>
+    static T* getTable(const vector<T>& table)
+    {
+        return const_cast<T*>(table.data());
+    }
+    
+    //! Throw if a size can't be transformed by Ooura's cosine and sine transforms
+    static size_t checkSize(size_t size)
+    {
+        if (size < 2 || (size & (size - 1)) != 0)
+            throw invalid_argument("DiscreteCosineTransform size should be a power of two (and at least 2)");
+        
+        return size;
+    }
+    
+    template <typename T>
+    DiscreteCosineTransform::Workspace<T>::Workspace(size_t size) :
+        data(size),
+        tables(FastFourierTransformPlanCache<TrigonometricTablesOoura<T>>::get(size))
+    {
+        
+    }
+    
+    DiscreteCosineTransform::DiscreteCosineTransform(size_t size) :
+        size(checkSize(size)),
+        floatWorkspace(size),
+        doubleWorkspace(size)
+    {
+        
+    }
+    
+    void DiscreteCosineTransform::forward(const float* input, float* output)
+    {
+        transform(Type::II, input, output, floatWorkspace);
+    }
+    
+    void DiscreteCosineTransform::forward(const double* input, double* output)
+    {
+        transform(Type::II, input, output, doubleWorkspace);
+    }
+    
+    void DiscreteCosineTransform::inverse(const float* input, float* output)
+    {
+        transform(Type::III, input, output, floatWorkspace);
+        
+        const auto factor = 2.f / size;
+        for (size_t i = 0; i < size; ++i)
+            output[i] *= factor;
+    }
+    
+    void DiscreteCosineTransform::inverse(const double* input, double* output)
+    {
+        transform(Type::III, input, output, doubleWorkspace);
+        
+        const auto factor = 2.0 / size;
+        for (size_t i = 0; i < size; ++i)
+            output[i] *= factor;
+    }
+    
+    void DiscreteCosineTransform::transform(Type type, const float* input, float* output)
+    {
+        transform(type, input, output, floatWorkspace);
+    }
+    
+    void DiscreteCosineTransform::transform(Type type, const double* input, double* output)
+    {
+        transform(type, input, output, doubleWorkspace);
+    }
+    
+    template <typename T>
+    void DiscreteCosineTransform::transform(Type type, const T* input, T* output, Workspace<T>& workspace)
+    {
+        auto& data = workspace.data;
+        auto& tables = *workspace.tables;
+        
+        switch (type)
+        {
+            case Type::II:
+                copy(input, input + size, data.begin());
+                ddct(static_cast<int>(size), -1, data.data(), getTable(tables.ip), getTable(tables.w));
+                break;
+            case Type::III:
+                copy(input, input + size, data.begin());
+                data[0] *= 0.5;
+                ddct(static_cast<int>(size), 1, data.data(), getTable(tables.ip), getTable(tables.w));
+                break;
+            case Type::IV:
+            {
+                // Pack the even samples and the odd ones in reverse as a complex sequence of half the size, twiddle it,
+                // transform it and twiddle again. The real and imaginary parts then hold the even and odd bins.
+                const auto half = size / 2;
+                for (size_t n = 0; n < half; ++n)
+                {
+                    const auto real = input[n * 2];
+                    const auto imaginary = input[size - 1 - n * 2];
+                    const auto twiddleReal = tables.preTwiddles[n * 2];
+                    const auto twiddleImaginary = tables.preTwiddles[n * 2 + 1];
+                    
+                    data[n * 2] = real * twiddleReal - imaginary * twiddleImaginary;
+                    data[n * 2 + 1] = real * twiddleImaginary + imaginary * twiddleReal;
+                }
+                
+                cdft(static_cast<int>(size), -1, data.data(), getTable(tables.ip), getTable(tables.w));
+                
+                for (size_t k = 0; k < half; ++k)
+                {
+                    const auto real = data[k * 2];
+                    const auto imaginary = data[k * 2 + 1];
+                    const auto twiddleReal = tables.postTwiddles[k * 2];
+                    const auto twiddleImaginary = tables.postTwiddles[k * 2 + 1];
+                    
+                    output[k * 2] = real * twiddleReal - imaginary * twiddleImaginary;
+                    output[size - 1 - k * 2] = -(real * twiddleImaginary + imaginary * twiddleReal);
+                }
+                
+                return;
+            }
+        }
+        
+        copy(data.begin(), data.end(), output);
+    }
+}
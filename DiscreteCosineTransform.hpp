@@ -0,0 +1,98 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_DISCRETE_COSINE_TRANSFORM_HPP
+#define GRIZZLY_DISCRETE_COSINE_TRANSFORM_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace dsp
+{
+    template <typename T>
+    struct TrigonometricTablesOoura;
+    
+    //! Discrete cosine transform based on Ooura's FFT code
+    /*! The transforms are unnormalized, for a size N they compute:
+        - DCT-II: X[k] = sum x[n] * cos(pi * (n + 1/2) * k / N)
+        - DCT-III: X[k] = x[0] / 2 + sum_{n > 0} x[n] * cos(pi * n * (k + 1/2) / N)
+        - DCT-IV: X[k] = sum x[n] * cos(pi * (n + 1/2) * (k + 1/2) / N)
+        DCT-III is the inverse of DCT-II and DCT-IV is its own inverse, both up to a factor 2 / N.
+        The input and output may point to the same buffer. */
+    class DiscreteCosineTransform
+    {
+    public:
+        //! The type of the transform
+        enum class Type { II, III, IV };
+        
+    public:
+        //! Construct the transform for a power of two size, of at least 2
+        DiscreteCosineTransform(std::size_t size);
+        
+        //! Forward transform (DCT-II)
+        void forward(const float* input, float* output);
+        void forward(const double* input, double* output);
+        
+        //! Inverse of the forward transform (DCT-III scaled by 2 / N)
+        void inverse(const float* input, float* output);
+        void inverse(const double* input, double* output);
+        
+        //! Unnormalized transform of a given type
+        void transform(Type type, const float* input, float* output);
+        void transform(Type type, const double* input, double* output);
+        
+        //! Return the size of the transform
+        std::size_t getSize() const { return size; }
+        
+    private:
+        //! Work buffer and tables for one precision
+        template <typename T>
+        struct Workspace
+        {
+            Workspace(std::size_t size);
+            
+            std::vector<T> data;
+            std::shared_ptr<const TrigonometricTablesOoura<T>> tables;
+        };
+        
+        template <typename T>
+        void transform(Type type, const T* input, T* output, Workspace<T>& workspace);
+        
+    private:
+        //! The size of the transform
+        std::size_t size = 0;
+        
+        //! Buffers and tables used by the float overloads
+        Workspace<float> floatWorkspace;
+        
+        //! Buffers and tables used by the double overloads
+        Workspace<double> doubleWorkspace;
+    };
+}
+
+#endif /* GRIZZLY_DISCRETE_COSINE_TRANSFORM_HPP */
@@ -0,0 +1,143 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "DiscreteSineTransform.hpp"
+#include "FastFourierTransformPlanCache.hpp"
+#include "Ooura/TrigonometricTablesOoura.hpp"
+#include "Ooura/fftsg.h"
+
+using namespace std;
+
+namespace dsp
+{
+    //! Return a table in the form Ooura's routines expect
+    /*! The tables are fully initialized up front, so the routines only read them even though they take mutable pointers */
+    template <typename T>
+    static T* getTable(const vector<T>& table)
+    {
+        return const_cast<T*>(table.data());
+    }
+    
+    //! Throw if a size can't be transformed by Ooura's cosine and sine transforms
+    static size_t checkSize(size_t size)
+    {
+        if (size < 2 || (size & (size - 1)) != 0)
+            throw invalid_argument("DiscreteSineTransform size should be a power of two (and at least 2)");
+        
+        return size;
+    }
+    
+    template <typename T>
+    DiscreteSineTransform::Workspace<T>::Workspace(size_t size) :
+        data(size),
+        tables(FastFourierTransformPlanCache<TrigonometricTablesOoura<T>>::get(size))
+    {
+        
+    }
+    
+    DiscreteSineTransform::DiscreteSineTransform(size_t size) :
+        size(checkSize(size)),
+        floatWorkspace(size),
+        doubleWorkspace(size),
+        cosine(size)
+    {
+        
+    }
+    
+    void DiscreteSineTransform::forward(const float* input, float* output)
+    {
+        transform(Type::II, input, output, floatWorkspace);
+    }
+    
+    void DiscreteSineTransform::forward(const double* input, double* output)
+    {
+        transform(Type::II, input, output, doubleWorkspace);
+    }
+    
+    void DiscreteSineTransform::inverse(const float* input, float* output)
+    {
+        transform(Type::III, input, output, floatWorkspace);
+        
+        const auto factor = 2.f / size;
+        for (size_t i = 0; i < size; ++i)
+            output[i] *= factor;
+    }
+    
+    void DiscreteSineTransform::inverse(const double* input, double* output)
+    {
+        transform(Type::III, input, output, doubleWorkspace);
+        
+        const auto factor = 2.0 / size;
+        for (size_t i = 0; i < size; ++i)
+            output[i] *= factor;
+    }
+    
+    void DiscreteSineTransform::transform(Type type, const float* input, float* output)
+    {
+        transform(type, input, output, floatWorkspace);
+    }
+    
+    void DiscreteSineTransform::transform(Type type, const double* input, double* output)
+    {
+        transform(type, input, output, doubleWorkspace);
+    }
+    
+    template <typename T>
+    void DiscreteSineTransform::transform(Type type, const T* input, T* output, Workspace<T>& workspace)
+    {
+        auto& data = workspace.data;
+        auto& tables = *workspace.tables;
+        
+        switch (type)
+        {
+            case Type::II:
+                // ddst leaves the last bin in front
+                copy(input, input + size, data.begin());
+                ddst(static_cast<int>(size), -1, data.data(), getTable(tables.ip), getTable(tables.w));
+                copy(data.begin() + 1, data.end(), output);
+                output[size - 1] = data[0];
+                break;
+            case Type::III:
+                // ddst expects the last sample in front
+                data[0] = input[size - 1] * 0.5;
+                copy(input, input + size - 1, data.begin() + 1);
+                ddst(static_cast<int>(size), 1, data.data(), getTable(tables.ip), getTable(tables.w));
+                copy(data.begin(), data.end(), output);
+                break;
+            case Type::IV:
+                // The sine transform equals the cosine transform of the reversed input, with every other bin negated
+                reverse_copy(input, input + size, data.begin());
+                cosine.transform(DiscreteCosineTransform::Type::IV, data.data(), output);
+                for (size_t k = 1; k < size; k += 2)
+                    output[k] = -output[k];
+                break;
+        }
+    }
+}
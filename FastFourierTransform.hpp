@@ -28,6 +28,10 @@
 #ifndef GRIZZLY_FAST_FOURIER_TRANSFORM_HPP
 #define GRIZZLY_FAST_FOURIER_TRANSFORM_HPP
 
+#include <cstddef>
+#include <memory>
+
+#include "MixedRadix/FastFourierTransformMixedRadix.hpp"
 #include "Ooura/FastFourierTransformOoura.hpp"
 
 #ifdef __APPLE__
@@ -38,5 +42,30 @@
     namespace dsp { using FastFourierTransform = FastFourierTransformOoura; }
 #endif
 
+#if !defined(__APPLE__) && defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+    #include "Simd/FastFourierTransformSimd.hpp"
+
+    #define GRIZZLY_FAST_FOURIER_TRANSFORM_SIMD
+#endif
+
+namespace dsp
+{
+    //! Create a Fourier transform for any size
+    /*! Sizes that are a power of two get the fastest backend of the platform (FastFourierTransformSimd on x86 Linux,
+        FastFourierTransform elsewhere), all others a FastFourierTransformMixedRadix */
+    inline std::unique_ptr<FastFourierTransformBase> createFastFourierTransform(std::size_t size)
+    {
+        if (size >= 2 && (size & (size - 1)) == 0)
+        {
+#ifdef GRIZZLY_FAST_FOURIER_TRANSFORM_SIMD
+            return std::make_unique<FastFourierTransformSimd>(size);
+#else
+            return std::make_unique<FastFourierTransform>(size);
+#endif
+        }
+        else
+            return std::make_unique<FastFourierTransformMixedRadix>(size);
+    }
+}
 
 #endif /* GRIZZLY_FAST_FOURIER_TRANSFORM_HPP */
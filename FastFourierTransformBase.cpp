@@ -29,13 +29,14 @@
 
 #include "FastFourierTransformBase.hpp"
 
-using namespace math;
 using namespace std;
 
 namespace dsp
 {
     FastFourierTransformBase::FastFourierTransformBase(size_t size) :
-        size(size)
+        size(size),
+        floatScratch(size),
+        doubleScratch(size)
     {
         
     }
@@ -53,4 +54,86 @@ namespace dsp
         forward(input, output.begin());
         return output;
     }
+    
+    void FastFourierTransformBase::forwardBatch(const float* input, size_t count, size_t inputStride, float* real, float* imaginary, size_t outputStride)
+    {
+        for (size_t i = 0; i < count; ++i)
+            forward(input + i * inputStride, real + i * outputStride, imaginary + i * outputStride);
+    }
+    
+    void FastFourierTransformBase::forwardBatch(const double* input, size_t count, size_t inputStride, double* real, double* imaginary, size_t outputStride)
+    {
+        for (size_t i = 0; i < count; ++i)
+            forward(input + i * inputStride, real + i * outputStride, imaginary + i * outputStride);
+    }
+    
+    void FastFourierTransformBase::inverseBatch(const float* real, const float* imaginary, size_t count, size_t inputStride, float* output, size_t outputStride)
+    {
+        for (size_t i = 0; i < count; ++i)
+            inverse(real + i * inputStride, imaginary + i * inputStride, output + i * outputStride);
+    }
+    
+    void FastFourierTransformBase::inverseBatch(const double* real, const double* imaginary, size_t count, size_t inputStride, double* output, size_t outputStride)
+    {
+        for (size_t i = 0; i < count; ++i)
+            inverse(real + i * inputStride, imaginary + i * inputStride, output + i * outputStride);
+    }
+    
+    template <typename T>
+    void FastFourierTransformBase::pack(const T* real, const T* imaginary, T* packed) const
+    {
+        assert(size % 2 == 0);
+        
+        packed[0] = real[0];
+        packed[1] = real[size / 2];
+        for (size_t k = 1; k < size / 2; ++k)
+        {
+            packed[k * 2] = real[k];
+            packed[k * 2 + 1] = -imaginary[k];
+        }
+    }
+    
+    template <typename T>
+    void FastFourierTransformBase::unpack(const T* packed, T* real, T* imaginary) const
+    {
+        assert(size % 2 == 0);
+        
+        real[0] = packed[0];
+        imaginary[0] = 0;
+        real[size / 2] = packed[1];
+        imaginary[size / 2] = 0;
+        for (size_t k = 1; k < size / 2; ++k)
+        {
+            real[k] = packed[k * 2];
+            imaginary[k] = -packed[k * 2 + 1];
+        }
+    }
+    
+    void FastFourierTransformBase::forwardPacked(const float* input, float* packed)
+    {
+        auto& scratch = getScratch<float>();
+        forward(input, scratch.outReal.data(), scratch.outImaginary.data());
+        pack(scratch.outReal.data(), scratch.outImaginary.data(), packed);
+    }
+    
+    void FastFourierTransformBase::forwardPacked(const double* input, double* packed)
+    {
+        auto& scratch = getScratch<double>();
+        forward(input, scratch.outReal.data(), scratch.outImaginary.data());
+        pack(scratch.outReal.data(), scratch.outImaginary.data(), packed);
+    }
+    
+    void FastFourierTransformBase::inversePacked(const float* packed, float* output)
+    {
+        auto& scratch = getScratch<float>();
+        unpack(packed, scratch.inReal.data(), scratch.inImaginary.data());
+        inverse(scratch.inReal.data(), scratch.inImaginary.data(), output);
+    }
+    
+    void FastFourierTransformBase::inversePacked(const double* packed, double* output)
+    {
+        auto& scratch = getScratch<double>();
+        unpack(packed, scratch.inReal.data(), scratch.inImaginary.data());
+        inverse(scratch.inReal.data(), scratch.inImaginary.data(), output);
+    }
 }
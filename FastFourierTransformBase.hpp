@@ -30,12 +30,18 @@
 
 #include <cstddef>
 #include <complex>
-#include <dsperados/math/interleave.hpp>
+#include <iterator>
+#include <type_traits>
 #include <vector>
 
+#include "PackedSpectrum.hpp"
+
 namespace dsp
 {
     //! Base class for Fourier transforms
+    /*! The overloads taking iterators to std::complex go through scratch buffers that are allocated once on
+        construction, so the ones writing to an output iterator never allocate. The overloads returning a
+        std::vector do allocate their result. */
     class FastFourierTransformBase
     {
     public:
@@ -167,73 +173,162 @@ namespace dsp
             @param inImaginary: Address of the real part of output, containing at least size elements */
         virtual void inverseComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary) = 0;
         
+    // --- Batch --- //
+        
+        //! Do the forward Fourier transform of several frames in one go
+        /*! The default implementation transforms the frames one by one, backends may override it to process several
+            frames at once.
+            @param input: Address of the first frame, each frame containing at least size elements
+            @param count: The number of frames
+            @param inputStride: The distance between the start of two consecutive frames (in elements)
+            @param real: Address of the real part of the first output spectrum, each containing at least (size / 2 + 1) elements
+            @param imaginary: Address of the imaginary part of the first output spectrum, each containing at least (size / 2 + 1) elements
+            @param outputStride: The distance between the start of two consecutive output spectra (in elements) */
+        virtual void forwardBatch(const float* input, std::size_t count, std::size_t inputStride, float* real, float* imaginary, std::size_t outputStride);
+        
+        //! Do the forward Fourier transform of several frames in one go
+        /*! @see forwardBatch(const float*, std::size_t, std::size_t, float*, float*, std::size_t) */
+        virtual void forwardBatch(const double* input, std::size_t count, std::size_t inputStride, double* real, double* imaginary, std::size_t outputStride);
+        
+        //! Do the inverse Fourier transform of several spectra in one go
+        /*! The default implementation transforms the spectra one by one, backends may override it to process several
+            spectra at once.
+            @param real: Address of the real part of the first input spectrum, each containing at least (size / 2 + 1) elements
+            @param imaginary: Address of the imaginary part of the first input spectrum, each containing at least (size / 2 + 1) elements
+            @param count: The number of spectra
+            @param inputStride: The distance between the start of two consecutive input spectra (in elements)
+            @param output: Address of the first output frame, each frame containing at least size elements
+            @param outputStride: The distance between the start of two consecutive output frames (in elements) */
+        virtual void inverseBatch(const float* real, const float* imaginary, std::size_t count, std::size_t inputStride, float* output, std::size_t outputStride);
+        
+        //! Do the inverse Fourier transform of several spectra in one go
+        /*! @see inverseBatch(const float*, const float*, std::size_t, std::size_t, float*, std::size_t) */
+        virtual void inverseBatch(const double* real, const double* imaginary, std::size_t count, std::size_t inputStride, double* output, std::size_t outputStride);
+        
+    // --- Packed --- //
+        
+        //! Do the forward Fourier transform into a packed spectrum
+        /*! The default implementation transforms into split buffers and packs those, backends whose native layout
+            is the packed one (Ooura) transform in place. The size should be even.
+            @param input: Address of the input data, containing at least size elements
+            @param packed: Address of the packed spectrum, containing at least size elements (may equal input)
+            @see PackedSpectrum */
+        virtual void forwardPacked(const float* input, float* packed);
+        
+        //! Do the forward Fourier transform into a packed spectrum
+        /*! @see forwardPacked(const float*, float*) */
+        virtual void forwardPacked(const double* input, double* packed);
+        
+        //! Do the inverse Fourier transform of a packed spectrum
+        /*! @param packed: Address of the packed spectrum, containing at least size elements
+            @param output: Address of the output data, containing at least size elements (may equal packed)
+            @see PackedSpectrum */
+        virtual void inversePacked(const float* packed, float* output);
+        
+        //! Do the inverse Fourier transform of a packed spectrum
+        /*! @see inversePacked(const float*, float*) */
+        virtual void inversePacked(const double* packed, double* output);
+        
+        //! Do the forward Fourier transform into a packed spectrum, of the same size as this transform
+        template <typename T>
+        void forwardPacked(const T* input, PackedSpectrum<T>& output) { forwardPacked(input, output.data.data()); }
+        
+        //! Do the inverse Fourier transform of a packed spectrum, of the same size as this transform
+        template <typename T>
+        void inversePacked(const PackedSpectrum<T>& input, T* output) { inversePacked(input.data.data(), output); }
+        
         //! Return the size this FFT operates with (= equal to the size of the input)
         std::size_t getSize() const { return size; }
         
     protected:
         //! The frame size
         std::size_t size = 0;
+        
+    private:
+        //! Split real and imaginary buffers used to (de)interleave std::complex data
+        template <typename T>
+        struct Scratch
+        {
+            Scratch(std::size_t size) : inReal(size), inImaginary(size), outReal(size), outImaginary(size) { }
+            
+            std::vector<T> inReal;
+            std::vector<T> inImaginary;
+            std::vector<T> outReal;
+            std::vector<T> outImaginary;
+        };
+        
+        //! Return the scratch buffers for a given precision
+        template <typename T>
+        Scratch<T>& getScratch();
+        
+        //! Pack a split spectrum into the packed layout
+        template <typename T>
+        void pack(const T* real, const T* imaginary, T* packed) const;
+        
+        //! Unpack a spectrum in the packed layout into a split one
+        template <typename T>
+        void unpack(const T* packed, T* real, T* imaginary) const;
+        
+    private:
+        //! Scratch buffers for std::complex<float> overloads
+        Scratch<float> floatScratch;
+        
+        //! Scratch buffers for std::complex<double> overloads
+        Scratch<double> doubleScratch;
     };
     
+    template <>
+    inline FastFourierTransformBase::Scratch<float>& FastFourierTransformBase::getScratch<float>() { return floatScratch; }
+    
+    template <>
+    inline FastFourierTransformBase::Scratch<double>& FastFourierTransformBase::getScratch<double>() { return doubleScratch; }
+    
     template <class InputIterator1, class InputIterator2, class ComplexOutputIterator>
     void interleave(InputIterator1 inBegin1, InputIterator1 inEnd, InputIterator2 rhs, ComplexOutputIterator outBegin)
     {
-        std::vector<typename ComplexOutputIterator::value_type::value_type> fout(std::distance(inBegin1, inEnd) * 2);
-        math::interleave(inBegin1, inEnd, rhs, fout.begin());
-        
-        for (auto it = fout.begin(); it != fout.end(); ++it)
+        for (; inBegin1 != inEnd; ++inBegin1, ++rhs, ++outBegin)
         {
-            outBegin->real(*it);
-            outBegin->imag(*(++it));
-            
-            ++outBegin;
+            outBegin->real(*inBegin1);
+            outBegin->imag(*rhs);
         }
     }
     
     template <class ComplexInputIterator, class OutputIterator1, class OutputIterator2>
     void deinterleave(ComplexInputIterator inBegin, ComplexInputIterator inEnd, OutputIterator1 outBegin1, OutputIterator2 outBegin2)
     {
-        std::vector<typename ComplexInputIterator::value_type::value_type> fin(std::distance(inBegin, inEnd) * 2);
-        
-        for (auto it = fin.begin(); it != fin.end(); ++it)
+        for (; inBegin != inEnd; ++inBegin, ++outBegin1, ++outBegin2)
         {
-            *it = inBegin->real();
-            *(++it) = inBegin->imag();
-            
-            ++inBegin;
+            *outBegin1 = inBegin->real();
+            *outBegin2 = inBegin->imag();
         }
-        
-        math::deinterleave(fin.begin(), fin.end(), outBegin1, outBegin2);
     }
     
     template <class ComplexIterator>
     void FastFourierTransformBase::forward(const float* input, ComplexIterator output)
     {
-        static_assert(std::is_same<typename ComplexIterator::value_type, std::complex<float>>::value, "should be an iterator to std::complex<float>");
+        static_assert(std::is_same<typename std::iterator_traits<ComplexIterator>::value_type, std::complex<float>>::value, "should be an iterator to std::complex<float>");
         
         // The deinterleaved output will be stored in here
-        std::vector<float> real(size / 2 + 1, 0);
-        std::vector<float> imaginary(size / 2 + 1, 0);
+        auto& scratch = getScratch<float>();
         
         // Do the forward transform
-        forward(input, real.data(), imaginary.data());
+        forward(input, scratch.outReal.data(), scratch.outImaginary.data());
         
-        interleave(real.begin(), real.end(), imaginary.begin(), output);
+        interleave(scratch.outReal.begin(), scratch.outReal.begin() + (size / 2 + 1), scratch.outImaginary.begin(), output);
     }
     
     template <class ComplexIterator>
     void FastFourierTransformBase::forward(const double* input, ComplexIterator output)
     {
-        static_assert(std::is_same<typename ComplexIterator::value_type, std::complex<double>>::value, "should be an iterator to std::complex<double>");
+        static_assert(std::is_same<typename std::iterator_traits<ComplexIterator>::value_type, std::complex<double>>::value, "should be an iterator to std::complex<double>");
         
         // The deinterleaved output will be stored in here
-        std::vector<double> real(size / 2 + 1, 0);
-        std::vector<double> imaginary(size / 2 + 1, 0);
+        auto& scratch = getScratch<double>();
         
         // Do the forward transform
-        forward(input, real.data(), imaginary.data());
+        forward(input, scratch.outReal.data(), scratch.outImaginary.data());
         
-        interleave(real.begin(), real.end(), imaginary.begin(), output);
+        interleave(scratch.outReal.begin(), scratch.outReal.begin() + (size / 2 + 1), scratch.outImaginary.begin(), output);
     }
     
     template <class ComplexIterator>
@@ -247,33 +342,31 @@ namespace dsp
     template <class ComplexIterator>
     void FastFourierTransformBase::inverse(ComplexIterator input, float* output)
     {
-        static_assert(std::is_same<typename ComplexIterator::value_type, std::complex<float>>::value, "should be an iterator to std::complex<float>");
+        static_assert(std::is_same<typename std::iterator_traits<ComplexIterator>::value_type, std::complex<float>>::value, "should be an iterator to std::complex<float>");
         
         // The deinterleaved input is stored in here
-        std::vector<float> real(size / 2 + 1);
-        std::vector<float> imaginary(size / 2 + 1);
+        auto& scratch = getScratch<float>();
         
         // Deinterleave
-        deinterleave(input, input + size, real.begin(), imaginary.begin());
+        deinterleave(input, input + (size / 2 + 1), scratch.inReal.begin(), scratch.inImaginary.begin());
         
         // Do the inverse transform
-        inverse(real.data(), imaginary.data(), output);
+        inverse(scratch.inReal.data(), scratch.inImaginary.data(), output);
     }
     
     template <class ComplexIterator>
     void FastFourierTransformBase::inverse(ComplexIterator input, double* output)
     {
-        static_assert(std::is_same<typename ComplexIterator::value_type, std::complex<double>>::value, "should be an iterator to std::complex<double>");
+        static_assert(std::is_same<typename std::iterator_traits<ComplexIterator>::value_type, std::complex<double>>::value, "should be an iterator to std::complex<double>");
         
         // The deinterleaved input is stored in here
-        std::vector<double> real(size / 2 + 1);
-        std::vector<double> imaginary(size / 2 + 1);
+        auto& scratch = getScratch<double>();
         
         // Deinterleave
-        deinterleave(input, input + size, real.begin(), imaginary.begin());
+        deinterleave(input, input + (size / 2 + 1), scratch.inReal.begin(), scratch.inImaginary.begin());
         
         // Do the inverse transform
-        inverse(real.data(), imaginary.data(), output);
+        inverse(scratch.inReal.data(), scratch.inImaginary.data(), output);
     }
     
     template <class ComplexIterator>
@@ -287,20 +380,18 @@ namespace dsp
     template <class ComplexInputIterator, class ComplexOutputIterator>
     void FastFourierTransformBase::forwardComplex(ComplexInputIterator input, ComplexOutputIterator output)
     {
-        // The deinterleaved input is stored in here
-        std::vector<typename ComplexInputIterator::value_type::value_type> inputReal(size);
-        std::vector<typename ComplexInputIterator::value_type::value_type> inputImaginary(size);
+        static_assert(std::is_same<typename std::iterator_traits<ComplexInputIterator>::value_type, typename std::iterator_traits<ComplexOutputIterator>::value_type>::value, "input and output should have the same precision");
         
-        // Deinterleave
-        deinterleave(input, input + size, inputReal.begin(), inputImaginary.begin());
+        // The deinterleaved input and output are stored in here
+        auto& scratch = getScratch<typename std::iterator_traits<ComplexInputIterator>::value_type::value_type>();
         
-        std::vector<typename ComplexOutputIterator::value_type::value_type> outputReal(size);
-        std::vector<typename ComplexOutputIterator::value_type::value_type> outputImaginary(size);
+        // Deinterleave
+        deinterleave(input, input + size, scratch.inReal.begin(), scratch.inImaginary.begin());
         
-        // Do the inverse transform
-        forwardComplex(inputReal.data(), inputImaginary.data(), outputReal.data(), outputImaginary.data());
+        // Do the forward transform
+        forwardComplex(scratch.inReal.data(), scratch.inImaginary.data(), scratch.outReal.data(), scratch.outImaginary.data());
         
-        interleave(outputReal.begin(), outputReal.end(), outputImaginary.begin(), output);
+        interleave(scratch.outReal.begin(), scratch.outReal.end(), scratch.outImaginary.begin(), output);
     }
     
     template <class ComplexIterator>
@@ -316,20 +407,18 @@ namespace dsp
     template <class ComplexInputIterator, class ComplexOutputIterator>
     void FastFourierTransformBase::inverseComplex(ComplexInputIterator input, ComplexOutputIterator output)
     {
-        // The deinterleaved input is stored in here
-        std::vector<typename ComplexInputIterator::value_type::value_type> inputReal(size);
-        std::vector<typename ComplexInputIterator::value_type::value_type> inputImaginary(size);
+        static_assert(std::is_same<typename std::iterator_traits<ComplexInputIterator>::value_type, typename std::iterator_traits<ComplexOutputIterator>::value_type>::value, "input and output should have the same precision");
         
-        // Deinterleave
-        deinterleave(input, input + size, inputReal.begin(), inputImaginary.begin());
+        // The deinterleaved input and output are stored in here
+        auto& scratch = getScratch<typename std::iterator_traits<ComplexInputIterator>::value_type::value_type>();
         
-        std::vector<typename ComplexOutputIterator::value_type::value_type> outputReal(size);
-        std::vector<typename ComplexOutputIterator::value_type::value_type> outputImaginary(size);
+        // Deinterleave
+        deinterleave(input, input + size, scratch.inReal.begin(), scratch.inImaginary.begin());
         
         // Do the inverse transform
-        inverseComplex(inputReal.data(), inputImaginary.data(), outputReal.data(), outputImaginary.data());
+        inverseComplex(scratch.inReal.data(), scratch.inImaginary.data(), scratch.outReal.data(), scratch.outImaginary.data());
         
-        interleave(outputReal.begin(), outputReal.end(), outputImaginary.begin(), output);
+        interleave(scratch.outReal.begin(), scratch.outReal.end(), scratch.outImaginary.begin(), output);
     }
 }
 
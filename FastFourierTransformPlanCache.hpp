@@ -0,0 +1,91 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_FAST_FOURIER_TRANSFORM_PLAN_CACHE_HPP
+#define GRIZZLY_FAST_FOURIER_TRANSFORM_PLAN_CACHE_HPP
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace dsp
+{
+    //! Process-wide cache of the tables a Fourier transform backend needs for a given size
+    /*! Each backend keeps its twiddle and bit-reversal tables in its own Plan type, which needs a constructor that
+        takes the size. Plans are built once, on first request, and are immutable afterwards, so they can be shared
+        by any number of transforms on any number of threads. Only the work buffers remain per transform. */
+    template <typename Plan>
+    class FastFourierTransformPlanCache
+    {
+    public:
+        //! Return the plan for a given size, building it if it isn't cached yet
+        /*! This function is thread-safe */
+        static std::shared_ptr<const Plan> get(std::size_t size)
+        {
+            std::lock_guard<std::mutex> lock(getMutex());
+            
+            auto& plan = getPlans()[size];
+            if (!plan)
+                plan = std::make_shared<const Plan>(size);
+            
+            return plan;
+        }
+        
+        //! Return the number of cached plans
+        static std::size_t getCount()
+        {
+            std::lock_guard<std::mutex> lock(getMutex());
+            return getPlans().size();
+        }
+        
+        //! Release all cached plans
+        /*! Transforms that still use a plan keep it alive until they're destructed */
+        static void clear()
+        {
+            std::lock_guard<std::mutex> lock(getMutex());
+            getPlans().clear();
+        }
+        
+    private:
+        //! The mutex guarding the plans
+        static std::mutex& getMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+        
+        //! The cached plans, by size
+        static std::map<std::size_t, std::shared_ptr<const Plan>>& getPlans()
+        {
+            static std::map<std::size_t, std::shared_ptr<const Plan>> plans;
+            return plans;
+        }
+    };
+}
+
+#endif /* GRIZZLY_FAST_FOURIER_TRANSFORM_PLAN_CACHE_HPP */
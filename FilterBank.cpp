@@ -0,0 +1,44 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#include "FilterBank.hpp"
+#include "Simd/SpectrumKernels.hpp"
+
+using namespace std;
+
+namespace dsp
+{
+    void multiplyBanded(const float* weights, const size_t* offsets, const size_t* firstColumns, size_t rowCount, const float* input, float* output)
+    {
+        simd::getBestSpectrumKernels(float()).bandedProduct(rowCount, offsets, firstColumns, weights, input, output);
+    }
+    
+    void multiplyBanded(const double* weights, const size_t* offsets, const size_t* firstColumns, size_t rowCount, const double* input, double* output)
+    {
+        simd::getBestSpectrumKernels(double()).bandedProduct(rowCount, offsets, firstColumns, weights, input, output);
+    }
+}
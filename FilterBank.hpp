@@ -0,0 +1,167 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_FILTER_BANK_HPP
+#define GRIZZLY_FILTER_BANK_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace dsp
+{
+    //! The perceptual frequency scales a filter bank can space its filters on
+    enum class FrequencyScale { MEL, BARK };
+    
+    //! Convert a frequency in Hertz to mel (O'Shaughnessy, as used by HTK)
+    template <typename T>
+    T hertzToMel(T frequency) { return 2595 * std::log10(1 + frequency / 700); }
+    
+    //! Convert a frequency in mel to Hertz
+    template <typename T>
+    T melToHertz(T mel) { return 700 * (std::pow(T(10), mel / 2595) - 1); }
+    
+    //! Convert a frequency in Hertz to bark (Traunmüller)
+    template <typename T>
+    T hertzToBark(T frequency) { return 26.81 * frequency / (1960 + frequency) - 0.53; }
+    
+    //! Convert a frequency in bark to Hertz
+    template <typename T>
+    T barkToHertz(T bark) { return 1960 * (bark + 0.53) / (26.28 - bark); }
+    
+    //! Multiply a vector with a banded sparse matrix, in which every row has one contiguous range of non-zero weights
+    /*! Row r holds the weights [offsets[r], offsets[r + 1]) of the weights array, which multiply the input from
+        firstColumns[r] on. The products run as a vectorized kernel for the best instruction set of the CPU. */
+    void multiplyBanded(const float* weights, const std::size_t* offsets, const std::size_t* firstColumns, std::size_t rowCount, const float* input, float* output);
+    void multiplyBanded(const double* weights, const std::size_t* offsets, const std::size_t* firstColumns, std::size_t rowCount, const double* input, double* output);
+    
+    //! Triangular filters spaced evenly on a perceptual frequency scale, applied to the bins of a spectrum
+    /*! Each filter rises from the centre of the one below it to its own centre, and falls to the centre of the one
+        above, with a peak of one. Only the bins a filter covers are stored, as one contiguous range per filter, so
+        applying the bank costs a pass over the covered bins instead of a dense filters x bins product. Filters too
+        narrow to cover a single bin stay silent. */
+    template <class T>
+    class FilterBank
+    {
+    public:
+        //! Construct the filter bank
+        /*! @param frameSize: The number of samples of the frames the spectra are taken of, with frameSize / 2 + 1 bins
+            @param sampleRate: The sample rate of the frames
+            @param filterCount: The number of filters
+            @param lowestFrequency: The lower edge of the first filter
+            @param highestFrequency: The upper edge of the last filter, at most the Nyquist frequency */
+        FilterBank(std::size_t frameSize, T sampleRate, std::size_t filterCount, T lowestFrequency, T highestFrequency, FrequencyScale scale = FrequencyScale::MEL) :
+            binCount(frameSize / 2 + 1),
+            offsets(filterCount + 1),
+            firstBins(filterCount)
+        {
+            if (frameSize < 2 || filterCount == 0)
+                throw std::invalid_argument("FilterBank needs a frame size of at least 2 and at least one filter");
+            
+            if (lowestFrequency < 0 || lowestFrequency >= highestFrequency || highestFrequency > sampleRate / 2)
+                throw std::invalid_argument("FilterBank frequencies should be ascending and within [0, Nyquist]");
+            
+            const auto toScale = [&](T frequency){ return (scale == FrequencyScale::MEL) ? hertzToMel(frequency) : hertzToBark(frequency); };
+            const auto fromScale = [&](T value){ return (scale == FrequencyScale::MEL) ? melToHertz(value) : barkToHertz(value); };
+            
+            // The edges and centres of the filters, evenly spaced on the scale
+            std::vector<T> points(filterCount + 2);
+            const T low = toScale(lowestFrequency);
+            const T high = toScale(highestFrequency);
+            for (std::size_t i = 0; i < points.size(); ++i)
+                points[i] = fromScale(low + (high - low) * i / (filterCount + 1));
+            
+            const T binWidth = sampleRate / frameSize;
+            for (std::size_t filter = 0; filter < filterCount; ++filter)
+            {
+                const T lower = points[filter];
+                const T centre = points[filter + 1];
+                const T upper = points[filter + 2];
+                
+                // The bins strictly between the edges, where the weights are non-zero
+                const auto first = std::min<std::size_t>(static_cast<std::size_t>(std::floor(lower / binWidth)) + 1, binCount);
+                const auto last = std::min<std::size_t>(static_cast<std::size_t>(std::ceil(upper / binWidth)), binCount);
+                
+                firstBins[filter] = first;
+                for (auto bin = first; bin < last; ++bin)
+                {
+                    const T frequency = bin * binWidth;
+                    weights.emplace_back(std::max<T>(0, (frequency <= centre) ? (frequency - lower) / (centre - lower) : (upper - frequency) / (upper - centre)));
+                }
+                
+                offsets[filter + 1] = weights.size();
+            }
+        }
+        
+        //! Apply the filters to a spectrum
+        /*! @param spectrum: The frameSize / 2 + 1 bins the filters weigh, usually square magnitudes
+            @param output: Receives one value per filter */
+        void apply(const T* spectrum, T* output) const
+        {
+            multiplyBanded(weights.data(), offsets.data(), firstBins.data(), getFilterCount(), spectrum, output);
+        }
+        
+        //! Return the weight of a filter for a bin, which is zero outside of its range
+        T getWeight(std::size_t filter, std::size_t bin) const
+        {
+            const auto first = firstBins[filter];
+            return (bin >= first && bin - first < offsets[filter + 1] - offsets[filter]) ? weights[offsets[filter] + bin - first] : 0;
+        }
+        
+        //! Return the first bin a filter covers
+        std::size_t getFirstBin(std::size_t filter) const { return firstBins[filter]; }
+        
+        //! Return the number of bins a filter covers
+        std::size_t getBinCount(std::size_t filter) const { return offsets[filter + 1] - offsets[filter]; }
+        
+        //! Return the number of filters
+        std::size_t getFilterCount() const { return firstBins.size(); }
+        
+        //! Return the number of bins in the spectra the filters are applied to
+        std::size_t getBinCount() const { return binCount; }
+        
+        //! Return the number of weights stored, out of filters x bins
+        std::size_t getWeightCount() const { return weights.size(); }
+        
+    private:
+        //! The number of bins in the spectra the filters are applied to
+        std::size_t binCount = 0;
+        
+        //! The non-zero weights of all filters, one after the other
+        std::vector<T> weights;
+        
+        //! Where the weights of each filter start in weights, followed by the total number of weights
+        std::vector<std::size_t> offsets;
+        
+        //! The first bin each filter covers
+        std::vector<std::size_t> firstBins;
+    };
+}
+
+#endif /* GRIZZLY_FILTER_BANK_HPP */
@@ -49,12 +49,12 @@ namespace dsp
     {
         // Take the forward Fourier
         const auto size = std::distance(begin, end);
-        FastFourierTransform fft(size);
-        auto spectrum = fft.forwardComplex(begin);
+        auto fft = createFastFourierTransform(size);
+        auto spectrum = fft->forwardComplex(begin);
         
         // Multiply the first half with -j1 (or j1 for inverse)
         const auto halfSize = spectrum.size() / 2;
-        for (auto i = 0; i < halfSize; ++i)
+        for (std::size_t i = 0; i < halfSize; ++i)
             spectrum[i] *= std::complex<float>(0, (direction == HilbertTransformDirection::INVERSE) ? 1 : -1);
         
         // Multiply the second half with j1 (or -j1 for inverse)
@@ -62,7 +62,7 @@ namespace dsp
             spectrum[i] *= std::complex<float>(0, (direction == HilbertTransformDirection::INVERSE) ? -1 : 1);
         
         // Return the inverse fourier
-        fft.inverseComplex(spectrum.begin(), outBegin);
+        fft->inverseComplex(spectrum.begin(), outBegin);
     }
     
     //! The Hilbert transform of a real signal
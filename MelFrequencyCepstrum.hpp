@@ -0,0 +1,185 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_MEL_FREQUENCY_CEPSTRUM_HPP
+#define GRIZZLY_MEL_FREQUENCY_CEPSTRUM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <dsperados/math/constants.hpp>
+
+#include "DiscreteCosineTransform.hpp"
+#include "FilterBank.hpp"
+#include "SplitSpectrum.hpp"
+#include "Spectrogram.hpp"
+
+namespace dsp
+{
+    //! Mel-frequency cepstral coefficients (MFCCs) of spectra
+    /*! The square magnitudes of a spectrum are weighed by a mel filter bank, their natural logarithms are taken and
+        decorrelated by an orthonormal DCT-II, of which the first coefficients are kept. For filter counts that are a
+        power of two, the DCT is the fast DiscreteCosineTransform, for others only the kept rows of the DCT matrix are
+        multiplied with. Computing the coefficients of a single spectrum allocates nothing. */
+    template <class T>
+    class MelFrequencyCepstrum
+    {
+    public:
+        //! Construct the cepstrum
+        /*! @param frameSize: The number of samples of the frames the spectra are taken of, with frameSize / 2 + 1 bins
+            @param sampleRate: The sample rate of the frames
+            @param filterCount: The number of mel filters
+            @param coefficientCount: The number of coefficients kept, at most the number of filters
+            @param lowestFrequency: The lower edge of the first filter
+            @param highestFrequency: The upper edge of the last filter, or zero for the Nyquist frequency */
+        MelFrequencyCepstrum(std::size_t frameSize, T sampleRate, std::size_t filterCount = 40, std::size_t coefficientCount = 13, T lowestFrequency = 0, T highestFrequency = 0) :
+            filterBank(frameSize, sampleRate, filterCount, lowestFrequency, (highestFrequency > 0) ? highestFrequency : sampleRate / 2),
+            coefficientCount(coefficientCount),
+            powers(frameSize / 2 + 1),
+            energies(filterCount)
+        {
+            if (coefficientCount == 0 || coefficientCount > filterCount)
+                throw std::invalid_argument("MelFrequencyCepstrum coefficient count should be between 1 and the filter count");
+            
+            if (filterCount >= 2 && (filterCount & (filterCount - 1)) == 0)
+            {
+                cosineTransform = std::make_unique<DiscreteCosineTransform>(filterCount);
+            } else {
+                cosines.resize(coefficientCount * filterCount);
+                for (std::size_t k = 0; k < coefficientCount; ++k)
+                    for (std::size_t n = 0; n < filterCount; ++n)
+                        cosines[k * filterCount + n] = getScale(k) * std::cos(math::PI<T> * (n + T(0.5)) * k / filterCount);
+            }
+        }
+        
+        //! Compute the coefficients of a spectrum given as square magnitudes
+        /*! @param powers: The square magnitudes of the frameSize / 2 + 1 bins
+            @param coefficients: Receives the coefficients */
+        void compute(const T* powers, T* coefficients)
+        {
+            filterBank.apply(powers, energies.data());
+            for (auto& energy : energies)
+                energy = std::log(std::max(energy, floor));
+            
+            const auto filterCount = energies.size();
+            if (cosineTransform)
+            {
+                cosineTransform->forward(energies.data(), energies.data());
+                for (std::size_t k = 0; k < coefficientCount; ++k)
+                    coefficients[k] = getScale(k) * energies[k];
+            } else {
+                for (std::size_t k = 0; k < coefficientCount; ++k)
+                {
+                    T sum = 0;
+                    for (std::size_t n = 0; n < filterCount; ++n)
+                        sum += cosines[k * filterCount + n] * energies[n];
+                    
+                    coefficients[k] = sum;
+                }
+            }
+        }
+        
+        //! Compute the coefficients of a spectrum in split form
+        void compute(const T* real, const T* imaginary, T* coefficients)
+        {
+            computePowers(real, imaginary, powers.data(), powers.size());
+            compute(powers.data(), coefficients);
+        }
+        
+        //! Compute the coefficients of every frame of a spectrogram
+        /*! @param output: A coefficient count x frame count matrix, of which coefficient c of frame i ends up at
+                           output[c * frameCount + i] */
+        void compute(const Spectrogram<T>& spectrogram, T* output)
+        {
+            if (spectrogram.getBinCount() != powers.size())
+                throw std::invalid_argument("MelFrequencyCepstrum spectrogram should have frameSize / 2 + 1 bins");
+            
+            const auto frameCount = spectrogram.getFrameCount();
+            std::vector<T> coefficients(coefficientCount);
+            std::vector<std::complex<T>> gathered;
+            
+            for (std::size_t frame = 0; frame < frameCount; ++frame)
+            {
+                // Bin-major frames are strided, and are gathered first
+                const auto span = spectrogram.getFrame(frame);
+                const std::complex<T>* bins = span.data();
+                if (!span.isContiguous())
+                {
+                    gathered.assign(span.begin(), span.end());
+                    bins = gathered.data();
+                }
+                
+                computePowers(bins, powers.data(), powers.size());
+                compute(powers.data(), coefficients.data());
+                for (std::size_t k = 0; k < coefficientCount; ++k)
+                    output[k * frameCount + frame] = coefficients[k];
+            }
+        }
+        
+        //! Change the smallest filter energy taken the logarithm of, 1e-10 by default
+        void setFloor(T floor) { this->floor = floor; }
+        
+        //! Return the filter bank
+        const FilterBank<T>& getFilterBank() const { return filterBank; }
+        
+        //! Return the number of coefficients computed per spectrum
+        std::size_t getCoefficientCount() const { return coefficientCount; }
+        
+    private:
+        //! Return the factor that makes DCT-II coefficient k orthonormal
+        T getScale(std::size_t k) const { return std::sqrt(T((k == 0) ? 1 : 2) / energies.size()); }
+        
+    private:
+        //! The mel filter bank
+        FilterBank<T> filterBank;
+        
+        //! The number of coefficients kept
+        std::size_t coefficientCount = 0;
+        
+        //! The transform for power of two filter counts
+        std::unique_ptr<DiscreteCosineTransform> cosineTransform;
+        
+        //! The kept rows of the orthonormal DCT-II matrix, for other filter counts
+        std::vector<T> cosines;
+        
+        //! The square magnitudes of the spectrum being computed
+        std::vector<T> powers;
+        
+        //! The (logarithmic) energy of every filter
+        std::vector<T> energies;
+        
+        //! The smallest energy taken the logarithm of
+        T floor = 1e-10;
+    };
+}
+
+#endif /* GRIZZLY_MEL_FREQUENCY_CEPSTRUM_HPP */
@@ -0,0 +1,601 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "../FastFourierTransformPlanCache.hpp"
+#include "FastFourierTransformMixedRadix.hpp"
+
+using namespace std;
+
+namespace dsp
+{
+    //! A radix-2 Stockham stage
+    /*! @param m: The current sub-transform size divided by the radix
+        @param run: The number of contiguous elements that share the same twiddle */
+    template <typename T>
+    static void radix2(size_t m, size_t run, const T* wr, const T* wi, const T* xr, const T* xi, T* yr, T* yi)
+    {
+        for (size_t p = 0; p < m; ++p)
+        {
+            for (size_t q = 0; q < run; ++q)
+            {
+                const T ar = xr[q + run * p], ai = xi[q + run * p];
+                const T br = xr[q + run * (p + m)], bi = xi[q + run * (p + m)];
+                const T dr = ar - br, di = ai - bi;
+                
+                yr[q + run * p * 2] = ar + br;
+                yi[q + run * p * 2] = ai + bi;
+                yr[q + run * (p * 2 + 1)] = dr * wr[p] - di * wi[p];
+                yi[q + run * (p * 2 + 1)] = dr * wi[p] + di * wr[p];
+            }
+        }
+    }
+    
+    //! A radix-4 Stockham stage
+    template <typename T>
+    static void radix4(size_t m, size_t run, const T* wr, const T* wi, const T* xr, const T* xi, T* yr, T* yi)
+    {
+        for (size_t p = 0; p < m; ++p)
+        {
+            const T w1r = wr[p],         w1i = wi[p];
+            const T w2r = wr[p + m],     w2i = wi[p + m];
+            const T w3r = wr[p + m * 2], w3i = wi[p + m * 2];
+            
+            for (size_t q = 0; q < run; ++q)
+            {
+                const T ar = xr[q + run * p],           ai = xi[q + run * p];
+                const T br = xr[q + run * (p + m)],     bi = xi[q + run * (p + m)];
+                const T cr = xr[q + run * (p + m * 2)], ci = xi[q + run * (p + m * 2)];
+                const T dr = xr[q + run * (p + m * 3)], di = xi[q + run * (p + m * 3)];
+                
+                const T apcr = ar + cr, apci = ai + ci;
+                const T amcr = ar - cr, amci = ai - ci;
+                const T bpdr = br + dr, bpdi = bi + di;
+                const T bmdr = br - dr, bmdi = bi - di;
+                
+                // (a - c) - i(b - d) and (a - c) + i(b - d)
+                const T x1r = amcr + bmdi, x1i = amci - bmdr;
+                const T x3r = amcr - bmdi, x3i = amci + bmdr;
+                const T x2r = apcr - bpdr, x2i = apci - bpdi;
+                
+                T* y = yr + q + run * p * 4;
+                T* z = yi + q + run * p * 4;
+                y[0] = apcr + bpdr;
+                z[0] = apci + bpdi;
+                y[run] = x1r * w1r - x1i * w1i;
+                z[run] = x1r * w1i + x1i * w1r;
+                y[run * 2] = x2r * w2r - x2i * w2i;
+                z[run * 2] = x2r * w2i + x2i * w2r;
+                y[run * 3] = x3r * w3r - x3i * w3i;
+                z[run * 3] = x3r * w3i + x3i * w3r;
+            }
+        }
+    }
+    
+    //! A Stockham stage for an odd prime radix (3, 5 or 7)
+    /*! The inputs j and radix - j are combined into a sum and a difference first, which halves the number of
+        multiplications compared to a plain DFT.
+        @param rc, rs: The cos and sin of 2 * pi * j * k / radix, for 0 < j, k <= (radix - 1) / 2 (row-major in j) */
+    template <size_t Radix, typename T>
+    static void oddRadix(size_t m, size_t run, const T* wr, const T* wi, const T* rc, const T* rs, const T* xr, const T* xi, T* yr, T* yi)
+    {
+        constexpr size_t half = (Radix - 1) / 2;
+        
+        // cos and sin of 2 * pi * j * k / radix, taken out of the plan into locals the compiler can keep in registers
+        T cosines[half + 1][half + 1];
+        T sines[half + 1][half + 1];
+        for (size_t j = 1; j <= half; ++j)
+        {
+            for (size_t k = 1; k <= half; ++k)
+            {
+                cosines[j][k] = rc[(j - 1) * half + k - 1];
+                sines[j][k] = rs[(j - 1) * half + k - 1];
+            }
+        }
+        
+        for (size_t p = 0; p < m; ++p)
+        {
+            for (size_t q = 0; q < run; ++q)
+            {
+                const T x0r = xr[q + run * p], x0i = xi[q + run * p];
+                
+                T sumReal[half + 1], sumImaginary[half + 1];
+                T differenceReal[half + 1], differenceImaginary[half + 1];
+                T dcReal = x0r, dcImaginary = x0i;
+                for (size_t j = 1; j <= half; ++j)
+                {
+                    const T ar = xr[q + run * (p + m * j)], ai = xi[q + run * (p + m * j)];
+                    const T br = xr[q + run * (p + m * (Radix - j))], bi = xi[q + run * (p + m * (Radix - j))];
+                    
+                    sumReal[j] = ar + br;
+                    sumImaginary[j] = ai + bi;
+                    differenceReal[j] = ar - br;
+                    differenceImaginary[j] = ai - bi;
+                    dcReal += sumReal[j];
+                    dcImaginary += sumImaginary[j];
+                }
+                
+                T* y = yr + q + run * p * Radix;
+                T* z = yi + q + run * p * Radix;
+                y[0] = dcReal;
+                z[0] = dcImaginary;
+                
+                for (size_t k = 1; k <= half; ++k)
+                {
+                    // Output k is a - ib, output radix - k is a + ib
+                    T ar = x0r, ai = x0i, br = 0, bi = 0;
+                    for (size_t j = 1; j <= half; ++j)
+                    {
+                        ar += sumReal[j] * cosines[j][k];
+                        ai += sumImaginary[j] * cosines[j][k];
+                        br += differenceReal[j] * sines[j][k];
+                        bi += differenceImaginary[j] * sines[j][k];
+                    }
+                    
+                    const T lowReal = ar + bi, lowImaginary = ai - br;
+                    const T highReal = ar - bi, highImaginary = ai + br;
+                    
+                    const auto low = (k - 1) * m + p;
+                    const auto high = (Radix - k - 1) * m + p;
+                    y[run * k] = lowReal * wr[low] - lowImaginary * wi[low];
+                    z[run * k] = lowReal * wi[low] + lowImaginary * wr[low];
+                    y[run * (Radix - k)] = highReal * wr[high] - highImaginary * wi[high];
+                    z[run * (Radix - k)] = highReal * wi[high] + highImaginary * wr[high];
+                }
+            }
+        }
+    }
+    
+    template <typename T>
+    FastFourierTransformMixedRadix::Plan<T>::Plan(size_t size) :
+        size(size)
+    {
+        // Prefer radix 4, it needs the fewest operations per element
+        for (auto length = size; length > 1;)
+        {
+            size_t radix = 0;
+            for (auto candidate : {4, 2, 3, 5, 7})
+            {
+                if (length % candidate == 0)
+                {
+                    radix = candidate;
+                    break;
+                }
+            }
+            
+            if (radix == 0)
+                throw invalid_argument("FastFourierTransformMixedRadix plan size should factor into 2, 3, 5 and 7");
+            
+            const auto m = length / radix;
+            for (size_t k = 1; k < radix; ++k)
+            {
+                for (size_t p = 0; p < m; ++p)
+                {
+                    const auto angle = -2 * acos(-1.l) * ((k * p) % length) / length;
+                    twiddlesReal.emplace_back(static_cast<T>(cos(angle)));
+                    twiddlesImaginary.emplace_back(static_cast<T>(sin(angle)));
+                }
+            }
+            
+            if (radix % 2 == 1)
+            {
+                const auto half = (radix - 1) / 2;
+                for (size_t j = 1; j <= half; ++j)
+                {
+                    for (size_t k = 1; k <= half; ++k)
+                    {
+                        const auto angle = 2 * acos(-1.l) * ((j * k) % radix) / radix;
+                        rotationsCosine.emplace_back(static_cast<T>(cos(angle)));
+                        rotationsSine.emplace_back(static_cast<T>(sin(angle)));
+                    }
+                }
+            }
+            
+            radices.emplace_back(radix);
+            length = m;
+        }
+    }
+    
+    template <typename T>
+    void FastFourierTransformMixedRadix::Plan<T>::forward(const T* inReal, const T* inImaginary, T* outReal, T* outImaginary, T* workReal, T* workImaginary) const
+    {
+        if (radices.empty())
+        {
+            copy(inReal, inReal + size, outReal);
+            copy(inImaginary, inImaginary + size, outImaginary);
+            return;
+        }
+        
+        const T* sourceReal = inReal;
+        const T* sourceImaginary = inImaginary;
+        const T* wr = twiddlesReal.data();
+        const T* wi = twiddlesImaginary.data();
+        const T* rc = rotationsCosine.data();
+        const T* rs = rotationsSine.data();
+        size_t length = size;
+        size_t run = 1;
+        
+        for (size_t stage = 0; stage < radices.size(); ++stage)
+        {
+            // Alternate between the output and the work buffer, so that the last stage ends up in the output
+            const bool toOutput = (radices.size() - stage) % 2 == 1;
+            T* destinationReal = toOutput ? outReal : workReal;
+            T* destinationImaginary = toOutput ? outImaginary : workImaginary;
+            
+            const auto radix = radices[stage];
+            const auto m = length / radix;
+            switch (radix)
+            {
+                case 2: radix2(m, run, wr, wi, sourceReal, sourceImaginary, destinationReal, destinationImaginary); break;
+                case 3: oddRadix<3>(m, run, wr, wi, rc, rs, sourceReal, sourceImaginary, destinationReal, destinationImaginary); break;
+                case 4: radix4(m, run, wr, wi, sourceReal, sourceImaginary, destinationReal, destinationImaginary); break;
+                case 5: oddRadix<5>(m, run, wr, wi, rc, rs, sourceReal, sourceImaginary, destinationReal, destinationImaginary); break;
+                case 7: oddRadix<7>(m, run, wr, wi, rc, rs, sourceReal, sourceImaginary, destinationReal, destinationImaginary); break;
+            }
+            
+            wr += (radix - 1) * m;
+            wi += (radix - 1) * m;
+            if (radix % 2 == 1)
+            {
+                const auto half = (radix - 1) / 2;
+                rc += half * half;
+                rs += half * half;
+            }
+            
+            length = m;
+            run *= radix;
+            sourceReal = destinationReal;
+            sourceImaginary = destinationImaginary;
+        }
+    }
+    
+    //! The smallest power of two Bluestein's convolution of a size fits in without wrapping around
+    static size_t getBluesteinSize(size_t size)
+    {
+        size_t convolutionSize = 1;
+        while (convolutionSize < size * 2 - 1)
+            convolutionSize *= 2;
+        
+        return convolutionSize;
+    }
+    
+    template <typename T>
+    FastFourierTransformMixedRadix::Tables<T>::Tables(size_t size) :
+        complexPlan(isFactorizable(size) ? size : getBluesteinSize(size)),
+        halfPlan((isFactorizable(size) && size % 2 == 0) ? size / 2 : 0)
+    {
+        if (halfPlan.size > 0)
+        {
+            realTwiddlesReal.resize(size / 2);
+            realTwiddlesImaginary.resize(size / 2);
+            for (size_t k = 0; k < size / 2; ++k)
+            {
+                const auto angle = -2 * acos(-1.l) * k / size;
+                realTwiddlesReal[k] = static_cast<T>(cos(angle));
+                realTwiddlesImaginary[k] = static_cast<T>(sin(angle));
+            }
+        }
+        
+        if (isFactorizable(size))
+            return;
+        
+        // The chirp, with n^2 taken modulo 2 * size to keep the angles accurate for large n
+        chirpReal.resize(size);
+        chirpImaginary.resize(size);
+        for (unsigned long long n = 0; n < size; ++n)
+        {
+            const auto angle = -acos(-1.l) * ((n * n) % (size * 2)) / size;
+            chirpReal[n] = static_cast<T>(cos(angle));
+            chirpImaginary[n] = static_cast<T>(sin(angle));
+        }
+        
+        // The filter is the conjugated chirp, wrapped around for the negative indices
+        const auto convolutionSize = complexPlan.size;
+        vector<T> real(convolutionSize, 0);
+        vector<T> imaginary(convolutionSize, 0);
+        for (size_t n = 0; n < size; ++n)
+        {
+            real[n] = chirpReal[n];
+            imaginary[n] = -chirpImaginary[n];
+            
+            if (n > 0)
+            {
+                real[convolutionSize - n] = chirpReal[n];
+                imaginary[convolutionSize - n] = -chirpImaginary[n];
+            }
+        }
+        
+        filterReal.resize(convolutionSize);
+        filterImaginary.resize(convolutionSize);
+        vector<T> workReal(convolutionSize);
+        vector<T> workImaginary(convolutionSize);
+        complexPlan.forward(real.data(), imaginary.data(), filterReal.data(), filterImaginary.data(), workReal.data(), workImaginary.data());
+    }
+    
+    template <typename T>
+    FastFourierTransformMixedRadix::Workspace<T>::Workspace(size_t size) :
+        tables(FastFourierTransformPlanCache<Tables<T>>::get(size)),
+        real1(tables->complexPlan.size),
+        imaginary1(tables->complexPlan.size),
+        real2(tables->complexPlan.size),
+        imaginary2(tables->complexPlan.size),
+        real3(tables->complexPlan.size),
+        imaginary3(tables->complexPlan.size)
+    {
+        
+    }
+    
+    FastFourierTransformMixedRadix::FastFourierTransformMixedRadix(size_t size) :
+        FastFourierTransformBase(size),
+        bluestein(!isFactorizable(size)),
+        floatWorkspace(size),
+        doubleWorkspace(size)
+    {
+        
+    }
+    
+    bool FastFourierTransformMixedRadix::isFactorizable(size_t size)
+    {
+        if (size == 0)
+            throw invalid_argument("FastFourierTransformMixedRadix size should be at least 1");
+        
+        for (auto factor : {2, 3, 5, 7})
+            while (size % factor == 0)
+                size /= factor;
+        
+        return size == 1;
+    }
+    
+    void FastFourierTransformMixedRadix::forward(const float* input, float* real, float* imaginary)
+    {
+        forwardReal(input, real, imaginary, floatWorkspace);
+    }
+    
+    void FastFourierTransformMixedRadix::forward(const double* input, double* real, double* imaginary)
+    {
+        forwardReal(input, real, imaginary, doubleWorkspace);
+    }
+    
+    void FastFourierTransformMixedRadix::inverse(const float* real, const float* imaginary, float* output)
+    {
+        inverseReal(real, imaginary, output, floatWorkspace);
+    }
+    
+    void FastFourierTransformMixedRadix::inverse(const double* real, const double* imaginary, double* output)
+    {
+        inverseReal(real, imaginary, output, doubleWorkspace);
+    }
+    
+    void FastFourierTransformMixedRadix::forwardComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary)
+    {
+        transformComplex(inReal, inImaginary, outReal, outImaginary, floatWorkspace);
+    }
+    
+    void FastFourierTransformMixedRadix::forwardComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary)
+    {
+        transformComplex(inReal, inImaginary, outReal, outImaginary, doubleWorkspace);
+    }
+    
+    void FastFourierTransformMixedRadix::inverseComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary)
+    {
+        // Swapping the real and imaginary parts turns the forward transform into an (unscaled) inverse one
+        transformComplex(inImaginary, inReal, outImaginary, outReal, floatWorkspace);
+        
+        const auto factor = 1.0f / size;
+        for (size_t i = 0; i < size; ++i)
+        {
+            outReal[i] *= factor;
+            outImaginary[i] *= factor;
+        }
+    }
+    
+    void FastFourierTransformMixedRadix::inverseComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary)
+    {
+        // Swapping the real and imaginary parts turns the forward transform into an (unscaled) inverse one
+        transformComplex(inImaginary, inReal, outImaginary, outReal, doubleWorkspace);
+        
+        const auto factor = 1.0 / size;
+        for (size_t i = 0; i < size; ++i)
+        {
+            outReal[i] *= factor;
+            outImaginary[i] *= factor;
+        }
+    }
+    
+    template <typename T>
+    void FastFourierTransformMixedRadix::forwardReal(const T* input, T* real, T* imaginary, Workspace<T>& workspace)
+    {
+        const auto half = size / 2;
+        
+        if (workspace.tables->halfPlan.size == 0)
+        {
+            // Odd (or unfactorizable) sizes go through a complex transform of the full size
+            copy(input, input + size, workspace.real1.begin());
+            fill(workspace.imaginary1.begin(), workspace.imaginary1.begin() + size, 0);
+            transformComplex(workspace.real1.data(), workspace.imaginary1.data(), workspace.real2.data(), workspace.imaginary2.data(), workspace);
+            
+            copy(workspace.real2.begin(), workspace.real2.begin() + half + 1, real);
+            copy(workspace.imaginary2.begin(), workspace.imaginary2.begin() + half + 1, imaginary);
+            return;
+        }
+        
+        // Treat the even samples as real, the odd ones as imaginary part of a signal of half the size
+        for (size_t n = 0; n < half; ++n)
+        {
+            workspace.real1[n] = input[n * 2];
+            workspace.imaginary1[n] = input[n * 2 + 1];
+        }
+        
+        workspace.tables->halfPlan.forward(workspace.real1.data(), workspace.imaginary1.data(), workspace.real2.data(), workspace.imaginary2.data(), workspace.real3.data(), workspace.imaginary3.data());
+        
+        const auto& zr = workspace.real2;
+        const auto& zi = workspace.imaginary2;
+        
+        // DC and Nyquist are both real
+        real[0] = zr[0] + zi[0];
+        imaginary[0] = 0;
+        real[half] = zr[0] - zi[0];
+        imaginary[half] = 0;
+        
+        // Untangle the spectra of the even and odd samples, and combine them
+        for (size_t k = 1; k < half; ++k)
+        {
+            const T ar = zr[k], ai = zi[k];
+            const T br = zr[half - k], bi = -zi[half - k];
+            
+            const T evenReal = (ar + br) * T(0.5);
+            const T evenImaginary = (ai + bi) * T(0.5);
+            const T oddReal = (ai - bi) * T(0.5);
+            const T oddImaginary = (br - ar) * T(0.5);
+            
+            const T wr = workspace.tables->realTwiddlesReal[k];
+            const T wi = workspace.tables->realTwiddlesImaginary[k];
+            real[k] = evenReal + wr * oddReal - wi * oddImaginary;
+            imaginary[k] = evenImaginary + wr * oddImaginary + wi * oddReal;
+        }
+    }
+    
+    template <typename T>
+    void FastFourierTransformMixedRadix::inverseReal(const T* real, const T* imaginary, T* output, Workspace<T>& workspace)
+    {
+        const auto half = size / 2;
+        
+        if (workspace.tables->halfPlan.size == 0)
+        {
+            // Rebuild the full, conjugate symmetric spectrum. The real and imaginary parts are swapped,
+            // so that the forward transform computes the inverse one.
+            for (size_t k = 0; k <= half; ++k)
+            {
+                workspace.real1[k] = imaginary[k];
+                workspace.imaginary1[k] = real[k];
+            }
+            
+            for (auto k = half + 1; k < size; ++k)
+            {
+                workspace.real1[k] = -imaginary[size - k];
+                workspace.imaginary1[k] = real[size - k];
+            }
+            
+            transformComplex(workspace.real1.data(), workspace.imaginary1.data(), workspace.real2.data(), workspace.imaginary2.data(), workspace);
+            
+            const T factor = T(1) / size;
+            for (size_t n = 0; n < size; ++n)
+                output[n] = workspace.imaginary2[n] * factor;
+            
+            return;
+        }
+        
+        // Tangle the spectrum back into the one of a complex signal of half the size. The real and
+        // imaginary parts are swapped, so that the forward transform computes the inverse one.
+        for (size_t k = 0; k < half; ++k)
+        {
+            const T ar = real[k], ai = imaginary[k];
+            const T br = real[half - k], bi = -imaginary[half - k];
+            
+            const T evenReal = (ar + br) * T(0.5);
+            const T evenImaginary = (ai + bi) * T(0.5);
+            const T differenceReal = (ar - br) * T(0.5);
+            const T differenceImaginary = (ai - bi) * T(0.5);
+            
+            const T wr = workspace.tables->realTwiddlesReal[k];
+            const T wi = workspace.tables->realTwiddlesImaginary[k];
+            const T oddReal = wr * differenceReal + wi * differenceImaginary;
+            const T oddImaginary = wr * differenceImaginary - wi * differenceReal;
+            
+            workspace.imaginary1[k] = evenReal - oddImaginary;
+            workspace.real1[k] = evenImaginary + oddReal;
+        }
+        
+        workspace.tables->halfPlan.forward(workspace.real1.data(), workspace.imaginary1.data(), workspace.real2.data(), workspace.imaginary2.data(), workspace.real3.data(), workspace.imaginary3.data());
+        
+        // Swap back, scale and interleave the even and odd samples
+        const T factor = T(1) / half;
+        for (size_t n = 0; n < half; ++n)
+        {
+            output[n * 2] = workspace.imaginary2[n] * factor;
+            output[n * 2 + 1] = workspace.real2[n] * factor;
+        }
+    }
+    
+    template <typename T>
+    void FastFourierTransformMixedRadix::transformComplex(const T* inReal, const T* inImaginary, T* outReal, T* outImaginary, Workspace<T>& workspace)
+    {
+        auto& plan = workspace.tables->complexPlan;
+        
+        if (!bluestein)
+        {
+            // The Stockham stages ping-pong through the output, so an in-place transform needs a copy of the input
+            if (inReal == outReal || inImaginary == outImaginary)
+            {
+                copy(inReal, inReal + size, workspace.real1.begin());
+                copy(inImaginary, inImaginary + size, workspace.imaginary1.begin());
+                inReal = workspace.real1.data();
+                inImaginary = workspace.imaginary1.data();
+            }
+            
+            plan.forward(inReal, inImaginary, outReal, outImaginary, workspace.real3.data(), workspace.imaginary3.data());
+            return;
+        }
+        
+        // Multiply with the chirp and zero-pad to the convolution size
+        for (size_t n = 0; n < size; ++n)
+        {
+            const T xr = inReal[n], xi = inImaginary[n];
+            workspace.real1[n] = xr * workspace.tables->chirpReal[n] - xi * workspace.tables->chirpImaginary[n];
+            workspace.imaginary1[n] = xr * workspace.tables->chirpImaginary[n] + xi * workspace.tables->chirpReal[n];
+        }
+        
+        fill(workspace.real1.begin() + size, workspace.real1.end(), 0);
+        fill(workspace.imaginary1.begin() + size, workspace.imaginary1.end(), 0);
+        
+        // Convolve with the conjugated chirp
+        plan.forward(workspace.real1.data(), workspace.imaginary1.data(), workspace.real2.data(), workspace.imaginary2.data(), workspace.real3.data(), workspace.imaginary3.data());
+        
+        for (size_t k = 0; k < plan.size; ++k)
+        {
+            const T ar = workspace.real2[k], ai = workspace.imaginary2[k];
+            const T br = workspace.tables->filterReal[k], bi = workspace.tables->filterImaginary[k];
+            workspace.real2[k] = ar * br - ai * bi;
+            workspace.imaginary2[k] = ar * bi + ai * br;
+        }
+        
+        // Swapping the real and imaginary parts turns the forward transform into an (unscaled) inverse one
+        plan.forward(workspace.imaginary2.data(), workspace.real2.data(), workspace.imaginary1.data(), workspace.real1.data(), workspace.real3.data(), workspace.imaginary3.data());
+        
+        // Multiply with the chirp once more, and undo the scaling of the inverse
+        const T factor = T(1) / plan.size;
+        for (size_t k = 0; k < size; ++k)
+        {
+            const T xr = workspace.real1[k] * factor, xi = workspace.imaginary1[k] * factor;
+            outReal[k] = xr * workspace.tables->chirpReal[k] - xi * workspace.tables->chirpImaginary[k];
+            outImaginary[k] = xr * workspace.tables->chirpImaginary[k] + xi * workspace.tables->chirpReal[k];
+        }
+    }
+}
@@ -0,0 +1,163 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_FAST_FOURIER_TRANSFORM_MIXED_RADIX_HPP
+#define GRIZZLY_FAST_FOURIER_TRANSFORM_MIXED_RADIX_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "../FastFourierTransformBase.hpp"
+
+namespace dsp
+{
+    //! Fourier transform for sizes that aren't a power of two
+    /*! Sizes that factor into 2, 3, 5 and 7 (such as 480, 960 or 1920) are transformed with mixed-radix Stockham
+        stages. Any other size is transformed with Bluestein's algorithm, which turns the transform into a convolution
+        that is computed with a power-of-two transform of at least twice the size. */
+    class FastFourierTransformMixedRadix : public FastFourierTransformBase
+    {
+    public:
+        //! @throw std::invalid_argument if the size is zero
+        FastFourierTransformMixedRadix(std::size_t size);
+        
+        using FastFourierTransformBase::forward;
+        using FastFourierTransformBase::inverse;
+        using FastFourierTransformBase::forwardComplex;
+        using FastFourierTransformBase::inverseComplex;
+        
+        void forward(const float* input, float* real, float* imaginary) override final;
+        void forward(const double* input, double* real, double* imaginary) override final;
+        
+        void inverse(const float* real, const float* imaginary, float* output) override final;
+        void inverse(const double* real, const double* imaginary, double* output) override final;
+        
+        void forwardComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary) override final;
+        void forwardComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary) override final;
+        
+        void inverseComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary) override final;
+        void inverseComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary) override final;
+        
+        //! Return whether this transform falls back on Bluestein's algorithm
+        bool usesBluestein() const { return bluestein; }
+        
+        //! Return whether a size factors into 2, 3, 5 and 7 only
+        static bool isFactorizable(std::size_t size);
+        
+    private:
+        //! A complex Stockham transform of a size that factors into 2, 3, 4, 5 and 7
+        template <typename T>
+        struct Plan
+        {
+            Plan(std::size_t size);
+            
+            //! Forward transform, the input and output may not be the same arrays
+            /*! The work buffers should hold size elements each */
+            void forward(const T* inReal, const T* inImaginary, T* outReal, T* outImaginary, T* workReal, T* workImaginary) const;
+            
+            //! The size of the transform
+            std::size_t size = 0;
+            
+            //! The radix of each stage
+            std::vector<std::size_t> radices;
+            
+            //! Per stage, the twiddles w^(k * p) for 0 < k < radix and p < length / radix
+            std::vector<T> twiddlesReal;
+            std::vector<T> twiddlesImaginary;
+            
+            //! Per odd radix stage, the cos and sin of 2 * pi * j * k / radix for 0 < j, k <= (radix - 1) / 2
+            std::vector<T> rotationsCosine;
+            std::vector<T> rotationsSine;
+        };
+        
+        //! Plans and tables for one precision, shared through FastFourierTransformPlanCache
+        template <typename T>
+        struct Tables
+        {
+            Tables(std::size_t size);
+            
+            //! The complex transform of the size itself, or of the convolution size for Bluestein's algorithm
+            Plan<T> complexPlan;
+            
+            //! The complex transform of half the size, for real transforms of factorizable even sizes (empty otherwise)
+            Plan<T> halfPlan;
+            
+            //! Real and imaginary parts of exp(-2 * pi * i * k / size), to untangle real transforms of even sizes
+            std::vector<T> realTwiddlesReal;
+            std::vector<T> realTwiddlesImaginary;
+            
+            //! The chirp exp(-pi * i * n^2 / size), for Bluestein's algorithm
+            std::vector<T> chirpReal;
+            std::vector<T> chirpImaginary;
+            
+            //! The spectrum of the conjugated chirp the signal is convolved with, for Bluestein's algorithm
+            std::vector<T> filterReal;
+            std::vector<T> filterImaginary;
+        };
+        
+        //! Work buffers and tables for one precision
+        template <typename T>
+        struct Workspace
+        {
+            Workspace(std::size_t size);
+            
+            //! The plans and tables
+            std::shared_ptr<const Tables<T>> tables;
+            
+            //! Work buffers, each as large as the largest transform
+            std::vector<T> real1;
+            std::vector<T> imaginary1;
+            std::vector<T> real2;
+            std::vector<T> imaginary2;
+            std::vector<T> real3;
+            std::vector<T> imaginary3;
+        };
+        
+        template <typename T>
+        void forwardReal(const T* input, T* real, T* imaginary, Workspace<T>& workspace);
+        
+        template <typename T>
+        void inverseReal(const T* real, const T* imaginary, T* output, Workspace<T>& workspace);
+        
+        //! Forward complex transform, the input and output may be the same arrays
+        template <typename T>
+        void transformComplex(const T* inReal, const T* inImaginary, T* outReal, T* outImaginary, Workspace<T>& workspace);
+        
+    private:
+        //! Is the size transformed with Bluestein's algorithm?
+        bool bluestein = false;
+        
+        //! Buffers and tables for the float overloads
+        Workspace<float> floatWorkspace;
+        
+        //! Buffers and tables for the double overloads
+        Workspace<double> doubleWorkspace;
+    };
+}
+
+#endif /* GRIZZLY_FAST_FOURIER_TRANSFORM_MIXED_RADIX_HPP */
@@ -0,0 +1,387 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_NON_UNIFORM_PARTITIONED_CONVOLUTION_HPP
+#define GRIZZLY_NON_UNIFORM_PARTITIONED_CONVOLUTION_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Convolution.hpp"
+#include "UniformPartitionedConvolution.hpp"
+
+namespace dsp
+{
+    //! Where the large partitions of a NonUniformPartitionedConvolution are computed
+    enum class PartitionScheduling
+    {
+        BACKGROUND,     //!< On a worker thread, earliest deadline first
+        DETERMINISTIC   //!< On the calling thread, at the moment their output is due, for offline rendering and tests
+    };
+    
+    //! Convolution with a long kernel and no latency, by non-uniformly partitioned convolution (Gardner)
+    /*! The first blockSize taps, the head, are convolved directly in the time domain by a Convolution. The rest of the kernel is cut into
+        stages of growing partition sizes, each convolved by a UniformPartitionedConvolution:
+        
+            stage 0: taps [B, 4B), partitions of B, computed on the calling thread at every block
+            stage s: taps [2^(s + 1) * B, 2^(s + 2) * B), partitions of 2^s * B, up to maximumBlockSize
+            last stage: all remaining taps, in partitions of maximumBlockSize
+        
+        Stage 0 delays its output by one block, which its taps start at. Every later stage starts at twice its block
+        size, so its output isn't due until a full block after its input block is complete. Those blocks are handed to
+        a worker thread, which picks the job with the earliest deadline. If a job isn't done when its output is due,
+        the calling thread waits for it, see getDeadlineMissCount().
+        
+        The kernel is kept the way Convolution keeps it, and setKernel() and getKernel() work the same. Nothing is
+        allocated while processing. */
+    template <class T>
+    class NonUniformPartitionedConvolution
+    {
+    public:
+        //! Construct with a kernel
+        NonUniformPartitionedConvolution(std::initializer_list<T> kernel, std::size_t blockSize = 64, std::size_t maximumBlockSize = 8192, PartitionScheduling scheduling = PartitionScheduling::BACKGROUND) :
+            NonUniformPartitionedConvolution(kernel.begin(), kernel.end(), blockSize, maximumBlockSize, scheduling)
+        {
+            
+        }
+        
+        //! Construct with a kernel
+        /*! @param blockSize: The size of the head and of the smallest partitions, a power of two
+            @param maximumBlockSize: The size of the largest partitions, a power of two times the block size */
+        template <typename Iterator>
+        NonUniformPartitionedConvolution(Iterator begin, Iterator end, std::size_t blockSize = 64, std::size_t maximumBlockSize = 8192, PartitionScheduling scheduling = PartitionScheduling::BACKGROUND) :
+            blockSize(blockSize),
+            maximumBlockSize(maximumBlockSize),
+            scheduling(scheduling),
+            head(begin, begin)
+        {
+            if (blockSize == 0 || maximumBlockSize < blockSize || maximumBlockSize % blockSize != 0 || !isPowerOfTwo(maximumBlockSize / blockSize))
+                throw std::invalid_argument("NonUniformPartitionedConvolution maximum block size should be a power of two times the block size");
+            
+            setKernel(begin, end);
+            
+            if (scheduling == PartitionScheduling::BACKGROUND)
+                worker = std::thread([this]{ runWorker(); });
+        }
+        
+        ~NonUniformPartitionedConvolution()
+        {
+            if (worker.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                
+                condition.notify_all();
+                worker.join();
+            }
+        }
+        
+        NonUniformPartitionedConvolution(const NonUniformPartitionedConvolution&) = delete;
+        NonUniformPartitionedConvolution& operator=(const NonUniformPartitionedConvolution&) = delete;
+        
+        //! Convolve any number of samples, without latency
+        /*! @note: The output may point to the input */
+        void process(const T* input, T* output, std::size_t count)
+        {
+            while (count > 0)
+            {
+                // Work up to the next block boundary, where the stages take their input
+                const auto phase = static_cast<std::size_t>(time % blockSize);
+                const auto chunk = std::min(count, blockSize - phase);
+                
+                for (auto& stage : stages)
+                    std::copy(input, input + chunk, stage->collect.begin() + (time % stage->blockSize));
+                
+                head.processBlock(input, output, chunk);
+                
+                for (auto& stage : stages)
+                {
+                    const T* delayed = stage->read.data() + (time % stage->blockSize);
+                    for (std::size_t i = 0; i < chunk; ++i)
+                        output[i] += delayed[i];
+                }
+                
+                time += chunk;
+                input += chunk;
+                output += chunk;
+                count -= chunk;
+                
+                if (time % blockSize == 0)
+                    advanceStages();
+            }
+        }
+        
+        //! Process a single sample
+        T process(const T& x)
+        {
+            T y;
+            process(&x, &y, 1);
+            return y;
+        }
+        
+        //! Process a single sample
+        T operator()(const T& x)
+        {
+            return process(x);
+        }
+        
+        //! Change the kernel
+        /*! This waits for the worker to finish, allocates, and clears the input history */
+        template <typename Iterator>
+        void setKernel(Iterator begin, Iterator end)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&]{ return !isBusy(); });
+            
+            kernel.assign(begin, end);
+            
+            head.setKernel(kernel.begin(), kernel.begin() + std::min(kernel.size(), blockSize));
+            head.reset();
+            
+            stages.clear();
+            for (std::size_t offset = blockSize, size = blockSize; offset < kernel.size(); size = std::min(size * 2, maximumBlockSize))
+            {
+                // Stage 0 runs up to 4B, all later ones up to four times their block size, the last one to the end
+                const auto next = (size * 2 > maximumBlockSize) ? kernel.size() : std::min<std::size_t>(size * 4, kernel.size());
+                stages.emplace_back(std::make_unique<Stage>(size, kernel.data() + offset, next - offset));
+                offset = next;
+            }
+            
+            time = 0;
+            deadlineMissCount = 0;
+        }
+        
+        //! Return the kernel
+        const std::vector<T>& getKernel() const { return kernel; }
+        
+        //! Clear all input history
+        void reset()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&]{ return !isBusy(); });
+            
+            head.reset();
+            for (auto& stage : stages)
+                stage->reset();
+            
+            time = 0;
+        }
+        
+        //! Return the number of samples in the head and the smallest partitions
+        std::size_t getBlockSize() const { return blockSize; }
+        
+        //! Return the number of partition stages after the head
+        std::size_t getStageCount() const { return stages.size(); }
+        
+        //! Return the partition size of a stage
+        std::size_t getStageBlockSize(std::size_t stage) const { return stages[stage]->blockSize; }
+        
+        //! Return how often the calling thread had to wait for the worker, since the kernel was set
+        std::size_t getDeadlineMissCount() const { return deadlineMissCount; }
+        
+        //! Return the scheduling of the large partitions
+        PartitionScheduling getScheduling() const { return scheduling; }
+        
+    private:
+        //! The state of the job of a stage
+        enum class JobState { IDLE, PENDING, RUNNING, DONE };
+        
+        //! A range of taps convolved with partitions of one size
+        struct Stage
+        {
+            Stage(std::size_t blockSize, const T* kernel, std::size_t kernelSize) :
+                blockSize(blockSize),
+                convolution(std::make_shared<const ConvolutionPartitions<T>>(blockSize, kernel, kernelSize)),
+                collect(blockSize),
+                jobInput(blockSize),
+                jobOutput(blockSize),
+                read(blockSize)
+            {
+                
+            }
+            
+            void reset()
+            {
+                convolution.reset();
+                std::fill(collect.begin(), collect.end(), T(0));
+                std::fill(read.begin(), read.end(), T(0));
+                state = JobState::IDLE;
+            }
+            
+            //! The partition size
+            std::size_t blockSize = 0;
+            
+            //! The convolution of the stage's taps
+            UniformPartitionedConvolution<T> convolution;
+            
+            //! The input block being collected
+            std::vector<T> collect;
+            
+            //! The input and output of the job, only touched by the worker while it runs
+            std::vector<T> jobInput;
+            std::vector<T> jobOutput;
+            
+            //! The output block being read
+            std::vector<T> read;
+            
+            //! The state of the job
+            JobState state = JobState::IDLE;
+            
+            //! The time at which the output of the job is due, in samples
+            std::uint64_t deadline = 0;
+        };
+        
+    private:
+        //! Return whether a number is a power of two
+        static bool isPowerOfTwo(std::size_t x) { return x > 0 && (x & (x - 1)) == 0; }
+        
+        //! Hand the completed input blocks to the stages, and take their output blocks
+        void advanceStages()
+        {
+            if (stages.empty())
+                return;
+            
+            // Stage 0 is due immediately, so it's convolved right here
+            auto& first = *stages.front();
+            first.convolution.processBlock(first.collect.data(), first.read.data());
+            
+            bool submitted = false;
+            for (std::size_t s = 1; s < stages.size(); ++s)
+            {
+                auto& stage = *stages[s];
+                if (time % stage.blockSize != 0)
+                    continue;
+                
+                std::unique_lock<std::mutex> lock(mutex);
+                if (stage.state == JobState::PENDING && scheduling == PartitionScheduling::DETERMINISTIC)
+                {
+                    stage.convolution.processBlock(stage.jobInput.data(), stage.jobOutput.data());
+                    stage.state = JobState::DONE;
+                } else if (stage.state == JobState::PENDING || stage.state == JobState::RUNNING) {
+                    ++deadlineMissCount;
+                    condition.wait(lock, [&]{ return stage.state == JobState::DONE; });
+                }
+                
+                // The job submitted a block ago finishes the output for the coming block
+                if (stage.state == JobState::DONE)
+                    stage.read.swap(stage.jobOutput);
+                
+                stage.collect.swap(stage.jobInput);
+                stage.deadline = time + stage.blockSize;
+                stage.state = JobState::PENDING;
+                submitted = true;
+            }
+            
+            if (submitted)
+                condition.notify_all();
+        }
+        
+        //! Return whether the worker is running a job, with the mutex locked
+        bool isBusy() const
+        {
+            return std::any_of(stages.begin(), stages.end(), [](const auto& stage){ return stage->state == JobState::RUNNING; });
+        }
+        
+        //! Run the jobs of the stages, earliest deadline first, until stopped
+        void runWorker()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                Stage* next = nullptr;
+                condition.wait(lock, [&]
+                {
+                    next = nullptr;
+                    for (auto& stage : stages)
+                        if (stage->state == JobState::PENDING && (!next || stage->deadline < next->deadline))
+                            next = stage.get();
+                    
+                    return stopping || next;
+                });
+                
+                if (stopping)
+                    return;
+                
+                next->state = JobState::RUNNING;
+                lock.unlock();
+                next->convolution.processBlock(next->jobInput.data(), next->jobOutput.data());
+                lock.lock();
+                next->state = JobState::DONE;
+                condition.notify_all();
+            }
+        }
+        
+    private:
+        //! The number of samples in the head and the smallest partitions
+        std::size_t blockSize = 0;
+        
+        //! The size of the largest partitions
+        std::size_t maximumBlockSize = 0;
+        
+        //! Where the large partitions are computed
+        PartitionScheduling scheduling = PartitionScheduling::BACKGROUND;
+        
+        //! The convolution kernel
+        std::vector<T> kernel;
+        
+        //! The convolution with the first blockSize taps
+        Convolution<T> head;
+        
+        //! The stages after the head, in order of partition size
+        std::vector<std::unique_ptr<Stage>> stages;
+        
+        //! The number of samples processed
+        std::uint64_t time = 0;
+        
+        //! The number of times the calling thread waited for the worker
+        std::size_t deadlineMissCount = 0;
+        
+        //! Guards the job states, and the stages as a whole against setKernel()
+        std::mutex mutex;
+        
+        //! Signals changes in the job states
+        std::condition_variable condition;
+        
+        //! Whether the worker should stop
+        bool stopping = false;
+        
+        //! The worker thread, in background scheduling
+        std::thread worker;
+    };
+}
+
+#endif /* GRIZZLY_NON_UNIFORM_PARTITIONED_CONVOLUTION_HPP */
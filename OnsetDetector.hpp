@@ -0,0 +1,479 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_ONSET_DETECTOR_HPP
+#define GRIZZLY_ONSET_DETECTOR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <experimental/optional>
+#include <stdexcept>
+#include <vector>
+
+#include "SpectralFeatures.hpp"
+#include "SplitSpectrum.hpp"
+
+namespace dsp
+{
+    //! The detection functions an OnsetDetector can use
+    enum class OnsetDetectionFunction
+    {
+        HIGH_FREQUENCY_CONTENT_BROSSIER,
+        HIGH_FREQUENCY_CONTENT_MASRI,
+        HIGH_FREQUENCY_CONTENT_JENSEN,
+        
+        //! The sum of the magnitude rises since the previous frame
+        SPECTRAL_FLUX,
+        
+        //! The distance of each bin to its prediction from the two previous frames, with constant magnitude and frequency (Bello et al.)
+        COMPLEX_DOMAIN
+    };
+    
+    //! The statistic of the recent detection function values the threshold is derived from
+    enum class OnsetThreshold { MEDIAN, MEAN };
+    
+    //! An onset found by an OnsetDetector
+    template <class T>
+    struct Onset
+    {
+        //! The sample at which the onset lies, counted from the first sample of the first frame
+        std::size_t position = 0;
+        
+        //! The value of the detection function at the onset
+        T strength = 0;
+    };
+    
+    //! Streaming onset detector, consuming the frames of a short-time Fourier transform
+    /*! Every frame yields one value of the detection function. A value becomes an onset when it's the largest within
+        lookahead frames on either side, it exceeds offset + scale * the median (or mean) of the last thresholdSize values,
+        and it lies at least the minimum interval after the previous onset. Its position is refined between frames by
+        fitting a parabola through the peak and its neighbours, and refers to the centre of the frame.
+        
+        An onset is reported lookahead frames after the frame it peaks in, so the latency is bounded by
+        getLatency() samples. Frames are expected at hopSize intervals, as StreamingShortTimeFourierTransform delivers
+        them. The median is kept in two heaps over the history, so updating it costs O(log thresholdSize) per frame, and
+        the mean is a running sum. Nothing is allocated after construction:
+        
+            stft.write(input, count, [&](const float* real, const float* imaginary)
+            {
+                if (auto onset = detector.process(real, imaginary))
+                    ...
+            }); */
+    template <typename T>
+    class OnsetDetector
+    {
+    public:
+        //! Construct the detector
+        /*! @param frameSize: The number of samples in the frames the spectra are taken of
+            @param hopSize: The number of samples between the start of two frames
+            @param thresholdSize: The number of recent detection function values the threshold is taken over
+            @param lookahead: The number of frames after a peak it has to stay the largest for */
+        OnsetDetector(std::size_t frameSize, std::size_t hopSize, OnsetDetectionFunction function = OnsetDetectionFunction::SPECTRAL_FLUX, std::size_t thresholdSize = 15, std::size_t lookahead = 2) :
+            frameSize(frameSize),
+            hopSize(hopSize),
+            lookahead(lookahead),
+            function(function),
+            magnitudes(frameSize / 2 + 1),
+            previousMagnitudes(frameSize / 2 + 1),
+            phases(frameSize / 2 + 1),
+            previousPhases(frameSize / 2 + 1),
+            olderPhases(frameSize / 2 + 1),
+            predictedReal(frameSize / 2 + 1),
+            predictedImaginary(frameSize / 2 + 1),
+            history(thresholdSize),
+            lower(thresholdSize, true),
+            upper(thresholdSize, false),
+            heapPositions(thresholdSize),
+            inLower(thresholdSize)
+        {
+            if (hopSize == 0)
+                throw std::invalid_argument("OnsetDetector hop size should be at least 1");
+            
+            if (thresholdSize < 2 * lookahead + 1)
+                throw std::invalid_argument("OnsetDetector threshold size should cover the lookahead on both sides of a peak");
+        }
+        
+        //! Process the spectrum of the next frame
+        /*! @param real: The real part of the (frameSize / 2 + 1) bins
+            @param imaginary: The imaginary part of the (frameSize / 2 + 1) bins
+            @return: The onset that got confirmed by this frame, if any */
+        std::experimental::optional<Onset<T>> process(const T* real, const T* imaginary)
+        {
+            push(computeDetectionFunction(real, imaginary));
+            return pickPeak();
+        }
+        
+        //! Forget all previous frames, the next one is frame 0 again
+        void reset()
+        {
+            spectraSeen = 0;
+            frameCount = 0;
+            count = 0;
+            lower.count = 0;
+            upper.count = 0;
+            sum = 0;
+            lastOnset = std::experimental::nullopt;
+        }
+        
+        //! Change the detection function, which takes effect from the next frame
+        /*! Functions that look back at previous frames start over, and give zero until they have seen enough of them */
+        void setFunction(OnsetDetectionFunction function)
+        {
+            this->function = function;
+            spectraSeen = 0;
+        }
+        
+        //! Return the detection function
+        OnsetDetectionFunction getFunction() const { return function; }
+        
+        //! Change the threshold, offset + scale * the median or mean of the recent detection function values
+        void setThreshold(T offset, T scale, OnsetThreshold statistic = OnsetThreshold::MEDIAN)
+        {
+            thresholdOffset = offset;
+            thresholdScale = scale;
+            thresholdStatistic = statistic;
+        }
+        
+        //! Change the minimum number of samples between two onsets
+        void setMinimumInterval(std::size_t samples) { minimumInterval = samples; }
+        
+        //! Return the value of the detection function for the last frame
+        T getDetectionFunction() const { return (count > 0) ? valueAt(frameCount - 1) : 0; }
+        
+        //! Return the threshold the frames are currently held against
+        T getThreshold() const
+        {
+            if (count == 0)
+                return thresholdOffset;
+            
+            const T statistic = (thresholdStatistic == OnsetThreshold::MEDIAN) ? getMedian() : static_cast<T>(sum / count);
+            return thresholdOffset + thresholdScale * statistic;
+        }
+        
+        //! Return the number of samples between an onset and the last sample of the frame it's reported with
+        std::size_t getLatency() const { return lookahead * hopSize + frameSize / 2; }
+        
+        //! Return the number of samples in each frame
+        std::size_t getFrameSize() const { return frameSize; }
+        
+        //! Return the number of samples between the start of two frames
+        std::size_t getHopSize() const { return hopSize; }
+        
+    private:
+        //! Compute the detection function of a spectrum, and remember what the next one needs of it
+        T computeDetectionFunction(const T* real, const T* imaginary)
+        {
+            const auto binCount = magnitudes.size();
+            std::swap(magnitudes, previousMagnitudes);
+            computeMagnitudes(real, imaginary, magnitudes.data(), binCount);
+            
+            T value = 0;
+            if (function == OnsetDetectionFunction::COMPLEX_DOMAIN)
+            {
+                std::swap(olderPhases, previousPhases);
+                std::swap(previousPhases, phases);
+                computePhases(real, imaginary, phases.data(), binCount);
+                
+                if (spectraSeen >= 2)
+                {
+                    // Predict every bin from the previous magnitude and phase, advanced by the previous phase difference
+                    for (std::size_t k = 0; k < binCount; ++k)
+                        predictedImaginary[k] = 2 * previousPhases[k] - olderPhases[k];
+                    
+                    polarToCartesian(previousMagnitudes.data(), predictedImaginary.data(), predictedReal.data(), predictedImaginary.data(), binCount);
+                    for (std::size_t k = 0; k < binCount; ++k)
+                    {
+                        predictedReal[k] = real[k] - predictedReal[k];
+                        predictedImaginary[k] = imaginary[k] - predictedImaginary[k];
+                    }
+                    
+                    computeMagnitudes(predictedReal.data(), predictedImaginary.data(), predictedReal.data(), binCount);
+                    for (std::size_t k = 0; k < binCount; ++k)
+                        value += predictedReal[k];
+                }
+            } else {
+                const auto features = computeSpectralFeatures(magnitudes.data(), (spectraSeen >= 1) ? previousMagnitudes.data() : nullptr, binCount);
+                switch (function)
+                {
+                    case OnsetDetectionFunction::HIGH_FREQUENCY_CONTENT_BROSSIER: value = features.highFrequencyContentBrossier; break;
+                    case OnsetDetectionFunction::HIGH_FREQUENCY_CONTENT_MASRI: value = features.highFrequencyContentMasri; break;
+                    case OnsetDetectionFunction::HIGH_FREQUENCY_CONTENT_JENSEN: value = features.highFrequencyContentJensen; break;
+                    default: value = features.flux; break;
+                }
+            }
+            
+            ++spectraSeen;
+            return value;
+        }
+        
+        //! A binary heap of history slots, ordered by their values
+        struct Heap
+        {
+            Heap(std::size_t capacity, bool largestOnTop) :
+                slots(capacity),
+                largestOnTop(largestOnTop)
+            {
+                
+            }
+            
+            //! The slots, in heap order
+            std::vector<std::size_t> slots;
+            
+            //! The number of slots in the heap
+            std::size_t count = 0;
+            
+            //! Whether the largest value is on top, or the smallest
+            bool largestOnTop = true;
+        };
+        
+        //! Add a detection function value to the history, and to the heaps the median is taken from
+        void push(T value)
+        {
+            const auto slot = frameCount % history.size();
+            if (count == history.size())
+            {
+                // Drop the oldest value, which is about to be overwritten
+                erase(inLower[slot] ? lower : upper, heapPositions[slot]);
+                sum -= history[slot];
+                --count;
+            }
+            
+            history[slot] = value;
+            insert((lower.count == 0 || value <= history[lower.slots[0]]) ? lower : upper, slot);
+            
+            // Keep the lower half as large as the upper half, or one larger
+            if (lower.count > upper.count + 1)
+                insert(upper, pop(lower));
+            else if (upper.count > lower.count)
+                insert(lower, pop(upper));
+            
+            sum += value;
+            ++count;
+            ++frameCount;
+        }
+        
+        //! Return the median of the values in the history, which must not be empty
+        T getMedian() const
+        {
+            const T middle = history[lower.slots[0]];
+            return (count % 2) ? middle : (middle + history[upper.slots[0]]) / 2;
+        }
+        
+        //! Add a history slot to a heap
+        void insert(Heap& heap, std::size_t slot)
+        {
+            inLower[slot] = (&heap == &lower);
+            const auto position = heap.count++;
+            heap.slots[position] = slot;
+            siftUp(heap, position);
+        }
+        
+        //! Remove the slot at a position from a heap
+        void erase(Heap& heap, std::size_t position)
+        {
+            const auto last = heap.slots[--heap.count];
+            if (position == heap.count)
+                return;
+            
+            // Fill the hole with the last slot, which may belong above or below it
+            place(heap, position, last);
+            siftUp(heap, position);
+            siftDown(heap, heapPositions[last]);
+        }
+        
+        //! Remove the top slot from a heap and return it
+        std::size_t pop(Heap& heap)
+        {
+            const auto top = heap.slots[0];
+            erase(heap, 0);
+            return top;
+        }
+        
+        //! Move a slot towards the top of a heap until its parent goes above it
+        void siftUp(Heap& heap, std::size_t position)
+        {
+            const auto slot = heap.slots[position];
+            while (position > 0)
+            {
+                const auto parent = (position - 1) / 2;
+                if (!isAbove(heap, slot, heap.slots[parent]))
+                    break;
+                
+                place(heap, position, heap.slots[parent]);
+                position = parent;
+            }
+            
+            place(heap, position, slot);
+        }
+        
+        //! Move a slot towards the bottom of a heap until it goes above its children
+        void siftDown(Heap& heap, std::size_t position)
+        {
+            const auto slot = heap.slots[position];
+            for (auto child = 2 * position + 1; child < heap.count; child = 2 * position + 1)
+            {
+                if (child + 1 < heap.count && isAbove(heap, heap.slots[child + 1], heap.slots[child]))
+                    ++child;
+                
+                if (!isAbove(heap, heap.slots[child], slot))
+                    break;
+                
+                place(heap, position, heap.slots[child]);
+                position = child;
+            }
+            
+            place(heap, position, slot);
+        }
+        
+        //! Put a slot at a position in a heap, and remember where it went
+        void place(Heap& heap, std::size_t position, std::size_t slot)
+        {
+            heap.slots[position] = slot;
+            heapPositions[slot] = position;
+        }
+        
+        //! Return whether one slot belongs above another in a heap
+        bool isAbove(const Heap& heap, std::size_t lhs, std::size_t rhs) const
+        {
+            return heap.largestOnTop ? history[lhs] > history[rhs] : history[lhs] < history[rhs];
+        }
+        
+        //! Return the detection function value of a frame still in the history
+        T valueAt(std::size_t frame) const { return history[frame % history.size()]; }
+        
+        //! Check whether the frame lookahead frames back is an onset
+        std::experimental::optional<Onset<T>> pickPeak()
+        {
+            if (frameCount <= lookahead)
+                return std::experimental::nullopt;
+            
+            // Compare against the neighbours within the lookahead, as far back as the history goes
+            const std::size_t candidate = frameCount - 1 - lookahead;
+            const T value = valueAt(candidate);
+            const std::size_t first = (candidate >= lookahead) ? candidate - lookahead : 0;
+            
+            for (auto frame = first; frame < frameCount; ++frame)
+            {
+                // Of a plateau, only the first frame counts
+                if ((frame < candidate && valueAt(frame) >= value) || (frame > candidate && valueAt(frame) > value))
+                    return std::experimental::nullopt;
+            }
+            
+            if (value <= getThreshold())
+                return std::experimental::nullopt;
+            
+            // Fit a parabola through the peak and its neighbours to place it between frames
+            T offset = 0;
+            if (candidate > 0 && lookahead > 0)
+            {
+                const T before = valueAt(candidate - 1);
+                const T after = valueAt(candidate + 1);
+                const T curvature = before - 2 * value + after;
+                if (curvature < 0)
+                    offset = std::max<T>(-0.5, std::min<T>(0.5, (before - after) / (2 * curvature)));
+            }
+            
+            // Only the offset goes through T, whose precision would otherwise run out on long streams (beyond 2^24
+            // samples for float)
+            const auto center = candidate * hopSize + frameSize / 2;
+            const auto shift = static_cast<std::ptrdiff_t>(std::lround(offset * hopSize));
+            const auto position = (shift >= 0) ? center + static_cast<std::size_t>(shift) : center - std::min(center, static_cast<std::size_t>(-shift));
+            if (lastOnset && position < *lastOnset + minimumInterval)
+                return std::experimental::nullopt;
+            
+            lastOnset = position;
+            
+            Onset<T> onset;
+            onset.position = position;
+            onset.strength = value;
+            return onset;
+        }
+        
+    private:
+        //! The number of samples in each frame
+        std::size_t frameSize = 0;
+        
+        //! The number of samples between the start of two frames
+        std::size_t hopSize = 0;
+        
+        //! The number of frames after a peak it has to stay the largest for
+        std::size_t lookahead = 0;
+        
+        //! The detection function
+        OnsetDetectionFunction function = OnsetDetectionFunction::SPECTRAL_FLUX;
+        
+        //! The magnitudes of the current and previous spectrum
+        std::vector<T> magnitudes;
+        std::vector<T> previousMagnitudes;
+        
+        //! The phases of the current and two previous spectra, for the complex domain
+        std::vector<T> phases;
+        std::vector<T> previousPhases;
+        std::vector<T> olderPhases;
+        
+        //! Scratch space for the predicted bins of the complex domain
+        std::vector<T> predictedReal;
+        std::vector<T> predictedImaginary;
+        
+        //! The number of spectra the current detection function has seen
+        std::size_t spectraSeen = 0;
+        
+        //! The last detection function values in a ring, indexed by frame
+        std::vector<T> history;
+        
+        //! The slots of the lower half of the history with the largest value on top, and the upper half with the smallest
+        Heap lower;
+        Heap upper;
+        
+        //! The position of every history slot in its heap, and whether that's the lower one
+        std::vector<std::size_t> heapPositions;
+        std::vector<bool> inLower;
+        
+        //! The sum of the values in the history, for the mean
+        double sum = 0;
+        
+        //! The number of values in the history
+        std::size_t count = 0;
+        
+        //! The number of frames processed
+        std::size_t frameCount = 0;
+        
+        //! The threshold, offset + scale * the statistic
+        T thresholdOffset = 0;
+        T thresholdScale = 1.5;
+        OnsetThreshold thresholdStatistic = OnsetThreshold::MEDIAN;
+        
+        //! The minimum number of samples between two onsets
+        std::size_t minimumInterval = 0;
+        
+        //! The position of the last onset
+        std::experimental::optional<std::size_t> lastOnset;
+    };
+}
+
+#endif /* GRIZZLY_ONSET_DETECTOR_HPP */
@@ -26,8 +26,13 @@
  */
 
 #include <algorithm>
+#include <cmath>
+#include <condition_variable>
 #include <dsperados/math/interleave.hpp>
+#include <mutex>
+#include <thread>
 
+#include "../FastFourierTransformPlanCache.hpp"
 #include "FastFourierTransformOoura.hpp"
 #include "fftsg.h"
 
@@ -35,41 +40,332 @@ using namespace std;
 
 namespace dsp
 {
-    FastFourierTransformOoura::FastFourierTransformOoura(size_t size) :
-        FastFourierTransformBase(size),
-        data(size),
+    //! Return a table in the form Ooura's routines expect
+    /*! The tables are fully initialized up front, so the routines only read them even though they take mutable pointers */
+    template <typename T>
+    static T* getTable(const vector<T>& table)
+    {
+        return const_cast<T*>(table.data());
+    }
+    
+    //! The number of columns a thread gathers and transforms at once in the four-step algorithm
+    static const size_t columnBlockSize = 16;
+    
+    //! The distance between two column buffers, padded so they don't all map onto the same cache sets
+    static size_t getColumnStride(size_t rows)
+    {
+        return rows * 2 + 16;
+    }
+    
+    class FastFourierTransformOoura::WorkerPool
+    {
+    public:
+        //! Start the worker threads
+        WorkerPool(size_t workerCount)
+        {
+            threads.reserve(workerCount);
+            for (size_t i = 0; i < workerCount; ++i)
+                threads.emplace_back([this, i]{ work(i + 1); });
+        }
+        
+        //! Stop the worker threads, after they finished their current part
+        ~WorkerPool()
+        {
+            {
+                lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            
+            wake.notify_all();
+            for (auto& thread : threads)
+                thread.join();
+        }
+        
+        //! Divide a range over the workers and the calling thread, and wait until all of them are done
+        /*! The function is called as function(thread, begin, end), the calling thread handles the first part */
+        template <typename Function>
+        void parallelFor(size_t count, const Function& function)
+        {
+            const auto threadCount = threads.size() + 1;
+            const auto chunk = (count + threadCount - 1) / threadCount;
+            const auto part = [&](size_t thread)
+            {
+                const auto begin = min(count, thread * chunk);
+                const auto end = min(count, begin + chunk);
+                if (begin < end)
+                    function(thread, begin, end);
+            };
+            
+            // Hand the workers the part through a plain function pointer, so that nothing is allocated
+            {
+                lock_guard<std::mutex> lock(mutex);
+                task = [](const void* context, size_t thread){ (*static_cast<decltype(&part)>(context))(thread); };
+                context = &part;
+                pending = threads.size();
+                ++generation;
+            }
+            
+            wake.notify_all();
+            part(0);
+            
+            unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [&]{ return pending == 0; });
+        }
+        
+    private:
+        //! Wait for parts and run them, until the pool stops
+        void work(size_t thread)
+        {
+            unique_lock<std::mutex> lock(mutex);
+            auto seen = generation;
+            
+            while (true)
+            {
+                wake.wait(lock, [&]{ return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                
+                seen = generation;
+                lock.unlock();
+                task(context, thread);
+                lock.lock();
+                
+                if (--pending == 0)
+                    done.notify_one();
+            }
+        }
+        
+    private:
+        std::mutex mutex;
+        
+        //! Signals the workers a new part (or stopping), and the caller that all parts are done
+        condition_variable wake;
+        condition_variable done;
+        
+        //! The part to run, called with the context and the thread index
+        void (*task)(const void*, size_t) = nullptr;
+        const void* context = nullptr;
+        
+        //! The number of workers still running their part
+        size_t pending = 0;
+        
+        //! Incremented for every parallelFor, so that workers know there is a new part
+        size_t generation = 0;
+        
+        bool stopping = false;
+        
+        vector<thread> threads;
+    };
+    
+    template <typename T>
+    FastFourierTransformOoura::Tables<T>::Tables(size_t size) :
         ip(static_cast<size_t>(2 + sqrt(size))),
-        w(size / 2 - 1),
-        dataComplex(size * 2)
+        w(max<size_t>(size / 2 + size / 4, 1))
+    {
+        // The table holds the complex cos/sin table (size / 2) followed by the real one (size / 4).
+        // These are the sizes cdft and rdft would generate lazily, so neither of them will touch the tables anymore.
+        const auto nw = max<int>(static_cast<int>(size / 2), 1);
+        makewt(nw, ip.data(), w.data());
+        makect(max<int>(static_cast<int>(size / 4), 1), ip.data(), w.data() + nw);
+    }
+    
+    template <typename T>
+    FastFourierTransformOoura::Workspace<T>::Workspace(size_t size) :
+        data(size),
+        dataComplex(size * 2),
+        tables(size > 0 ? FastFourierTransformPlanCache<Tables<T>>::get(size) : nullptr)
+    {
+        
+    }
+    
+    template <typename T>
+    FastFourierTransformOoura::Split<T>::Split(size_t size)
+    {
+        // Make the columns and rows as square as possible
+        auto bits = 0;
+        while ((size_t(1) << bits) < size)
+            ++bits;
+        
+        rows = size_t(1) << (bits / 2);
+        columns = size / rows;
+        columnShift = bits - bits / 2;
+        
+        columnTables = FastFourierTransformPlanCache<Tables<T>>::get(rows);
+        rowTables = FastFourierTransformPlanCache<Tables<T>>::get(columns);
+        
+        fineTwiddles.resize(columns * 2);
+        for (size_t r = 0; r < columns; ++r)
+        {
+            const auto angle = -2 * acos(-1.l) * r / size;
+            fineTwiddles[r * 2] = static_cast<T>(cos(angle));
+            fineTwiddles[r * 2 + 1] = static_cast<T>(sin(angle));
+        }
+        
+        coarseTwiddles.resize(rows * 2);
+        for (size_t q = 0; q < rows; ++q)
+        {
+            const auto angle = -2 * acos(-1.l) * q * columns / size;
+            coarseTwiddles[q * 2] = static_cast<T>(cos(angle));
+            coarseTwiddles[q * 2 + 1] = static_cast<T>(sin(angle));
+        }
+    }
+    
+    template <typename T>
+    FastFourierTransformOoura::ThreadedTables<T>::ThreadedTables(size_t size) :
+        complexSplit(size),
+        halfSplit(size / 2),
+        realTwiddles(size / 2 * 2)
     {
-        // Ensure ip[0] is zero, otherwise the zero and cosines won't be generated
-        ip[0] = 0;
+        for (size_t k = 0; k < size / 2; ++k)
+        {
+            const auto angle = -2 * acos(-1.l) * k / size;
+            realTwiddles[k * 2] = static_cast<T>(cos(angle));
+            realTwiddles[k * 2 + 1] = static_cast<T>(sin(angle));
+        }
     }
+    
+    FastFourierTransformOoura::FastFourierTransformOoura(size_t size, FloatPrecision floatPrecision) :
+        FastFourierTransformBase(size),
+        floatPrecision(floatPrecision),
+        doubleWorkspace(size),
+        floatWorkspace(floatPrecision == FloatPrecision::SINGLE ? size : 0)
+    {
 
-    void FastFourierTransformOoura::forward(const float* input, float* real, float* imaginary)
+    }
+    
+    FastFourierTransformOoura::~FastFourierTransformOoura() = default;
+
+    void FastFourierTransformOoura::setThreadCount(size_t threadCount)
     {
-        data.assign(input, input + size);
+        this->threadCount = (threadCount > 0) ? threadCount : max<size_t>(thread::hardware_concurrency(), 1);
+        updateThreading();
+    }
+    
+    void FastFourierTransformOoura::setThreadingThreshold(size_t threadingThreshold)
+    {
+        this->threadingThreshold = max<size_t>(threadingThreshold, 16);
+        updateThreading();
+    }
+    
+    void FastFourierTransformOoura::updateThreading()
+    {
+        workers = isThreaded() ? make_unique<WorkerPool>(threadCount - 1) : nullptr;
         
-        rdft(static_cast<int>(size), 1, data.data(), ip.data(), w.data());
+        updateThreading(doubleWorkspace);
         
-        for (auto i = 0; i < size / 2; ++i)
+        if (floatPrecision == FloatPrecision::SINGLE)
+            updateThreading(floatWorkspace);
+    }
+    
+    template <typename T>
+    void FastFourierTransformOoura::updateThreading(Workspace<T>& workspace)
+    {
+        if (!isThreaded())
         {
-            real[i] = data[i * 2];
-            imaginary[i] = -data[i * 2 + 1];
+            workspace.threadedTables = nullptr;
+            workspace.columns = {};
+            return;
         }
         
-        real[size / 2] = - imaginary[0];
-        imaginary[0] = 0;
-        imaginary[size / 2] = 0;
+        workspace.threadedTables = FastFourierTransformPlanCache<ThreadedTables<T>>::get(size);
+        
+        // The complex split has at least as many rows as the one of half the size
+        workspace.columns.resize(threadCount * columnBlockSize * getColumnStride(workspace.threadedTables->complexSplit.rows));
+    }
+    
+    void FastFourierTransformOoura::forward(const float* input, float* real, float* imaginary)
+    {
+        if (floatPrecision == FloatPrecision::SINGLE)
+            forwardReal(input, real, imaginary, floatWorkspace);
+        else
+            forwardReal(input, real, imaginary, doubleWorkspace);
     }
     
     void FastFourierTransformOoura::forward(const double* input, double* real, double* imaginary)
     {
+        forwardReal(input, real, imaginary, doubleWorkspace);
+    }
+    
+    void FastFourierTransformOoura::inverse(const float* real, const float* imaginary, float* output)
+    {
+        if (floatPrecision == FloatPrecision::SINGLE)
+            inverseReal(real, imaginary, output, floatWorkspace);
+        else
+            inverseReal(real, imaginary, output, doubleWorkspace);
+    }
+    
+    void FastFourierTransformOoura::inverse(const double* real, const double* imaginary, double* output)
+    {
+        inverseReal(real, imaginary, output, doubleWorkspace);
+    }
+    
+    void FastFourierTransformOoura::forwardComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary)
+    {
+        if (floatPrecision == FloatPrecision::SINGLE)
+            transformComplex(inReal, inImaginary, outReal, outImaginary, -1, floatWorkspace);
+        else
+            transformComplex(inReal, inImaginary, outReal, outImaginary, -1, doubleWorkspace);
+    }
+    
+    void FastFourierTransformOoura::forwardComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary)
+    {
+        transformComplex(inReal, inImaginary, outReal, outImaginary, -1, doubleWorkspace);
+    }
+    
+    void FastFourierTransformOoura::inverseComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary)
+    {
+        if (floatPrecision == FloatPrecision::SINGLE)
+            transformComplex(inReal, inImaginary, outReal, outImaginary, 1, floatWorkspace);
+        else
+            transformComplex(inReal, inImaginary, outReal, outImaginary, 1, doubleWorkspace);
+    }
+    
+    void FastFourierTransformOoura::inverseComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary)
+    {
+        transformComplex(inReal, inImaginary, outReal, outImaginary, 1, doubleWorkspace);
+    }
+    
+    void FastFourierTransformOoura::forwardPacked(const float* input, float* packed)
+    {
+        if (floatPrecision == FloatPrecision::SINGLE)
+            forwardPackedReal(input, packed, floatWorkspace);
+        else
+            forwardPackedReal(input, packed, doubleWorkspace);
+    }
+    
+    void FastFourierTransformOoura::forwardPacked(const double* input, double* packed)
+    {
+        forwardPackedReal(input, packed, doubleWorkspace);
+    }
+    
+    void FastFourierTransformOoura::inversePacked(const float* packed, float* output)
+    {
+        if (floatPrecision == FloatPrecision::SINGLE)
+            inversePackedReal(packed, output, floatWorkspace);
+        else
+            inversePackedReal(packed, output, doubleWorkspace);
+    }
+    
+    void FastFourierTransformOoura::inversePacked(const double* packed, double* output)
+    {
+        inversePackedReal(packed, output, doubleWorkspace);
+    }
+    
+    template <typename T, typename U>
+    void FastFourierTransformOoura::forwardReal(const T* input, T* real, T* imaginary, Workspace<U>& workspace)
+    {
+        if (isThreaded())
+        {
+            forwardRealThreaded(input, real, imaginary, workspace);
+            return;
+        }
+        
+        auto& data = workspace.data;
         data.assign(input, input + size);
         
-        rdft(static_cast<int>(size), 1, data.data(), ip.data(), w.data());
+        rdft(static_cast<int>(size), 1, data.data(), getTable(workspace.tables->ip), getTable(workspace.tables->w));
         
-        for (auto i = 0; i < size / 2; ++i)
+        for (size_t i = 0; i < size / 2; ++i)
         {
             real[i] = data[i * 2];
             imaginary[i] = -data[i * 2 + 1]; // Flip imaginary axis, otherwise Ooura will invert the signal
@@ -80,9 +376,17 @@ namespace dsp
         imaginary[size / 2] = 0;
     }
     
-    void FastFourierTransformOoura::inverse(const float* real, const float* imaginary, float* output)
+    template <typename T, typename U>
+    void FastFourierTransformOoura::inverseReal(const T* real, const T* imaginary, T* output, Workspace<U>& workspace)
     {
-        for (auto i = 0; i < size / 2; ++i)
+        if (isThreaded())
+        {
+            inverseRealThreaded(real, imaginary, output, workspace);
+            return;
+        }
+        
+        auto& data = workspace.data;
+        for (size_t i = 0; i < size / 2; ++i)
         {
             data[i * 2] = real[i];
             data[i * 2 + 1] = -imaginary[i]; // Flip imaginary axis, otherwise Ooura will invert the signal
@@ -90,75 +394,265 @@ namespace dsp
         
         data[1] = real[size / 2];
         
-        rdft(static_cast<int>(size), -1, data.data(), ip.data(), w.data());
+        rdft(static_cast<int>(size), -1, data.data(), getTable(workspace.tables->ip), getTable(workspace.tables->w));
         
-        move(data.begin(), data.end(), output);
+        const U factor = U(2) / size;
+        std::transform(data.begin(), data.end(), output, [&](const U& x){ return static_cast<T>(x * factor); });
+    }
+    
+    template <typename T, typename U>
+    void FastFourierTransformOoura::transformComplex(const T* inReal, const T* inImaginary, T* outReal, T* outImaginary, int direction, Workspace<U>& workspace)
+    {
+        if (isThreaded())
+        {
+            transformComplexThreaded(inReal, inImaginary, outReal, outImaginary, direction, workspace);
+            return;
+        }
+        
+        auto& dataComplex = workspace.dataComplex;
+        math::interleave(inReal, inReal + size, inImaginary, dataComplex.begin());
+        
+        // Ooura's cdft uses exp(2*pi*i*j*k/n) for a positive sign, so the forward transform is the negative one
+        cdft(static_cast<int>(size * 2), direction, dataComplex.data(), getTable(workspace.tables->ip), getTable(workspace.tables->w));
+        
+        // Scale the inverse by 1 / size
+        if (direction > 0)
+        {
+            const U factor = U(1) / size;
+            std::transform(dataComplex.begin(), dataComplex.end(), dataComplex.begin(), [&](const U& x){ return x * factor; });
+        }
         
-        float factor = 2.0 / size;
-        std::transform(output, output + size, output, [&](const float& x){ return x * factor; });
+        math::deinterleave(dataComplex.begin(), dataComplex.end(), outReal, outImaginary);
     }
     
-    void FastFourierTransformOoura::inverse(const double* real, const double* imaginary, double* output)
+    template <typename T, typename U>
+    void FastFourierTransformOoura::forwardPackedReal(const T* input, T* packed, Workspace<U>& workspace)
     {
-        for (auto i = 0; i < size / 2; ++i)
+        if (isThreaded())
         {
-            data[i * 2] = real[i];
-            data[i * 2 + 1] = -imaginary[i];
+            FastFourierTransformBase::forwardPacked(input, packed);
+            return;
         }
         
-        data[1] = real[size / 2];
+        // Computing in a different precision, so go through the work buffer
+        auto& data = workspace.data;
+        data.assign(input, input + size);
         
-        rdft(static_cast<int>(size), -1, data.data(), ip.data(), w.data());
+        rdft(static_cast<int>(size), 1, data.data(), getTable(workspace.tables->ip), getTable(workspace.tables->w));
+        
+        std::copy(data.begin(), data.end(), packed);
+    }
+    
+    template <typename T>
+    void FastFourierTransformOoura::forwardPackedReal(const T* input, T* packed, Workspace<T>& workspace)
+    {
+        if (isThreaded())
+        {
+            FastFourierTransformBase::forwardPacked(input, packed);
+            return;
+        }
         
-        move(data.begin(), data.end(), output);
+        if (input != packed)
+            std::copy(input, input + size, packed);
         
-        float factor = 2.0 / size;
-        std::transform(output, output + size, output, [&](const double& x){ return x * factor; });
+        rdft(static_cast<int>(size), 1, packed, getTable(workspace.tables->ip), getTable(workspace.tables->w));
     }
     
-    void FastFourierTransformOoura::forwardComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary)
+    template <typename T, typename U>
+    void FastFourierTransformOoura::inversePackedReal(const T* packed, T* output, Workspace<U>& workspace)
     {
-        math::interleave(inReal, inReal + size, inImaginary, dataComplex.begin());
+        if (isThreaded())
+        {
+            FastFourierTransformBase::inversePacked(packed, output);
+            return;
+        }
         
-        cdft(static_cast<int>(size * 2), 1, dataComplex.data(), ip.data(), w.data());
+        // Computing in a different precision, so go through the work buffer
+        auto& data = workspace.data;
+        data.assign(packed, packed + size);
         
-        math::deinterleave(dataComplex.begin(), dataComplex.end(), outReal, outImaginary);
-        std::transform(outImaginary, outImaginary + size, outImaginary, std::negate<>());
+        rdft(static_cast<int>(size), -1, data.data(), getTable(workspace.tables->ip), getTable(workspace.tables->w));
+        
+        const U factor = U(2) / size;
+        std::transform(data.begin(), data.end(), output, [&](const U& x){ return static_cast<T>(x * factor); });
     }
     
-    void FastFourierTransformOoura::forwardComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary)
+    template <typename T>
+    void FastFourierTransformOoura::inversePackedReal(const T* packed, T* output, Workspace<T>& workspace)
     {
-        math::interleave(inReal, inReal + size, inImaginary, dataComplex.begin());
+        if (isThreaded())
+        {
+            FastFourierTransformBase::inversePacked(packed, output);
+            return;
+        }
         
-        cdft(static_cast<int>(size * 2), 1, dataComplex.data(), ip.data(), w.data());
+        // Scale while copying, so the transform leaves the output ready
+        const T factor = T(2) / size;
+        std::transform(packed, packed + size, output, [&](const T& x){ return x * factor; });
         
-        math::deinterleave(dataComplex.begin(), dataComplex.end(), outReal, outImaginary);
-        std::transform(outImaginary, outImaginary + size, outImaginary, std::negate<>());
+        rdft(static_cast<int>(size), -1, output, getTable(workspace.tables->ip), getTable(workspace.tables->w));
     }
     
-    void FastFourierTransformOoura::inverseComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary)
+    template <typename T, typename U>
+    void FastFourierTransformOoura::forwardRealThreaded(const T* input, T* real, T* imaginary, Workspace<U>& workspace)
     {
-        math::interleave(inReal, inReal + size, inImaginary, dataComplex.begin());
+        const auto& tables = *workspace.threadedTables;
+        const auto half = size / 2;
         
-        cdft(static_cast<int>(size * 2), -1, dataComplex.data(), ip.data(), w.data());
+        // Treat the even samples as real, the odd ones as imaginary part of a signal of half the size
+        U* z = workspace.data.data();
+        transformSplit(tables.halfSplit, workspace,
+                       [&](size_t n, U& x, U& y){ x = input[n * 2]; y = input[n * 2 + 1]; },
+                       [&](size_t k, U x, U y){ z[k * 2] = x; z[k * 2 + 1] = y; });
         
-        const float factor = 1.0 / size;
-        std::transform(dataComplex.begin(), dataComplex.end(), dataComplex.begin(), [&](const double& x){ return x * factor; });
+        // DC and Nyquist are both real
+        real[0] = static_cast<T>(z[0] + z[1]);
+        imaginary[0] = 0;
+        real[half] = static_cast<T>(z[0] - z[1]);
+        imaginary[half] = 0;
         
-        math::deinterleave(dataComplex.begin(), dataComplex.end(), outReal, outImaginary);
-        std::transform(outReal, outReal + size, outReal, std::negate<>());
+        // Untangle the spectra of the even and odd samples, and combine them
+        workers->parallelFor(half - 1, [&](size_t, size_t begin, size_t end)
+        {
+            for (auto k = begin + 1; k < end + 1; ++k)
+            {
+                const U ar = z[k * 2], ai = z[k * 2 + 1];
+                const U br = z[(half - k) * 2], bi = -z[(half - k) * 2 + 1];
+                
+                const U evenReal = (ar + br) * U(0.5);
+                const U evenImaginary = (ai + bi) * U(0.5);
+                const U oddReal = (ai - bi) * U(0.5);
+                const U oddImaginary = (br - ar) * U(0.5);
+                
+                const U wr = tables.realTwiddles[k * 2];
+                const U wi = tables.realTwiddles[k * 2 + 1];
+                real[k] = static_cast<T>(evenReal + wr * oddReal - wi * oddImaginary);
+                imaginary[k] = static_cast<T>(evenImaginary + wr * oddImaginary + wi * oddReal);
+            }
+        });
     }
     
-    void FastFourierTransformOoura::inverseComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary)
+    template <typename T, typename U>
+    void FastFourierTransformOoura::inverseRealThreaded(const T* real, const T* imaginary, T* output, Workspace<U>& workspace)
     {
-        math::interleave(inReal, inReal + size, inImaginary, dataComplex.begin());
+        const auto& tables = *workspace.threadedTables;
+        const auto half = size / 2;
+        
+        // Tangle the spectrum back into the one of a complex signal of half the size. The real and
+        // imaginary parts are swapped, so that the forward transform computes the inverse one.
+        U* z = workspace.data.data();
+        workers->parallelFor(half, [&](size_t, size_t begin, size_t end)
+        {
+            for (auto k = begin; k < end; ++k)
+            {
+                const U ar = real[k], ai = imaginary[k];
+                const U br = real[half - k], bi = -imaginary[half - k];
+                
+                const U evenReal = (ar + br) * U(0.5);
+                const U evenImaginary = (ai + bi) * U(0.5);
+                const U differenceReal = (ar - br) * U(0.5);
+                const U differenceImaginary = (ai - bi) * U(0.5);
+                
+                const U wr = tables.realTwiddles[k * 2];
+                const U wi = tables.realTwiddles[k * 2 + 1];
+                const U oddReal = wr * differenceReal + wi * differenceImaginary;
+                const U oddImaginary = wr * differenceImaginary - wi * differenceReal;
+                
+                z[k * 2] = evenImaginary + oddReal;
+                z[k * 2 + 1] = evenReal - oddImaginary;
+            }
+        });
+        
+        // Swap back, scale and interleave the even and odd samples
+        const U factor = U(1) / half;
+        transformSplit(tables.halfSplit, workspace,
+                       [&](size_t n, U& x, U& y){ x = z[n * 2]; y = z[n * 2 + 1]; },
+                       [&](size_t k, U x, U y){ output[k * 2] = static_cast<T>(y * factor); output[k * 2 + 1] = static_cast<T>(x * factor); });
+    }
+    
+    template <typename T, typename U>
+    void FastFourierTransformOoura::transformComplexThreaded(const T* inReal, const T* inImaginary, T* outReal, T* outImaginary, int direction, Workspace<U>& workspace)
+    {
+        const auto& split = workspace.threadedTables->complexSplit;
         
-        cdft(static_cast<int>(size * 2), -1, dataComplex.data(), ip.data(), w.data());
+        // The input is read completely before the output is written, so this is safe in-place
+        if (direction < 0)
+        {
+            transformSplit(split, workspace,
+                           [&](size_t n, U& x, U& y){ x = inReal[n]; y = inImaginary[n]; },
+                           [&](size_t k, U x, U y){ outReal[k] = static_cast<T>(x); outImaginary[k] = static_cast<T>(y); });
+        } else {
+            // Swapping the real and imaginary parts turns the forward transform into an (unscaled) inverse one
+            const U factor = U(1) / size;
+            transformSplit(split, workspace,
+                           [&](size_t n, U& x, U& y){ x = inImaginary[n]; y = inReal[n]; },
+                           [&](size_t k, U x, U y){ outReal[k] = static_cast<T>(y * factor); outImaginary[k] = static_cast<T>(x * factor); });
+        }
+    }
+    
+    template <typename T, typename Load, typename Store>
+    void FastFourierTransformOoura::transformSplit(const Split<T>& split, Workspace<T>& workspace, Load load, Store store)
+    {
+        // Element n1 * columns + n2 of the input lives in row n1, column n2 of a matrix
+        const auto rows = split.rows;
+        const auto columns = split.columns;
+        T* matrix = workspace.dataComplex.data();
         
-        const double factor = 1.0 / size;
-        std::transform(dataComplex.begin(), dataComplex.end(), dataComplex.begin(), [&](const double& x){ return x * factor; });
+        // Transform the columns, multiply them with the twiddles and store them transposed
+        workers->parallelFor((columns + columnBlockSize - 1) / columnBlockSize, [&](size_t thread, size_t begin, size_t end)
+        {
+            const auto stride = getColumnStride(rows);
+            T* buffers = workspace.columns.data() + thread * columnBlockSize * stride;
+            
+            for (auto block = begin; block < end; ++block)
+            {
+                const auto first = block * columnBlockSize;
+                const auto width = min(columnBlockSize, columns - first);
+                
+                // Gather a block of columns row by row, so that the input is read contiguously
+                for (size_t n1 = 0; n1 < rows; ++n1)
+                    for (size_t j = 0; j < width; ++j)
+                        load(n1 * columns + first + j, buffers[j * stride + n1 * 2], buffers[j * stride + n1 * 2 + 1]);
+                
+                for (size_t j = 0; j < width; ++j)
+                    cdft(static_cast<int>(rows * 2), -1, buffers + j * stride, getTable(split.columnTables->ip), getTable(split.columnTables->w));
+                
+                // Multiply bin k1 of column n2 with exp(-2 * pi * i * n2 * k1 / size), with n2 * k1 = q * columns + r
+                for (size_t k1 = 0; k1 < rows; ++k1)
+                {
+                    T* y = matrix + (k1 * columns + first) * 2;
+                    for (size_t j = 0; j < width; ++j)
+                    {
+                        const auto m = (first + j) * k1;
+                        const T* coarse = &split.coarseTwiddles[(m >> split.columnShift) * 2];
+                        const T* fine = &split.fineTwiddles[(m & (columns - 1)) * 2];
+                        const T wr = coarse[0] * fine[0] - coarse[1] * fine[1];
+                        const T wi = coarse[0] * fine[1] + coarse[1] * fine[0];
+                        
+                        const T xr = buffers[j * stride + k1 * 2];
+                        const T xi = buffers[j * stride + k1 * 2 + 1];
+                        y[j * 2] = xr * wr - xi * wi;
+                        y[j * 2 + 1] = xr * wi + xi * wr;
+                    }
+                }
+            }
+        });
         
-        math::deinterleave(dataComplex.begin(), dataComplex.end(), outReal, outImaginary);
-        std::transform(outReal, outReal + size, outReal, std::negate<>());
+        // Transform the rows in place, bin k2 of row k1 is output bin k1 + rows * k2
+        workers->parallelFor((rows + columnBlockSize - 1) / columnBlockSize, [&](size_t, size_t begin, size_t end)
+        {
+            for (auto block = begin; block < end; ++block)
+            {
+                const auto first = block * columnBlockSize;
+                const auto height = min(columnBlockSize, rows - first);
+                
+                for (size_t j = 0; j < height; ++j)
+                    cdft(static_cast<int>(columns * 2), -1, matrix + (first + j) * columns * 2, getTable(split.rowTables->ip), getTable(split.rowTables->w));
+                
+                for (size_t k2 = 0; k2 < columns; ++k2)
+                    for (size_t j = 0; j < height; ++j)
+                        store(first + j + rows * k2, matrix[((first + j) * columns + k2) * 2], matrix[((first + j) * columns + k2) * 2 + 1]);
+            }
+        });
     }
 }
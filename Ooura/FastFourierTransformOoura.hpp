@@ -29,6 +29,7 @@
 #define GRIZZLY_FAST_FOURIER_TRANSFORM_OOURA_HPP
 
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "../FastFourierTransformBase.hpp"
@@ -39,12 +40,24 @@ namespace dsp
     class FastFourierTransformOoura : public FastFourierTransformBase
     {
     public:
-        FastFourierTransformOoura(std::size_t size);
+        //! The precision in which the float overloads are computed
+        /*! DOUBLE widens the input to double, transforms it and narrows the result back, as this class always did.
+            SINGLE runs Ooura's split-radix kernels natively on float data and tables, which is somewhat faster but
+            loses accuracy, so it has to be asked for. */
+        enum class FloatPrecision { SINGLE, DOUBLE };
+        
+    public:
+        FastFourierTransformOoura(std::size_t size, FloatPrecision floatPrecision = FloatPrecision::DOUBLE);
+        
+        //! Stop the worker threads
+        ~FastFourierTransformOoura();
     
         using FastFourierTransformBase::forward;
         using FastFourierTransformBase::inverse;
         using FastFourierTransformBase::forwardComplex;
         using FastFourierTransformBase::inverseComplex;
+        using FastFourierTransformBase::forwardPacked;
+        using FastFourierTransformBase::inversePacked;
     
         void forward(const float* input, float* real, float* imaginary) override final;
         void forward(const double* input, double* real, double* imaginary) override final;
@@ -58,12 +71,166 @@ namespace dsp
         void inverseComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary) override final;
         void inverseComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary) override final;
         
+        //! Packed spectra are Ooura's native layout, so these run rdft in place on the output, without split copies
+        void forwardPacked(const float* input, float* packed) override final;
+        void forwardPacked(const double* input, double* packed) override final;
+        
+        void inversePacked(const float* packed, float* output) override final;
+        void inversePacked(const double* packed, double* output) override final;
+        
+        //! Return the precision in which the float overloads are computed
+        FloatPrecision getFloatPrecision() const { return floatPrecision; }
+        
+        //! Set the number of threads large transforms are spread over
+        /*! Transforms of at least the threading threshold are split four-step style into rows and columns of smaller
+            transforms, which are divided among the threads. With a single thread (the default), Ooura's routines are
+            always used directly. This allocates the buffers of the threaded transforms, and starts the worker threads
+            that persist until the next call (or the destruction of the transform).
+            @param threadCount: The number of threads, or 0 for as many as the hardware supports */
+        void setThreadCount(std::size_t threadCount);
+        
+        //! Return the number of threads large transforms are spread over
+        std::size_t getThreadCount() const { return threadCount; }
+        
+        //! Set the size from which transforms are spread over multiple threads (at least 16)
+        /*! This allocates the buffers of the threaded transforms */
+        void setThreadingThreshold(std::size_t threadingThreshold);
+        
+        //! Return the size from which transforms are spread over multiple threads
+        std::size_t getThreadingThreshold() const { return threadingThreshold; }
+        
+        //! Return whether the transforms of this size are spread over multiple threads
+        bool isThreaded() const { return threadCount > 1 && size >= threadingThreshold; }
+        
+    private:
+        //! Threads that wait for parts of a threaded transform, so that no thread is created per transform
+        class WorkerPool;
+        
+        //! Bit-reversal and cos/sin tables for one precision, shared through FastFourierTransformPlanCache
+        /*! The tables are initialized up front for both the real and the complex transform, so that Ooura's
+            routines only ever read them */
+        template <typename T>
+        struct Tables
+        {
+            Tables(std::size_t size);
+            
+            std::vector<int> ip;
+            std::vector<T> w;
+        };
+        
+        //! Split of a complex transform into rows * columns = size smaller ones, for the four-step algorithm
+        template <typename T>
+        struct Split
+        {
+            Split(std::size_t size);
+            
+            std::size_t rows = 0;
+            std::size_t columns = 0;
+            
+            //! The base 2 logarithm of columns
+            std::size_t columnShift = 0;
+            
+            //! The tables for the transforms of the columns (of size rows) and of the rows (of size columns)
+            std::shared_ptr<const Tables<T>> columnTables;
+            std::shared_ptr<const Tables<T>> rowTables;
+            
+            //! Interleaved exp(-2 * pi * i * r / size) for r < columns, and exp(-2 * pi * i * q * columns / size) for q < rows
+            /*! Their products form the twiddles between the two steps, exp(-2 * pi * i * (q * columns + r) / size) */
+            std::vector<T> fineTwiddles;
+            std::vector<T> coarseTwiddles;
+        };
+        
+        //! Tables for the threaded transforms of one precision, shared through FastFourierTransformPlanCache
+        template <typename T>
+        struct ThreadedTables
+        {
+            ThreadedTables(std::size_t size);
+            
+            //! The split of the complex transform
+            Split<T> complexSplit;
+            
+            //! The split of the complex transform of half the size, the real transforms are computed with
+            Split<T> halfSplit;
+            
+            //! Interleaved exp(-2 * pi * i * k / size), for k < size / 2, to untangle the real transforms
+            std::vector<T> realTwiddles;
+        };
+        
+        //! Work buffers and tables for one precision
+        template <typename T>
+        struct Workspace
+        {
+            Workspace(std::size_t size);
+            
+            std::vector<T> data;
+            std::vector<T> dataComplex;
+            std::shared_ptr<const Tables<T>> tables;
+            
+            //! The tables of the threaded transforms, and a buffer holding a block of columns per thread (empty when not threaded)
+            std::shared_ptr<const ThreadedTables<T>> threadedTables;
+            std::vector<T> columns;
+        };
+        
+        template <typename T, typename U>
+        void forwardReal(const T* input, T* real, T* imaginary, Workspace<U>& workspace);
+        
+        template <typename T, typename U>
+        void inverseReal(const T* real, const T* imaginary, T* output, Workspace<U>& workspace);
+        
+        template <typename T, typename U>
+        void transformComplex(const T* inReal, const T* inImaginary, T* outReal, T* outImaginary, int direction, Workspace<U>& workspace);
+        
+        template <typename T, typename U>
+        void forwardPackedReal(const T* input, T* packed, Workspace<U>& workspace);
+        
+        template <typename T>
+        void forwardPackedReal(const T* input, T* packed, Workspace<T>& workspace);
+        
+        template <typename T, typename U>
+        void inversePackedReal(const T* packed, T* output, Workspace<U>& workspace);
+        
+        template <typename T>
+        void inversePackedReal(const T* packed, T* output, Workspace<T>& workspace);
+        
+        template <typename T, typename U>
+        void forwardRealThreaded(const T* input, T* real, T* imaginary, Workspace<U>& workspace);
+        
+        template <typename T, typename U>
+        void inverseRealThreaded(const T* real, const T* imaginary, T* output, Workspace<U>& workspace);
+        
+        template <typename T, typename U>
+        void transformComplexThreaded(const T* inReal, const T* inImaginary, T* outReal, T* outImaginary, int direction, Workspace<U>& workspace);
+        
+        //! Forward complex transform with the four-step algorithm, spread over the threads
+        /*! @param load: Called as load(n, real, imaginary) to read input element n
+            @param store: Called as store(k, real, imaginary) to write output bin k */
+        template <typename T, typename Load, typename Store>
+        void transformSplit(const Split<T>& split, Workspace<T>& workspace, Load load, Store store);
+        
+        //! Allocate or release the buffers of the threaded transforms
+        void updateThreading();
+        
+        template <typename T>
+        void updateThreading(Workspace<T>& workspace);
+        
     private:
-        std::vector<double> data;
-        std::vector<int> ip;
-        std::vector<double> w;
+        //! The precision in which the float overloads are computed
+        FloatPrecision floatPrecision = FloatPrecision::DOUBLE;
+        
+        //! Buffers and tables used by the double overloads (and by the float overloads in double precision)
+        Workspace<double> doubleWorkspace;
+        
+        //! Buffers and tables used by the float overloads in single precision (empty otherwise)
+        Workspace<float> floatWorkspace;
+        
+        //! The number of threads large transforms are spread over
+        std::size_t threadCount = 1;
+        
+        //! The size from which transforms are spread over multiple threads
+        std::size_t threadingThreshold = 1 << 18;
         
-        std::vector<double> dataComplex;
+        //! The threads helping the calling one with threaded transforms (none when not threaded)
+        std::unique_ptr<WorkerPool> workers;
     };
 }
 
@@ -0,0 +1,78 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_TRIGONOMETRIC_TABLES_OOURA_HPP
+#define GRIZZLY_TRIGONOMETRIC_TABLES_OOURA_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "fftsg.h"
+
+namespace dsp
+{
+    //! Ooura's bit-reversal and cos/sin tables for the cosine and sine transforms of a given size
+    /*! The tables are initialized up front to the sizes ddct and ddst would generate lazily, so that those routines
+        (and cdft for half the size) only ever read them. Share them through FastFourierTransformPlanCache. The
+        type IV transforms are computed with a complex transform of half the size, twiddled before and after. */
+    template <typename T>
+    struct TrigonometricTablesOoura
+    {
+        TrigonometricTablesOoura(std::size_t size) :
+            ip(static_cast<std::size_t>(2 + std::sqrt(size))),
+            w(std::max<std::size_t>(size / 4, 1) + size),
+            preTwiddles(size / 2 * 2),
+            postTwiddles(size / 2 * 2)
+        {
+            const auto nw = std::max<int>(static_cast<int>(size / 4), 1);
+            makewt(nw, ip.data(), w.data());
+            makect(static_cast<int>(size), ip.data(), w.data() + nw);
+            
+            for (std::size_t n = 0; n < size / 2; ++n)
+            {
+                const auto preAngle = -std::acos(-1.l) * (n + 0.25l) / size;
+                preTwiddles[n * 2] = static_cast<T>(std::cos(preAngle));
+                preTwiddles[n * 2 + 1] = static_cast<T>(std::sin(preAngle));
+                
+                const auto postAngle = -std::acos(-1.l) * n / size;
+                postTwiddles[n * 2] = static_cast<T>(std::cos(postAngle));
+                postTwiddles[n * 2 + 1] = static_cast<T>(std::sin(postAngle));
+            }
+        }
+        
+        std::vector<int> ip;
+        std::vector<T> w;
+        
+        //! Interleaved exp(-pi * i * (n + 1/4) / size) and exp(-pi * i * k / size), for n, k < size / 2
+        std::vector<T> preTwiddles;
+        std::vector<T> postTwiddles;
+    };
+}
+
+#endif /* GRIZZLY_TRIGONOMETRIC_TABLES_OOURA_HPP */
@@ -32,6 +32,20 @@
  
  */
 
+#include <math.h>
+
+#ifdef USE_CDFT_PTHREADS
+    #include <pthread.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+#endif
+
+#ifdef USE_CDFT_WINTHREADS
+    #include <windows.h>
+    #include <stdio.h>
+    #include <stdlib.h>
+#endif
+
 namespace dsp
 {
     void cdft(int n, int isgn, double *a, int *ip, double *w)
@@ -390,8 +404,6 @@ namespace dsp
     /* -------- initializing routines -------- */
 
 
-    #include <math.h>
-
     void makewt(int nw, int *ip, double *w)
     {
         void makeipt(int nw, int *ip);
@@ -503,9 +515,6 @@ namespace dsp
     #ifndef CDFT_4THREADS_BEGIN_N
     #define CDFT_4THREADS_BEGIN_N 65536
     #endif
-    #include <pthread.h>
-    #include <stdio.h>
-    #include <stdlib.h>
     #define cdft_thread_t pthread_t
     #define cdft_thread_create(thp,func,argp) { \
         if (pthread_create(thp, NULL, func, (void *) argp) != 0) { \
@@ -530,9 +539,6 @@ namespace dsp
     #ifndef CDFT_4THREADS_BEGIN_N
     #define CDFT_4THREADS_BEGIN_N 524288
     #endif
-    #include <windows.h>
-    #include <stdio.h>
-    #include <stdlib.h>
     #define cdft_thread_t HANDLE
     #define cdft_thread_create(thp,func,argp) { \
         DWORD thid; \
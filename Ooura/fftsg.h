@@ -326,6 +326,18 @@ namespace dsp
     void ddst(int, int, double *, int *, double *);
     void dfct(int, double *, double *, int *, double *);
     void dfst(int, double *, double *, int *, double *);
+    void makewt(int, int *, double *);
+    void makect(int, int *, double *);
+    
+    // Single-precision variants, see fftsgf.cpp
+    void cdft(int, int, float *, int *, float *);
+    void rdft(int, int, float *, int *, float *);
+    void ddct(int, int, float *, int *, float *);
+    void ddst(int, int, float *, int *, float *);
+    void dfct(int, float *, float *, int *, float *);
+    void dfst(int, float *, float *, int *, float *);
+    void makewt(int, int *, float *);
+    void makect(int, int *, float *);
 }
 
 #endif
@@ -0,0 +1,146 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_PACKED_SPECTRUM_HPP
+#define GRIZZLY_PACKED_SPECTRUM_HPP
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace dsp
+{
+    //! Spectrum of a real signal, packed into as many values as the signal has samples
+    /*! This is the layout Ooura's rdft works in, so that backend can transform to and from it in place:
+        - data[0] holds the real DC bin, data[1] the real Nyquist bin
+        - data[2k] and data[2k + 1] hold the real part and the negated imaginary part of bin k, for 0 < k < size / 2
+        Because each bin is stored conjugated, packed spectra can be multiplied and accumulated with the functions below
+        as if they weren't. Use getBin() and setBin() to access the actual bins. The signal size should be even. */
+    template <class T>
+    class PackedSpectrum
+    {
+    public:
+        using Bin = std::complex<T>;
+        
+    public:
+        //! Default constructor
+        PackedSpectrum() = default;
+        
+        //! Construct a zeroed spectrum for a signal of a given size
+        PackedSpectrum(std::size_t size) :
+            data(size)
+        {
+            
+        }
+        
+        //! Return a single bin, for 0 <= index <= size / 2
+        Bin getBin(std::size_t index) const
+        {
+            if (index == 0)
+                return data[0];
+            
+            if (index * 2 == data.size())
+                return data[1];
+            
+            return {data[index * 2], -data[index * 2 + 1]};
+        }
+        
+        //! Change a single bin, for 0 <= index <= size / 2 (the imaginary part of DC and Nyquist is dropped)
+        void setBin(std::size_t index, const Bin& bin)
+        {
+            if (index == 0)
+            {
+                data[0] = bin.real();
+            } else if (index * 2 == data.size()) {
+                data[1] = bin.real();
+            } else {
+                data[index * 2] = bin.real();
+                data[index * 2 + 1] = -bin.imag();
+            }
+        }
+        
+        //! Return the size of the signal this is the spectrum of
+        std::size_t size() const { return data.size(); }
+        
+        //! Return the number of bins, size / 2 + 1
+        std::size_t getBinCount() const { return data.size() / 2 + 1; }
+        
+    public:
+        //! The packed bins
+        std::vector<T> data;
+    };
+    
+    //! Multiply two packed spectra bin by bin, which convolves the signals they're the spectra of
+    /*! @param size: The size of the signals (the number of values in each packed spectrum)
+        @note: The output may point to one of the inputs */
+    template <class T>
+    void multiplyPacked(const T* lhs, const T* rhs, T* output, std::size_t size)
+    {
+        output[0] = lhs[0] * rhs[0];
+        output[1] = lhs[1] * rhs[1];
+        
+        for (std::size_t i = 2; i < size; i += 2)
+        {
+            const auto real = lhs[i] * rhs[i] - lhs[i + 1] * rhs[i + 1];
+            const auto imaginary = lhs[i] * rhs[i + 1] + lhs[i + 1] * rhs[i];
+            
+            output[i] = real;
+            output[i + 1] = imaginary;
+        }
+    }
+    
+    //! Multiply two packed spectra bin by bin, and add the result to a third one
+    /*! @param size: The size of the signals (the number of values in each packed spectrum) */
+    template <class T>
+    void multiplyAccumulatePacked(const T* lhs, const T* rhs, T* accumulator, std::size_t size)
+    {
+        accumulator[0] += lhs[0] * rhs[0];
+        accumulator[1] += lhs[1] * rhs[1];
+        
+        for (std::size_t i = 2; i < size; i += 2)
+        {
+            accumulator[i] += lhs[i] * rhs[i] - lhs[i + 1] * rhs[i + 1];
+            accumulator[i + 1] += lhs[i] * rhs[i + 1] + lhs[i + 1] * rhs[i];
+        }
+    }
+    
+    //! Multiply two packed spectra bin by bin
+    template <class T>
+    void multiply(const PackedSpectrum<T>& lhs, const PackedSpectrum<T>& rhs, PackedSpectrum<T>& output)
+    {
+        multiplyPacked(lhs.data.data(), rhs.data.data(), output.data.data(), output.size());
+    }
+    
+    //! Multiply two packed spectra bin by bin, and add the result to a third one
+    template <class T>
+    void multiplyAccumulate(const PackedSpectrum<T>& lhs, const PackedSpectrum<T>& rhs, PackedSpectrum<T>& accumulator)
+    {
+        multiplyAccumulatePacked(lhs.data.data(), rhs.data.data(), accumulator.data.data(), accumulator.size());
+    }
+}
+
+#endif /* GRIZZLY_PACKED_SPECTRUM_HPP */
@@ -0,0 +1,440 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_PHASE_VOCODER_HPP
+#define GRIZZLY_PHASE_VOCODER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <dsperados/math/constants.hpp>
+
+#include "FastFourierTransform.hpp"
+#include "SplitSpectrum.hpp"
+#include "Window.hpp"
+
+namespace dsp
+{
+    //! Streaming phase vocoder for time-stretching and pitch-shifting
+    /*! Frames of frameSize samples are Hann windowed and transformed every analysis hop, and resynthesized by weighted
+        overlap-add every (fixed) synthesis hop. Stretching time changes the analysis hop, shifting pitch moves the
+        spectral peaks to other bins with their regions of influence (Laroche and Dolson), scaling their frequencies.
+        
+        With phase locking on, only the phases of the peaks are propagated, the bins around them keep their phase
+        relation to the peak (identity phase locking), which keeps partials coherent. Frames in which the high-frequency
+        weighted energy rises more than the transient threshold take the analysis phases as they are, keeping attacks
+        sharp instead of smearing them.
+        
+        Samples are pushed with write() and the result is pulled with read(). All state lives in flat per-bin arrays
+        allocated at construction. Following the pattern below, with blocks up to maximumBlockSize, nothing is allocated
+        while processing:
+        
+            while (vocoder.getAvailable() < count)
+            {
+                const auto required = vocoder.getSamplesRequired();
+                vocoder.write(input, required);
+                input += required;
+            }
+            
+            vocoder.read(output, count); */
+    template <typename T>
+    class PhaseVocoder
+    {
+    public:
+        //! Construct the vocoder
+        /*! @param frameSize: The number of samples in each frame, a power of two for the fastest transforms
+            @param hopSize: The number of output samples between two frames, at most frameSize / 2 for an unmodulated Hann overlap
+            @param maximumBlockSize: The largest number of samples read at once, to size the output queue for. Writing
+                                     further ahead of reading still works, but grows the queue. */
+        PhaseVocoder(std::size_t frameSize, std::size_t hopSize, std::size_t maximumBlockSize = 4096) :
+            fourier(createFastFourierTransform(frameSize)),
+            window(createHanningWindow<T>(frameSize)),
+            synthesisWindow(createSynthesisWindow(window, checkHopSize(frameSize, hopSize))),
+            input(frameSize),
+            frame(frameSize),
+            accumulator(frameSize),
+            real(frameSize / 2 + 1),
+            imaginary(frameSize / 2 + 1),
+            magnitudes(frameSize / 2 + 1),
+            phases(frameSize / 2 + 1),
+            frequencies(frameSize / 2 + 1),
+            previousMagnitudes(frameSize / 2 + 1),
+            previousPhases(frameSize / 2 + 1),
+            synthesisMagnitudes(frameSize / 2 + 1),
+            synthesisPhases(frameSize / 2 + 1),
+            frameSize(frameSize),
+            hopSize(hopSize),
+            analysisHopSize(hopSize)
+        {
+            peaks.reserve(frameSize / 2 + 1);
+            output.resize(maximumBlockSize + frameSize);
+        }
+        
+        //! Change the time-stretch factor, the output duration divided by the input duration
+        /*! The analysis hop is rounded to whole samples, see getTimeStretch() for the actual factor */
+        void setTimeStretch(double factor)
+        {
+            if (!(factor > 0))
+                throw std::invalid_argument("PhaseVocoder time-stretch factor should be positive");
+            
+            analysisHopSize = std::max<std::size_t>(std::lround(hopSize / factor), 1);
+        }
+        
+        //! Return the actual time-stretch factor
+        double getTimeStretch() const { return static_cast<double>(hopSize) / analysisHopSize; }
+        
+        //! Change the pitch-shift factor, the output frequency divided by the input frequency
+        void setPitchShift(double factor)
+        {
+            if (!(factor > 0))
+                throw std::invalid_argument("PhaseVocoder pitch-shift factor should be positive");
+            
+            pitchShift = factor;
+        }
+        
+        //! Return the pitch-shift factor
+        double getPitchShift() const { return pitchShift; }
+        
+        //! Turn phase locking on or off (on by default)
+        void setPhaseLocking(bool enabled) { phaseLocking = enabled; }
+        
+        //! Change the transient threshold (2 by default), the relative rise in weighted energy that resets the phases
+        /*! A threshold of zero turns transient detection off */
+        void setTransientThreshold(T threshold) { transientThreshold = threshold; }
+        
+        //! Return the number of samples to write for the next frame to be processed
+        std::size_t getSamplesRequired() const { return skip + frameSize - filled; }
+        
+        //! Push samples, processing every frame they complete
+        void write(const T* samples, std::size_t count)
+        {
+            while (count > 0)
+            {
+                // Drop input between frames that lie further apart than a frame size
+                const auto skipped = std::min(skip, count);
+                samples += skipped;
+                count -= skipped;
+                skip -= skipped;
+                
+                const auto copied = std::min(frameSize - filled, count);
+                std::copy(samples, samples + copied, input.begin() + filled);
+                samples += copied;
+                count -= copied;
+                filled += copied;
+                
+                if (filled == frameSize)
+                    processFrame();
+            }
+        }
+        
+        //! Pull processed samples
+        /*! @return: The number of samples read, at most getAvailable() */
+        std::size_t read(T* samples, std::size_t count)
+        {
+            // The unread samples may wrap around the end of the queue
+            count = std::min(count, available);
+            const auto head = std::min(count, output.size() - outputPosition);
+            std::copy(output.begin() + outputPosition, output.begin() + outputPosition + head, samples);
+            std::copy(output.begin(), output.begin() + (count - head), samples + head);
+            
+            outputPosition = (outputPosition + count) % output.size();
+            available -= count;
+            
+            return count;
+        }
+        
+        //! Return the number of processed samples ready to be read
+        std::size_t getAvailable() const { return available; }
+        
+        //! Return whether the last processed frame was detected as a transient
+        bool isTransient() const { return transient; }
+        
+        //! Clear all state, as if nothing was written yet
+        void reset()
+        {
+            std::fill(accumulator.begin(), accumulator.end(), 0);
+            std::fill(previousMagnitudes.begin(), previousMagnitudes.end(), 0);
+            std::fill(previousPhases.begin(), previousPhases.end(), 0);
+            std::fill(synthesisPhases.begin(), synthesisPhases.end(), 0);
+            outputPosition = 0;
+            available = 0;
+            filled = 0;
+            skip = 0;
+            first = true;
+            transient = false;
+        }
+        
+        //! Return the number of samples in each frame
+        std::size_t getFrameSize() const { return frameSize; }
+        
+        //! Return the number of output samples between two frames
+        std::size_t getHopSize() const { return hopSize; }
+        
+        //! Return the number of input samples between two frames
+        std::size_t getAnalysisHopSize() const { return analysisHopSize; }
+        
+    private:
+        //! Throw if the frame and hop size can't be used
+        static std::size_t checkHopSize(std::size_t frameSize, std::size_t hopSize)
+        {
+            if (frameSize < 4)
+                throw std::invalid_argument("PhaseVocoder frame size should be at least 4");
+            
+            if (hopSize == 0 || hopSize > frameSize / 2)
+                throw std::invalid_argument("PhaseVocoder hop size should be between 1 and half the frame size");
+            
+            return hopSize;
+        }
+        
+        //! Wrap a phase to [-pi, pi]
+        static T wrap(T phase)
+        {
+            return phase - math::TWO_PI<T> * std::floor(phase / math::TWO_PI<T> + T(0.5));
+        }
+        
+        //! Transform the input frame, modify it and overlap-add it to the output
+        void processFrame()
+        {
+            const auto binCount = frameSize / 2 + 1;
+            
+            // Analysis
+            for (std::size_t n = 0; n < frameSize; ++n)
+                frame[n] = input[n] * window[n];
+            
+            fourier->forward(frame.data(), real.data(), imaginary.data());
+            computeMagnitudes(real.data(), imaginary.data(), magnitudes.data(), binCount);
+            computePhases(real.data(), imaginary.data(), phases.data(), binCount);
+            
+            detectTransient();
+            
+            // The instantaneous frequency of each bin, in radians per sample, from its phase advance over the last hop
+            for (std::size_t k = 0; k < binCount; ++k)
+            {
+                const T expected = math::TWO_PI<T> * k / frameSize;
+                frequencies[k] = expected + wrap(phases[k] - previousPhases[k] - expected * previousHopSize) / previousHopSize;
+            }
+            
+            findPeaks();
+            
+            // Move every peak with its region to its shifted bin, advancing its phase by the synthesis hop
+            const auto reset = first || transient;
+            std::fill(synthesisMagnitudes.begin(), synthesisMagnitudes.end(), 0);
+            for (std::size_t i = 0; i < peaks.size(); ++i)
+            {
+                const auto peak = peaks[i];
+                const auto target = static_cast<std::size_t>(std::lround(peak * pitchShift));
+                if (target >= binCount)
+                    break;
+                
+                const T peakPhase = reset ? phases[peak] : wrap(synthesisPhases[target] + hopSize * frequencies[peak] * T(pitchShift));
+                
+                // The region reaches halfway to the neighbouring peaks
+                const auto begin = (i == 0) ? 0 : (peaks[i - 1] + peak + 1) / 2;
+                const auto end = (i + 1 == peaks.size()) ? binCount : (peak + peaks[i + 1] + 1) / 2;
+                for (auto k = begin; k < end; ++k)
+                {
+                    const auto shifted = static_cast<std::ptrdiff_t>(k + target) - static_cast<std::ptrdiff_t>(peak);
+                    if (shifted < 0 || shifted >= static_cast<std::ptrdiff_t>(binCount))
+                        continue;
+                    
+                    synthesisMagnitudes[shifted] += magnitudes[k];
+                    synthesisPhases[shifted] = (k == peak) ? peakPhase : wrap(peakPhase + phases[k] - phases[peak]);
+                }
+            }
+            
+            // Synthesis
+            polarToCartesian(synthesisMagnitudes.data(), synthesisPhases.data(), real.data(), imaginary.data(), binCount);
+            fourier->inverse(real.data(), imaginary.data(), frame.data());
+            
+            for (std::size_t n = 0; n < frameSize; ++n)
+                accumulator[n] += frame[n] * synthesisWindow[n];
+            
+            // The first hop of the accumulator has received all frames that overlap it
+            enqueue(accumulator.data(), hopSize);
+            std::copy(accumulator.begin() + hopSize, accumulator.end(), accumulator.begin());
+            std::fill(accumulator.end() - hopSize, accumulator.end(), 0);
+            
+            // Move on by the analysis hop
+            if (analysisHopSize < frameSize)
+            {
+                std::copy(input.begin() + analysisHopSize, input.end(), input.begin());
+                filled = frameSize - analysisHopSize;
+            } else {
+                filled = 0;
+                skip = analysisHopSize - frameSize;
+            }
+            
+            std::swap(magnitudes, previousMagnitudes);
+            std::swap(phases, previousPhases);
+            previousHopSize = analysisHopSize;
+            first = false;
+        }
+        
+        //! Append samples to the output queue
+        void enqueue(const T* samples, std::size_t count)
+        {
+            // Only when more is written ahead of reading than the queue was sized for, move it into a larger one
+            if (available + count > output.size())
+            {
+                std::vector<T> larger(std::max(output.size() * 2, available + count));
+                const auto unread = read(larger.data(), available);
+                output.swap(larger);
+                outputPosition = 0;
+                available = unread;
+            }
+            
+            const auto position = (outputPosition + available) % output.size();
+            const auto head = std::min(count, output.size() - position);
+            std::copy(samples, samples + head, output.begin() + position);
+            std::copy(samples + head, samples + count, output.begin());
+            available += count;
+        }
+        
+        //! Compare the high-frequency weighted energy with that of the previous frame
+        void detectTransient()
+        {
+            transient = false;
+            if (first || transientThreshold <= 0)
+                return;
+            
+            T rise = 0;
+            T energy = 0;
+            for (std::size_t k = 1; k < magnitudes.size(); ++k)
+            {
+                const T power = magnitudes[k] * magnitudes[k];
+                const T previousPower = previousMagnitudes[k] * previousMagnitudes[k];
+                rise += k * std::max<T>(power - previousPower, 0);
+                energy += k * previousPower;
+            }
+            
+            transient = rise > transientThreshold * energy && rise > std::numeric_limits<T>::min();
+        }
+        
+        //! Collect the local maxima of the magnitudes, or all bins without phase locking
+        void findPeaks()
+        {
+            peaks.clear();
+            const auto binCount = magnitudes.size();
+            for (std::size_t k = 0; k < binCount; ++k)
+            {
+                const auto isPeak = !phaseLocking ||
+                    ((k == 0 || magnitudes[k] > magnitudes[k - 1]) && (k + 1 == binCount || magnitudes[k] >= magnitudes[k + 1]));
+                
+                if (isPeak)
+                    peaks.emplace_back(k);
+            }
+        }
+        
+    private:
+        //! The Fourier transform
+        std::unique_ptr<FastFourierTransformBase> fourier;
+        
+        //! The analysis window
+        std::vector<T> window;
+        
+        //! The synthesis window, normalizing the overlap-add
+        std::vector<T> synthesisWindow;
+        
+        //! The input samples of the next frame
+        std::vector<T> input;
+        
+        //! The windowed frame, and its resynthesis
+        std::vector<T> frame;
+        
+        //! The overlap-add accumulator
+        std::vector<T> accumulator;
+        
+        //! The ring buffer of processed samples
+        std::vector<T> output;
+        
+        //! The split spectrum of the frame
+        std::vector<T> real;
+        std::vector<T> imaginary;
+        
+        //! The polar spectrum of the frame, and its instantaneous frequencies
+        std::vector<T> magnitudes;
+        std::vector<T> phases;
+        std::vector<T> frequencies;
+        
+        //! The polar spectrum of the previous frame
+        std::vector<T> previousMagnitudes;
+        std::vector<T> previousPhases;
+        
+        //! The modified spectrum, of which the phases accumulate from frame to frame
+        std::vector<T> synthesisMagnitudes;
+        std::vector<T> synthesisPhases;
+        
+        //! The bins of the peaks in the current frame
+        std::vector<std::size_t> peaks;
+        
+        //! The number of samples in each frame
+        std::size_t frameSize = 0;
+        
+        //! The number of output samples between two frames
+        std::size_t hopSize = 0;
+        
+        //! The number of input samples between two frames
+        std::size_t analysisHopSize = 0;
+        
+        //! The analysis hop between the previous frame and the current one
+        std::size_t previousHopSize = 1;
+        
+        //! The number of samples in the input frame
+        std::size_t filled = 0;
+        
+        //! The number of input samples to drop before the next frame
+        std::size_t skip = 0;
+        
+        //! The position of the first unread sample in the output queue
+        std::size_t outputPosition = 0;
+        
+        //! The number of unread samples in the output queue
+        std::size_t available = 0;
+        
+        //! The pitch-shift factor
+        double pitchShift = 1;
+        
+        //! The relative energy rise above which a frame is a transient
+        T transientThreshold = 2;
+        
+        //! Whether the phases of bins around a peak are locked to it
+        bool phaseLocking = true;
+        
+        //! Whether no frame has been processed yet
+        bool first = true;
+        
+        //! Whether the last frame was a transient
+        bool transient = false;
+    };
+}
+
+#endif /* GRIZZLY_PHASE_VOCODER_HPP */
@@ -28,54 +28,247 @@
 #ifndef GRIZZLY_SHORT_TIME_FOURIER_TRANSFORM_HPP
 #define GRIZZLY_SHORT_TIME_FOURIER_TRANSFORM_HPP
 
+#include <algorithm>
 #include <cstddef>
-#include <cmath>
 #include <complex>
 #include <experimental/optional>
+#include <future>
+#include <limits>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
+#include "FastFourierTransform.hpp"
+#include "Spectrogram.hpp"
 #include "Spectrum.hpp"
 
 namespace dsp
 {
-    class FastFourierTransformBase;
+    //! Cut out one frame of the short-time Fourier transform, window it and transform it
+    /*! Frames running past the end of the signal are zero-padded.
+        @param index: The index of the frame, which starts index * hopSize samples into the signal
+        @param frame: A buffer of the frame size, to cut the frame into
+        @param output: The frameSize / 2 + 1 bins of the frame are written here */
+    template <typename InputIterator, typename WindowIterator, typename ComplexOutputIterator>
+    void transformFrame(std::size_t index, InputIterator begin, InputIterator end, FastFourierTransformBase& fourier, const std::experimental::optional<WindowIterator>& windowBegin, std::size_t hopSize, float* frame, ComplexOutputIterator output)
+    {
+        const auto frameSize = fourier.getSize();
+        const auto size = static_cast<std::size_t>(std::distance(begin, end));
+        
+        // Cut out the frame, zero-padding the last ones
+        const auto i = index * hopSize;
+        const auto it = begin + i;
+        const auto last = std::copy(it, (i + frameSize < size) ? it + frameSize : end, frame);
+        std::fill(last, frame + frameSize, 0.f);
+        
+        // Multiply the frame with the window if we have one
+        if (windowBegin)
+            std::transform(frame, frame + frameSize, *windowBegin, frame, [](const float& lhs, const float& rhs){ return lhs * rhs; });
+        
+        fourier.forward(frame, output);
+    }
+    
+    //! Copy the frames of a spectrogram out as separate spectra
+    template <typename T>
+    std::vector<Spectrum<T>> toSpectra(const Spectrogram<T>& spectrogram)
+    {
+        std::vector<Spectrum<T>> spectra;
+        spectra.reserve(spectrogram.getFrameCount());
+        for (std::size_t f = 0; f < spectrogram.getFrameCount(); ++f)
+            spectra.emplace_back(spectrogram.getSpectrum(f));
+        
+        return spectra;
+    }
+    
+    //! Transform the frames of the short-time Fourier transform over multiple threads, see parallelShortTimeFourierTransform()
+    /*! @param output: Returns the output iterator for the bins of a frame, given its index */
+    template <typename InputIterator, typename WindowIterator, typename FrameOutput>
+    void transformFramesInParallel(std::size_t frameCount, InputIterator begin, InputIterator end, std::size_t frameSize, const std::experimental::optional<WindowIterator>& windowBegin, std::size_t hopSize, std::size_t threadCount, FrameOutput output)
+    {
+        if (threadCount == 0)
+            threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        
+        // Every thread writes its own frames, which never share bins
+        auto transformFrames = [&](std::size_t firstFrame, std::size_t lastFrame)
+        {
+            auto fourier = createFastFourierTransform(frameSize);
+            std::vector<float> frame(frameSize);
+            
+            for (auto f = firstFrame; f < lastFrame; ++f)
+                transformFrame(f, begin, end, *fourier, windowBegin, hopSize, frame.data(), output(f));
+        };
+        
+        // The calling thread takes the first range of frames. The futures of std::async wait for their thread when
+        // destroyed, so the other threads are joined even when something throws.
+        const auto chunk = (frameCount + threadCount - 1) / threadCount;
+        std::vector<std::future<void>> threads;
+        for (std::size_t t = 1; t < threadCount && t * chunk < frameCount; ++t)
+            threads.emplace_back(std::async(std::launch::async, transformFrames, t * chunk, std::min(frameCount, (t + 1) * chunk)));
+        
+        transformFrames(0, std::min(frameCount, chunk));
+        
+        for (auto& thread : threads)
+            thread.get();
+    }
+    
+    //! The short-time Fourier transform, written straight into a spectrogram
+    /*! The spectrogram is resized to one frame per hop and frameSize / 2 + 1 bins, keeping its layout. Its storage is
+        reused when the dimensions don't change, so repeated analyses of equal length don't allocate.
+        @throw std::invalid_argument if the hop size is zero */
+    template <typename InputIterator, typename WindowIterator>
+    void shortTimeFourierTransform(InputIterator begin, InputIterator end, FastFourierTransformBase& fourier, std::experimental::optional<WindowIterator> windowBegin, size_t hopSize, Spectrogram<float>& spectrogram)
+    {
+        if (hopSize == 0)
+            throw std::invalid_argument("hop size should be larger than zero");
+        
+        const auto frameSize = fourier.getSize();
+        const auto size = static_cast<std::size_t>(std::distance(begin, end));
+        const auto frameCount = (size + hopSize - 1) / hopSize;
+        spectrogram.resize(frameCount, frameSize / 2 + 1);
+        
+        std::vector<float> frame(frameSize);
+        for (std::size_t f = 0; f < frameCount; ++f)
+            transformFrame(f, begin, end, fourier, windowBegin, hopSize, frame.data(), spectrogram.getFrame(f).begin());
+    }
+    
+    //! The short-time Fourier transform, written straight into a spectrogram
+    template <typename InputIterator, typename WindowIterator>
+    void shortTimeFourierTransform(InputIterator begin, InputIterator end, std::size_t frameSize, std::experimental::optional<WindowIterator> windowBegin, size_t hopSize, Spectrogram<float>& spectrogram)
+    {
+        auto fft = createFastFourierTransform(frameSize);
+        shortTimeFourierTransform(begin, end, *fft, windowBegin, hopSize, spectrogram);
+    }
     
     //! The short-time Fourier transform
     template <typename InputIterator, typename WindowIterator>
     std::vector<Spectrum<float>> shortTimeFourierTransform(InputIterator begin, InputIterator end, FastFourierTransformBase& fourier, std::experimental::optional<WindowIterator> windowBegin, size_t hopSize)
+    {
+        if (hopSize == 0)
+            throw std::invalid_argument("hop size should be larger than zero");
+        
+        const auto frameSize = fourier.getSize();
+        const auto size = static_cast<std::size_t>(std::distance(begin, end));
+        const auto frameCount = (size + hopSize - 1) / hopSize;
+        std::vector<Spectrum<float>> spectra(frameCount, Spectrum<float>(std::vector<std::complex<float>>(frameSize / 2 + 1)));
+        
+        std::vector<float> frame(frameSize);
+        for (std::size_t f = 0; f < frameCount; ++f)
+            transformFrame(f, begin, end, fourier, windowBegin, hopSize, frame.data(), spectra[f].begin());
+        
+        return spectra;
+    }
+    
+    //! The short-time Fourier transform
+    template <typename InputIterator, typename WindowIterator>
+    std::vector<Spectrum<float>> shortTimeFourierTransform(InputIterator begin, InputIterator end, std::size_t frameSize, std::experimental::optional<WindowIterator> windowBegin, size_t hopSize)
+    {
+        auto fft = createFastFourierTransform(frameSize);
+        return shortTimeFourierTransform(begin, end, *fft, windowBegin, hopSize);
+    }
+    
+    //! The short-time Fourier transform, with the frames divided over multiple threads, written straight into a spectrogram
+    /*! Each thread transforms a contiguous range of frames with its own Fourier transform. The result is identical to
+        the one of shortTimeFourierTransform(). All threads are joined before returning, and an exception thrown by
+        any of them is rethrown to the caller.
+        @param threadCount: The number of threads, or 0 for as many as the hardware supports
+        @throw std::invalid_argument if the hop size is zero */
+    template <typename InputIterator, typename WindowIterator>
+    void parallelShortTimeFourierTransform(InputIterator begin, InputIterator end, std::size_t frameSize, std::experimental::optional<WindowIterator> windowBegin, size_t hopSize, Spectrogram<float>& spectrogram, std::size_t threadCount = 0)
+    {
+        if (hopSize == 0)
+            throw std::invalid_argument("hop size should be larger than zero");
+        
+        const auto size = static_cast<std::size_t>(std::distance(begin, end));
+        const auto frameCount = (size + hopSize - 1) / hopSize;
+        spectrogram.resize(frameCount, frameSize / 2 + 1);
+        
+        transformFramesInParallel(frameCount, begin, end, frameSize, windowBegin, hopSize, threadCount, [&](std::size_t f){ return spectrogram.getFrame(f).begin(); });
+    }
+    
+    //! The short-time Fourier transform, with the frames divided over multiple threads
+    /*! @param threadCount: The number of threads, or 0 for as many as the hardware supports
+        @throw std::invalid_argument if the hop size is zero */
+    template <typename InputIterator, typename WindowIterator>
+    std::vector<Spectrum<float>> parallelShortTimeFourierTransform(InputIterator begin, InputIterator end, std::size_t frameSize, std::experimental::optional<WindowIterator> windowBegin, size_t hopSize, std::size_t threadCount = 0)
+    {
+        if (hopSize == 0)
+            throw std::invalid_argument("hop size should be larger than zero");
+        
+        const auto size = static_cast<std::size_t>(std::distance(begin, end));
+        const auto frameCount = (size + hopSize - 1) / hopSize;
+        std::vector<Spectrum<float>> spectra(frameCount, Spectrum<float>(std::vector<std::complex<float>>(frameSize / 2 + 1)));
+        
+        transformFramesInParallel(frameCount, begin, end, frameSize, windowBegin, hopSize, threadCount, [&](std::size_t f){ return spectra[f].begin(); });
+        return spectra;
+    }
+    
+    //! The inverse short-time Fourier transform, by weighted overlap-add
+    /*! Each frame is inverse transformed, multiplied with the window and added to the others. Every sample is then
+        divided by the sum of the squared windows that overlap it, which reconstructs the signal everywhere the windows
+        aren't zero, edges included. Away from the edges that sum only depends on the position within a hop, so it is
+        only summed frame by frame for the first and last frameSize samples.
+        @param window: The window the spectra were analyzed with, of the frame size (or empty, for no window)
+        @return: The signal, of (spectra.size() - 1) * hopSize + frameSize samples
+        @throw std::invalid_argument if the window isn't as long as a frame, or the hop size is zero */
+    template <typename T>
+    std::vector<T> inverseShortTimeFourierTransform(const std::vector<Spectrum<T>>& spectra, FastFourierTransformBase& fourier, const std::vector<T>& window, std::size_t hopSize)
     {
         const auto frameSize = fourier.getSize();
+        if (hopSize == 0)
+            throw std::invalid_argument("hop size should be larger than zero");
         
-        // Generate space for all spectra
-        const auto size = std::distance(begin, end);
-        std::vector<Spectrum<float>> spectra;
-        spectra.reserve(std::ceil(size / hopSize));
+        if (spectra.empty())
+            return {};
         
-        // Go through all frames
-        for (auto i = 0; i < size; i += hopSize)
+        if (!window.empty() && window.size() != frameSize)
+            throw std::invalid_argument("window should be as long as a frame");
+        
+        const auto weight = [&](std::size_t n) -> T { return window.empty() ? 1 : window[n]; };
+        
+        const auto frameCount = spectra.size();
+        const auto size = (frameCount - 1) * hopSize + frameSize;
+        std::vector<T> output(size, 0);
+        std::vector<T> frame(frameSize);
+        
+        for (std::size_t f = 0; f < frameCount; ++f)
         {
-            // Cut out the frame
-            const auto it = begin + i;
-            std::vector<float> frame(it, (i + frameSize < size) ? it + frameSize : end);
-            frame.resize(frameSize);
+            fourier.inverse(spectra[f].begin(), frame.data());
             
-            // Multiply the frame with the window if we have one
-            if (windowBegin)
-                std::transform(frame.begin(), frame.end(), *windowBegin, frame.begin(), [](const float& lhs, const float& rhs){ return lhs * rhs; });
+            const auto start = f * hopSize;
+            for (std::size_t n = 0; n < frameSize; ++n)
+                output[start + n] += frame[n] * weight(n);
+        }
+        
+        // The sum of the squared windows over a full set of overlapping frames, for each position within a hop
+        std::vector<T> steadyNormalization(hopSize, 0);
+        for (std::size_t n = 0; n < frameSize; ++n)
+            steadyNormalization[n % hopSize] += weight(n) * weight(n);
+        
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            auto normalization = steadyNormalization[i % hopSize];
+            
+            // Near the edges some of the frames are missing, sum the ones that are there
+            if (i < frameSize || i + frameSize >= size)
+            {
+                normalization = 0;
+                const auto lastFrame = std::min(frameCount - 1, i / hopSize);
+                for (auto f = (i >= frameSize) ? (i - frameSize) / hopSize + 1 : 0; f <= lastFrame; ++f)
+                    normalization += weight(i - f * hopSize) * weight(i - f * hopSize);
+            }
             
-            spectra.emplace_back(fourier.forward(frame.data()));
+            output[i] = (normalization > std::numeric_limits<T>::min()) ? output[i] / normalization : 0;
         }
         
-        return spectra;
+        return output;
     }
     
-    //! The short-time Fourier transform
-    template <typename InputIterator, typename WindowIterator>
-    std::vector<Spectrum<float>> shortTimeFourierTransform(InputIterator begin, InputIterator end, std::size_t frameSize, std::experimental::optional<WindowIterator> windowBegin, size_t hopSize)
+    //! The inverse short-time Fourier transform, by weighted overlap-add
+    template <typename T>
+    std::vector<T> inverseShortTimeFourierTransform(const std::vector<Spectrum<T>>& spectra, std::size_t frameSize, const std::vector<T>& window, std::size_t hopSize)
     {
-        FastFourierTransform fft(frameSize);
-        return shortTimeFourierTransform(begin, end, fft, windowBegin, hopSize);
+        auto fft = createFastFourierTransform(frameSize);
+        return inverseShortTimeFourierTransform(spectra, *fft, window, hopSize);
     }
 }
 
@@ -0,0 +1,333 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "../FastFourierTransformPlanCache.hpp"
+#include "FastFourierTransformSimd.hpp"
+#include "FastFourierTransformSimdKernels.hpp"
+
+using namespace std;
+
+namespace dsp
+{
+    //! Return the kernels for an instruction set
+    template <typename T>
+    static const simd::Kernels<T>& getKernels(FastFourierTransformSimd::InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+#ifdef GRIZZLY_SIMD_AVX512
+            case FastFourierTransformSimd::InstructionSet::AVX512: return simd::getAvx512Kernels(T());
+#endif
+#ifdef GRIZZLY_SIMD_AVX2
+            case FastFourierTransformSimd::InstructionSet::AVX2: return simd::getAvx2Kernels(T());
+#endif
+            default: return simd::getGenericKernels(T());
+        }
+    }
+    
+    //! Append the radix-4 stage twiddles of a complex transform to a table
+    template <typename T>
+    static void appendStageTwiddles(size_t size, vector<T>& twiddles)
+    {
+        for (auto length = size; length >= 4; length /= 4)
+        {
+            const auto m = length / 4;
+            const auto offset = twiddles.size();
+            twiddles.resize(offset + m * 6);
+            
+            for (size_t p = 0; p < m; ++p)
+            {
+                for (size_t k = 1; k <= 3; ++k)
+                {
+                    const auto angle = -2 * acos(-1.l) * k * p / length;
+                    twiddles[offset + m * (k - 1) * 2 + p] = static_cast<T>(cos(angle));
+                    twiddles[offset + m * ((k - 1) * 2 + 1) + p] = static_cast<T>(sin(angle));
+                }
+            }
+        }
+    }
+    
+    template <typename T>
+    FastFourierTransformSimd::Tables<T>::Tables(size_t size) :
+        realTwiddles(size / 2 * 2)
+    {
+        appendStageTwiddles(size, complexTwiddles);
+        appendStageTwiddles(size / 2, halfTwiddles);
+        
+        const auto half = size / 2;
+        for (size_t k = 0; k < half; ++k)
+        {
+            const auto angle = -2 * acos(-1.l) * k / size;
+            realTwiddles[k] = static_cast<T>(cos(angle));
+            realTwiddles[half + k] = static_cast<T>(sin(angle));
+        }
+    }
+    
+    FastFourierTransformSimd::FastFourierTransformSimd(size_t size) :
+        FastFourierTransformSimd(size, detectInstructionSet())
+    {
+        
+    }
+    
+    FastFourierTransformSimd::FastFourierTransformSimd(size_t size, InstructionSet instructionSet) :
+        FastFourierTransformBase(size),
+        instructionSet(std::min(instructionSet, detectInstructionSet())),
+        work((size * 4 * sizeof(double) + sizeof(Block) - 1) / sizeof(Block))
+    {
+        if (size < 2 || (size & (size - 1)) != 0)
+            throw invalid_argument("FastFourierTransformSimd size should be a power of two (and at least 2)");
+        
+        floatTables = FastFourierTransformPlanCache<Tables<float>>::get(size);
+        doubleTables = FastFourierTransformPlanCache<Tables<double>>::get(size);
+        floatKernels = &getKernels<float>(this->instructionSet);
+        doubleKernels = &getKernels<double>(this->instructionSet);
+        
+        // Size the batch work buffers for the precision needing the most, so the batched transforms never allocate
+        size_t batchWorkSize = 0;
+        if (useBatchWork<float>(floatKernels->lanes))
+            batchWorkSize = getBatchWorkSize<float>(floatKernels->lanes);
+        if (useBatchWork<double>(doubleKernels->lanes))
+            batchWorkSize = std::max(batchWorkSize, getBatchWorkSize<double>(doubleKernels->lanes));
+        
+        batchWork.resize((batchWorkSize + sizeof(Block) - 1) / sizeof(Block));
+    }
+    
+    FastFourierTransformSimd::InstructionSet FastFourierTransformSimd::detectInstructionSet()
+    {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+    #ifdef GRIZZLY_SIMD_AVX512
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return InstructionSet::AVX512;
+    #endif
+    #ifdef GRIZZLY_SIMD_AVX2
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return InstructionSet::AVX2;
+    #endif
+#endif
+        return InstructionSet::GENERIC;
+    }
+    
+    void FastFourierTransformSimd::forward(const float* input, float* real, float* imaginary)
+    {
+        forwardReal(input, real, imaginary, *floatKernels, *floatTables);
+    }
+    
+    void FastFourierTransformSimd::forward(const double* input, double* real, double* imaginary)
+    {
+        forwardReal(input, real, imaginary, *doubleKernels, *doubleTables);
+    }
+    
+    void FastFourierTransformSimd::inverse(const float* real, const float* imaginary, float* output)
+    {
+        inverseReal(real, imaginary, output, *floatKernels, *floatTables);
+    }
+    
+    void FastFourierTransformSimd::inverse(const double* real, const double* imaginary, double* output)
+    {
+        inverseReal(real, imaginary, output, *doubleKernels, *doubleTables);
+    }
+    
+    void FastFourierTransformSimd::forwardComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary)
+    {
+        transformComplex(inReal, inImaginary, outReal, outImaginary, *floatKernels, *floatTables);
+    }
+    
+    void FastFourierTransformSimd::forwardComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary)
+    {
+        transformComplex(inReal, inImaginary, outReal, outImaginary, *doubleKernels, *doubleTables);
+    }
+    
+    void FastFourierTransformSimd::inverseComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary)
+    {
+        // Swapping the real and imaginary parts turns the forward transform into an (unscaled) inverse one
+        transformComplex(inImaginary, inReal, outImaginary, outReal, *floatKernels, *floatTables);
+        floatKernels->scale(size, 1.0f / size, outReal, outImaginary);
+    }
+    
+    void FastFourierTransformSimd::inverseComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary)
+    {
+        // Swapping the real and imaginary parts turns the forward transform into an (unscaled) inverse one
+        transformComplex(inImaginary, inReal, outImaginary, outReal, *doubleKernels, *doubleTables);
+        doubleKernels->scale(size, 1.0 / size, outReal, outImaginary);
+    }
+    
+    void FastFourierTransformSimd::forwardBatch(const float* input, size_t count, size_t inputStride, float* real, float* imaginary, size_t outputStride)
+    {
+        forwardRealBatch(input, count, inputStride, real, imaginary, outputStride, *floatKernels, *floatTables);
+    }
+    
+    void FastFourierTransformSimd::forwardBatch(const double* input, size_t count, size_t inputStride, double* real, double* imaginary, size_t outputStride)
+    {
+        forwardRealBatch(input, count, inputStride, real, imaginary, outputStride, *doubleKernels, *doubleTables);
+    }
+    
+    void FastFourierTransformSimd::inverseBatch(const float* real, const float* imaginary, size_t count, size_t inputStride, float* output, size_t outputStride)
+    {
+        inverseRealBatch(real, imaginary, count, inputStride, output, outputStride, *floatKernels, *floatTables);
+    }
+    
+    void FastFourierTransformSimd::inverseBatch(const double* real, const double* imaginary, size_t count, size_t inputStride, double* output, size_t outputStride)
+    {
+        inverseRealBatch(real, imaginary, count, inputStride, output, outputStride, *doubleKernels, *doubleTables);
+    }
+    
+    template <typename T>
+    bool FastFourierTransformSimd::useBatchWork(size_t lanes) const
+    {
+        // Once the interleaved frames don't fit in the cache anymore, transforming them one by one is faster
+        return lanes > 1 && getBatchWorkSize<T>(lanes) <= maximumBatchWorkSize;
+    }
+    
+    template <typename T>
+    void FastFourierTransformSimd::forwardReal(const T* input, T* real, T* imaginary, const simd::Kernels<T>& kernels, const Tables<T>& tables)
+    {
+        // Six buffers of half the size
+        T* w = getWork<T>();
+        const auto half = size / 2;
+        
+        kernels.forwardReal(size, 1, tables.halfTwiddles.data(), tables.realTwiddles.data(), input, real, imaginary,
+                            w, w + half, w + half * 2, w + half * 3, w + half * 4, w + half * 5);
+    }
+    
+    template <typename T>
+    void FastFourierTransformSimd::inverseReal(const T* real, const T* imaginary, T* output, const simd::Kernels<T>& kernels, const Tables<T>& tables)
+    {
+        // Six buffers of half the size
+        T* w = getWork<T>();
+        const auto half = size / 2;
+        
+        kernels.inverseReal(size, 1, tables.halfTwiddles.data(), tables.realTwiddles.data(), real, imaginary, output,
+                            w, w + half, w + half * 2, w + half * 3, w + half * 4, w + half * 5);
+    }
+    
+    template <typename T>
+    void FastFourierTransformSimd::transformComplex(const T* inReal, const T* inImaginary, T* outReal, T* outImaginary, const simd::Kernels<T>& kernels, const Tables<T>& tables)
+    {
+        // Four buffers of the full size
+        T* w = getWork<T>();
+        
+        kernels.forwardComplex(size, 1, tables.complexTwiddles.data(), inReal, inImaginary, outReal, outImaginary,
+                               w, w + size, w + size * 2, w + size * 3);
+    }
+    
+    template <typename T>
+    void FastFourierTransformSimd::forwardRealBatch(const T* input, size_t count, size_t inputStride, T* real, T* imaginary, size_t outputStride, const simd::Kernels<T>& kernels, const Tables<T>& tables)
+    {
+        const auto lanes = kernels.lanes;
+        const auto half = size / 2;
+        const auto groups = useBatchWork<T>(lanes) ? count / lanes : 0;
+        
+        if (groups > 0)
+        {
+            // An interleaved input frame, the interleaved spectrum and six work buffers of half the size
+            T* frames = getBatchWork<T>();
+            T* spectrumReal = frames + size * lanes;
+            T* spectrumImaginary = spectrumReal + (half + 1) * lanes;
+            T* w = spectrumImaginary + (half + 1) * lanes;
+            const auto h = half * lanes;
+            
+            for (size_t group = 0; group < groups; ++group)
+            {
+                // Put element e of frame l at e * lanes + l
+                const T* in = input + group * lanes * inputStride;
+                for (size_t l = 0; l < lanes; ++l)
+                    for (size_t e = 0; e < size; ++e)
+                        frames[e * lanes + l] = in[l * inputStride + e];
+                
+                kernels.forwardReal(size, lanes, tables.halfTwiddles.data(), tables.realTwiddles.data(), frames, spectrumReal, spectrumImaginary,
+                                    w, w + h, w + h * 2, w + h * 3, w + h * 4, w + h * 5);
+                
+                // Scatter the lanes back into separate spectra
+                T* outReal = real + group * lanes * outputStride;
+                T* outImaginary = imaginary + group * lanes * outputStride;
+                for (size_t l = 0; l < lanes; ++l)
+                {
+                    for (size_t k = 0; k <= half; ++k)
+                    {
+                        outReal[l * outputStride + k] = spectrumReal[k * lanes + l];
+                        outImaginary[l * outputStride + k] = spectrumImaginary[k * lanes + l];
+                    }
+                }
+            }
+        }
+        
+        // Transform the frames that didn't fill a group one by one
+        for (auto i = groups * lanes; i < count; ++i)
+            forwardReal(input + i * inputStride, real + i * outputStride, imaginary + i * outputStride, kernels, tables);
+    }
+    
+    template <typename T>
+    void FastFourierTransformSimd::inverseRealBatch(const T* real, const T* imaginary, size_t count, size_t inputStride, T* output, size_t outputStride, const simd::Kernels<T>& kernels, const Tables<T>& tables)
+    {
+        const auto lanes = kernels.lanes;
+        const auto half = size / 2;
+        const auto groups = useBatchWork<T>(lanes) ? count / lanes : 0;
+        
+        if (groups > 0)
+        {
+            // The interleaved spectrum, an interleaved output frame and six work buffers of half the size
+            T* spectrumReal = getBatchWork<T>();
+            T* spectrumImaginary = spectrumReal + (half + 1) * lanes;
+            T* frames = spectrumImaginary + (half + 1) * lanes;
+            T* w = frames + size * lanes;
+            const auto h = half * lanes;
+            
+            for (size_t group = 0; group < groups; ++group)
+            {
+                // Put bin k of spectrum l at k * lanes + l
+                const T* inReal = real + group * lanes * inputStride;
+                const T* inImaginary = imaginary + group * lanes * inputStride;
+                for (size_t l = 0; l < lanes; ++l)
+                {
+                    for (size_t k = 0; k <= half; ++k)
+                    {
+                        spectrumReal[k * lanes + l] = inReal[l * inputStride + k];
+                        spectrumImaginary[k * lanes + l] = inImaginary[l * inputStride + k];
+                    }
+                }
+                
+                kernels.inverseReal(size, lanes, tables.halfTwiddles.data(), tables.realTwiddles.data(), spectrumReal, spectrumImaginary, frames,
+                                    w, w + h, w + h * 2, w + h * 3, w + h * 4, w + h * 5);
+                
+                // Scatter the lanes back into separate frames
+                T* out = output + group * lanes * outputStride;
+                for (size_t l = 0; l < lanes; ++l)
+                    for (size_t e = 0; e < size; ++e)
+                        out[l * outputStride + e] = frames[e * lanes + l];
+            }
+        }
+        
+        // Transform the spectra that didn't fill a group one by one
+        for (auto i = groups * lanes; i < count; ++i)
+            inverseReal(real + i * inputStride, imaginary + i * inputStride, output + i * outputStride, kernels, tables);
+    }
+}
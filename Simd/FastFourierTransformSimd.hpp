@@ -0,0 +1,175 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_FAST_FOURIER_TRANSFORM_SIMD_HPP
+#define GRIZZLY_FAST_FOURIER_TRANSFORM_SIMD_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "../FastFourierTransformBase.hpp"
+
+namespace dsp
+{
+    namespace simd
+    {
+        template <typename T>
+        struct Kernels;
+    }
+    
+    //! Fourier transform using vectorized radix-4 kernels
+    /*! The kernels are compiled for several instruction sets, and the best one the CPU supports is picked at
+        runtime. Only sizes that are a power of two are supported. */
+    class FastFourierTransformSimd : public FastFourierTransformBase
+    {
+    public:
+        //! The instruction sets the kernels can be compiled for
+        /*! GENERIC is the baseline of the compiler (which is SSE2 on x86-64) and is always available */
+        enum class InstructionSet { GENERIC, AVX2, AVX512 };
+        
+    public:
+        //! Construct the transform with the best instruction set supported by this CPU
+        /*! @throw std::invalid_argument if the size is not a power of two, or smaller than 2 */
+        FastFourierTransformSimd(std::size_t size);
+        
+        //! Construct the transform with a specific instruction set
+        /*! If the CPU (or the build) doesn't support it, the best available one below it is used instead
+            @throw std::invalid_argument if the size is not a power of two, or smaller than 2 */
+        FastFourierTransformSimd(std::size_t size, InstructionSet instructionSet);
+        
+        using FastFourierTransformBase::forward;
+        using FastFourierTransformBase::inverse;
+        using FastFourierTransformBase::forwardComplex;
+        using FastFourierTransformBase::inverseComplex;
+        
+        void forward(const float* input, float* real, float* imaginary) override final;
+        void forward(const double* input, double* real, double* imaginary) override final;
+        
+        void inverse(const float* real, const float* imaginary, float* output) override final;
+        void inverse(const double* real, const double* imaginary, double* output) override final;
+        
+        void forwardComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary) override final;
+        void forwardComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary) override final;
+        
+        void inverseComplex(const float* inReal, const float* inImaginary, float* outReal, float* outImaginary) override final;
+        void inverseComplex(const double* inReal, const double* inImaginary, double* outReal, double* outImaginary) override final;
+        
+        //! Do the forward Fourier transform of several frames in one go
+        /*! Groups of frames are interleaved across the lanes of a vector register and transformed together. Frames
+            that don't fill a complete group (and all frames of sizes too large to interleave within the cache) are
+            transformed one by one. */
+        void forwardBatch(const float* input, std::size_t count, std::size_t inputStride, float* real, float* imaginary, std::size_t outputStride) override final;
+        void forwardBatch(const double* input, std::size_t count, std::size_t inputStride, double* real, double* imaginary, std::size_t outputStride) override final;
+        
+        //! Do the inverse Fourier transform of several spectra in one go
+        /*! Groups of spectra are interleaved across the lanes of a vector register and transformed together. Spectra
+            that don't fill a complete group are transformed one by one. */
+        void inverseBatch(const float* real, const float* imaginary, std::size_t count, std::size_t inputStride, float* output, std::size_t outputStride) override final;
+        void inverseBatch(const double* real, const double* imaginary, std::size_t count, std::size_t inputStride, double* output, std::size_t outputStride) override final;
+        
+        //! Return the instruction set the transforms run with
+        InstructionSet getInstructionSet() const { return instructionSet; }
+        
+        //! Return the best instruction set supported by this CPU and build
+        static InstructionSet detectInstructionSet();
+        
+    private:
+        //! Twiddle tables for one precision, shared through FastFourierTransformPlanCache
+        template <typename T>
+        struct Tables
+        {
+            Tables(std::size_t size);
+            
+            //! Radix-4 stage twiddles for a complex transform of size
+            std::vector<T> complexTwiddles;
+            
+            //! Radix-4 stage twiddles for a complex transform of size / 2
+            std::vector<T> halfTwiddles;
+            
+            //! Real and imaginary parts of exp(-2 * pi * i * k / size), for k < size / 2
+            std::vector<T> realTwiddles;
+        };
+        
+        //! The largest batch work buffer (in bytes) for which frames are interleaved across lanes
+        static constexpr std::size_t maximumBatchWorkSize = 1 << 20;
+        
+        //! Storage for the work buffers, aligned to a cache line (and AVX-512 register)
+        struct alignas(64) Block { unsigned char bytes[64]; };
+        
+        //! Return the start of the work buffers, which hold 4 * size elements
+        template <typename T>
+        T* getWork() { return reinterpret_cast<T*>(work.data()); }
+        
+        //! Return the size (in bytes) of the batch work buffers, which hold (5 * size + 2) * lanes elements
+        template <typename T>
+        std::size_t getBatchWorkSize(std::size_t lanes) const { return (size * 5 + 2) * lanes * sizeof(T); }
+        
+        //! Return whether interleaving frames across lanes pays off for this size
+        template <typename T>
+        bool useBatchWork(std::size_t lanes) const;
+        
+        //! Return the start of the batch work buffers
+        template <typename T>
+        T* getBatchWork() { return reinterpret_cast<T*>(batchWork.data()); }
+        
+        template <typename T>
+        void forwardReal(const T* input, T* real, T* imaginary, const simd::Kernels<T>& kernels, const Tables<T>& tables);
+        
+        template <typename T>
+        void inverseReal(const T* real, const T* imaginary, T* output, const simd::Kernels<T>& kernels, const Tables<T>& tables);
+        
+        template <typename T>
+        void transformComplex(const T* inReal, const T* inImaginary, T* outReal, T* outImaginary, const simd::Kernels<T>& kernels, const Tables<T>& tables);
+        
+        template <typename T>
+        void forwardRealBatch(const T* input, std::size_t count, std::size_t inputStride, T* real, T* imaginary, std::size_t outputStride, const simd::Kernels<T>& kernels, const Tables<T>& tables);
+        
+        template <typename T>
+        void inverseRealBatch(const T* real, const T* imaginary, std::size_t count, std::size_t inputStride, T* output, std::size_t outputStride, const simd::Kernels<T>& kernels, const Tables<T>& tables);
+        
+    private:
+        //! The instruction set the transforms run with
+        InstructionSet instructionSet = InstructionSet::GENERIC;
+        
+        //! The kernels compiled for that instruction set
+        const simd::Kernels<float>* floatKernels = nullptr;
+        const simd::Kernels<double>* doubleKernels = nullptr;
+        
+        //! The twiddle tables
+        std::shared_ptr<const Tables<float>> floatTables;
+        std::shared_ptr<const Tables<double>> doubleTables;
+        
+        //! Work buffers, shared by the float and double transforms
+        std::vector<Block> work;
+        
+        //! Work buffers for the batched transforms, empty if this size doesn't interleave frames
+        std::vector<Block> batchWork;
+    };
+}
+
+#endif /* GRIZZLY_FAST_FOURIER_TRANSFORM_SIMD_HPP */
@@ -0,0 +1,87 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_FAST_FOURIER_TRANSFORM_SIMD_KERNELS_HPP
+#define GRIZZLY_FAST_FOURIER_TRANSFORM_SIMD_KERNELS_HPP
+
+#include <cstddef>
+
+namespace dsp
+{
+    namespace simd
+    {
+        //! The transform routines compiled for one instruction set
+        /*! All routines work on split real/imaginary arrays. Several independent transforms can be computed
+            at once by interleaving them element-wise: with n lanes, element e of lane l lives at index e * lanes + l.
+         
+            The twiddle tables are the ones generated by FastFourierTransformSimd: the complex table holds, per radix-4
+            stage, the real and imaginary parts of w^p, w^2p and w^3p, the real table holds exp(-2*pi*i*k/size) for the
+            real-to-complex post-processing. The work buffers should hold size complex elements per lane each. */
+        template <typename T>
+        struct Kernels
+        {
+            //! Complex forward transform of the given size, input and output may be the same arrays
+            void (*forwardComplex)(std::size_t size, std::size_t lanes, const T* twiddles,
+                                   const T* inReal, const T* inImaginary, T* outReal, T* outImaginary,
+                                   T* workReal1, T* workImaginary1, T* workReal2, T* workImaginary2);
+            
+            //! Real forward transform, computed as a complex transform of half the size
+            void (*forwardReal)(std::size_t size, std::size_t lanes, const T* halfTwiddles, const T* realTwiddles,
+                                const T* input, T* real, T* imaginary,
+                                T* workReal1, T* workImaginary1, T* workReal2, T* workImaginary2, T* workReal3, T* workImaginary3);
+            
+            //! Real inverse transform, including the 1 / size scaling
+            void (*inverseReal)(std::size_t size, std::size_t lanes, const T* halfTwiddles, const T* realTwiddles,
+                                const T* real, const T* imaginary, T* output,
+                                T* workReal1, T* workImaginary1, T* workReal2, T* workImaginary2, T* workReal3, T* workImaginary3);
+            
+            //! Multiply two arrays with a factor
+            void (*scale)(std::size_t count, T factor, T* real, T* imaginary);
+            
+            //! The number of lanes that fill a vector register of the instruction set
+            std::size_t lanes;
+        };
+        
+        //! Kernels compiled for the baseline instruction set of the compiler (SSE2 on x86-64)
+        const Kernels<float>& getGenericKernels(float);
+        const Kernels<double>& getGenericKernels(double);
+        
+#ifdef GRIZZLY_SIMD_AVX2
+        //! Kernels compiled for AVX2 and FMA
+        const Kernels<float>& getAvx2Kernels(float);
+        const Kernels<double>& getAvx2Kernels(double);
+#endif
+        
+#ifdef GRIZZLY_SIMD_AVX512
+        //! Kernels compiled for AVX-512
+        const Kernels<float>& getAvx512Kernels(float);
+        const Kernels<double>& getAvx512Kernels(double);
+#endif
+    }
+}
+
+#endif /* GRIZZLY_FAST_FOURIER_TRANSFORM_SIMD_KERNELS_HPP */
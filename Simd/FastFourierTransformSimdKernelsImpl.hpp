@@ -0,0 +1,450 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+// This file is included by each of the FastFourierTransformSimd<InstructionSet>.cpp files, inside a namespace
+// specific to that instruction set, so that every instruction set gets its own copy of these templates. It
+// deliberately stays clear of the standard library: its inline functions would otherwise be compiled with
+// the flags of whichever instruction set came first, and shared among all of them by the linker.
+//
+// The transforms are radix-4 Stockham autosort transforms on split real/imaginary arrays. The inner loops
+// run over contiguous memory without any data-dependent branches, which leaves the vectorization to the
+// compiler (and the instruction set the file is compiled for). The first two stages of a single transform
+// are fused into a radix-16 pass, as their runs would be too short to fill a vector register.
+
+#ifndef GRIZZLY_SIMD_INDEPENDENT
+    // The input and output arrays never overlap, which the compiler can't prove for itself. The small
+    // fixed-size loops are unrolled before vectorization, so that the loop around them can be vectorized.
+    #if defined(__clang__)
+        #define GRIZZLY_SIMD_INDEPENDENT _Pragma("clang loop vectorize(assume_safety)")
+        #define GRIZZLY_SIMD_UNROLL _Pragma("unroll")
+    #elif defined(__GNUC__)
+        #define GRIZZLY_SIMD_INDEPENDENT _Pragma("GCC ivdep")
+        #define GRIZZLY_SIMD_UNROLL _Pragma("GCC unroll 16")
+    #else
+        #define GRIZZLY_SIMD_INDEPENDENT
+        #define GRIZZLY_SIMD_UNROLL
+    #endif
+#endif
+
+//! A radix-4 decimation-in-frequency butterfly, in place
+/*! @param twiddles: The twiddles of the stage, with m entries per part
+    @param p: The index of the twiddles to multiply the outputs with */
+template <typename T>
+inline void butterfly4(T& ar, T& ai, T& br, T& bi, T& cr, T& ci, T& dr, T& di, const T* twiddles, std::size_t m, std::size_t p)
+{
+    const T apcr = ar + cr, apci = ai + ci;
+    const T amcr = ar - cr, amci = ai - ci;
+    const T bpdr = br + dr, bpdi = bi + di;
+    const T bmdr = br - dr, bmdi = bi - di;
+    
+    // (a - c) - i(b - d) and (a - c) + i(b - d)
+    const T x1r = amcr + bmdi, x1i = amci - bmdr;
+    const T x3r = amcr - bmdi, x3i = amci + bmdr;
+    const T x2r = apcr - bpdr, x2i = apci - bpdi;
+    
+    const T w1r = twiddles[p],         w1i = twiddles[m + p];
+    const T w2r = twiddles[m * 2 + p], w2i = twiddles[m * 3 + p];
+    const T w3r = twiddles[m * 4 + p], w3i = twiddles[m * 5 + p];
+    
+    ar = apcr + bpdr;
+    ai = apci + bpdi;
+    br = x1r * w1r - x1i * w1i;
+    bi = x1r * w1i + x1i * w1r;
+    cr = x2r * w2r - x2i * w2i;
+    ci = x2r * w2i + x2i * w2r;
+    dr = x3r * w3r - x3i * w3i;
+    di = x3r * w3i + x3i * w3r;
+}
+
+//! The first two radix-4 stages of a single transform, fused into one pass
+/*! A stage with runs shorter than a vector register wastes most of it, so instead this vectorizes over the
+    twiddles and keeps the sixteen elements of each pair of butterflies in registers.
+    @param m: A sixteenth of the transform size */
+template <typename T>
+void radix16(std::size_t m, const T* twiddles, const T* xr, const T* xi, T* yr, T* yi)
+{
+    const T* firstTwiddles = twiddles;
+    const T* secondTwiddles = twiddles + m * 4 * 6;
+    
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t p = 0; p < m; ++p)
+    {
+        T re[16];
+        T im[16];
+        GRIZZLY_SIMD_UNROLL
+        for (std::size_t s = 0; s < 16; ++s)
+        {
+            re[s] = xr[p + m * s];
+            im[s] = xi[p + m * s];
+        }
+        
+        // The first stage, output k of butterfly j ends up in element j + 4k
+        GRIZZLY_SIMD_UNROLL
+        for (std::size_t j = 0; j < 4; ++j)
+            butterfly4(re[j], im[j], re[j + 4], im[j + 4], re[j + 8], im[j + 8], re[j + 12], im[j + 12], firstTwiddles, m * 4, p + m * j);
+        
+        // The second stage combines the outputs k of the four first butterflies, and writes its output j to 4j + k
+        GRIZZLY_SIMD_UNROLL
+        for (std::size_t k = 0; k < 4; ++k)
+        {
+            butterfly4(re[k * 4], im[k * 4], re[k * 4 + 1], im[k * 4 + 1], re[k * 4 + 2], im[k * 4 + 2], re[k * 4 + 3], im[k * 4 + 3], secondTwiddles, m, p);
+            
+            GRIZZLY_SIMD_UNROLL
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                yr[p * 16 + j * 4 + k] = re[k * 4 + j];
+                yi[p * 16 + j * 4 + k] = im[k * 4 + j];
+            }
+        }
+    }
+}
+
+//! Radix-4 decimation-in-frequency stage
+/*! @param m: A quarter of the current sub-transform size
+    @param run: The number of contiguous elements that share the same twiddle (stride * lanes) */
+template <typename T>
+void radix4(std::size_t m, std::size_t run, const T* twiddles, const T* xr, const T* xi, T* yr, T* yi)
+{
+    if (run == 1)
+    {
+        // The first stage of a single transform: vectorize over the twiddles instead
+        GRIZZLY_SIMD_INDEPENDENT
+        for (std::size_t p = 0; p < m; ++p)
+        {
+            T ar = xr[p],         ai = xi[p];
+            T br = xr[p + m],     bi = xi[p + m];
+            T cr = xr[p + m * 2], ci = xi[p + m * 2];
+            T dr = xr[p + m * 3], di = xi[p + m * 3];
+            
+            butterfly4(ar, ai, br, bi, cr, ci, dr, di, twiddles, m, p);
+            
+            yr[p * 4] = ar;
+            yi[p * 4] = ai;
+            yr[p * 4 + 1] = br;
+            yi[p * 4 + 1] = bi;
+            yr[p * 4 + 2] = cr;
+            yi[p * 4 + 2] = ci;
+            yr[p * 4 + 3] = dr;
+            yi[p * 4 + 3] = di;
+        }
+        
+        return;
+    }
+    
+    const T* w1r = twiddles;
+    const T* w1i = twiddles + m;
+    const T* w2r = twiddles + m * 2;
+    const T* w2i = twiddles + m * 3;
+    const T* w3r = twiddles + m * 4;
+    const T* w3i = twiddles + m * 5;
+    
+    for (std::size_t p = 0; p < m; ++p)
+    {
+        const T* ar = xr + run * p;
+        const T* ai = xi + run * p;
+        const T* br = ar + run * m;
+        const T* bi = ai + run * m;
+        const T* cr = br + run * m;
+        const T* ci = bi + run * m;
+        const T* dr = cr + run * m;
+        const T* di = ci + run * m;
+        
+        T* y0r = yr + run * p * 4;
+        T* y0i = yi + run * p * 4;
+        T* y1r = y0r + run;
+        T* y1i = y0i + run;
+        T* y2r = y1r + run;
+        T* y2i = y1i + run;
+        T* y3r = y2r + run;
+        T* y3i = y2i + run;
+        
+        const T wr1 = w1r[p], wi1 = w1i[p];
+        const T wr2 = w2r[p], wi2 = w2i[p];
+        const T wr3 = w3r[p], wi3 = w3i[p];
+        
+        GRIZZLY_SIMD_INDEPENDENT
+        for (std::size_t q = 0; q < run; ++q)
+        {
+            const T apcr = ar[q] + cr[q], apci = ai[q] + ci[q];
+            const T amcr = ar[q] - cr[q], amci = ai[q] - ci[q];
+            const T bpdr = br[q] + dr[q], bpdi = bi[q] + di[q];
+            const T bmdr = br[q] - dr[q], bmdi = bi[q] - di[q];
+            
+            const T x1r = amcr + bmdi, x1i = amci - bmdr;
+            const T x3r = amcr - bmdi, x3i = amci + bmdr;
+            const T x2r = apcr - bpdr, x2i = apci - bpdi;
+            
+            y0r[q] = apcr + bpdr;
+            y0i[q] = apci + bpdi;
+            y1r[q] = x1r * wr1 - x1i * wi1;
+            y1i[q] = x1r * wi1 + x1i * wr1;
+            y2r[q] = x2r * wr2 - x2i * wi2;
+            y2i[q] = x2r * wi2 + x2i * wr2;
+            y3r[q] = x3r * wr3 - x3i * wi3;
+            y3i[q] = x3r * wi3 + x3i * wr3;
+        }
+    }
+}
+
+//! The final radix-2 stage, for sizes that are an odd power of two
+template <typename T>
+void radix2(std::size_t run, const T* xr, const T* xi, T* yr, T* yi)
+{
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t q = 0; q < run; ++q)
+    {
+        const T ar = xr[q], ai = xi[q];
+        const T br = xr[q + run], bi = xi[q + run];
+        
+        yr[q] = ar + br;
+        yi[q] = ai + bi;
+        yr[q + run] = ar - br;
+        yi[q + run] = ai - bi;
+    }
+}
+
+template <typename T>
+void copy(std::size_t count, const T* input, T* output)
+{
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t i = 0; i < count; ++i)
+        output[i] = input[i];
+}
+
+//! A Stockham transform of radix-4 stages (and a final radix-2 one)
+/*! Only the first stage reads the input, and only the last one writes the output. The stages in between alternate
+    between the two work buffers, so the first work buffer may be the input. */
+template <typename T>
+void stockham(std::size_t size, std::size_t lanes, const T* twiddles,
+              const T* inReal, const T* inImaginary, T* outReal, T* outImaginary,
+              T* workReal1, T* workImaginary1, T* workReal2, T* workImaginary2)
+{
+    if (size == 1)
+    {
+        copy(lanes, inReal, outReal);
+        copy(lanes, inImaginary, outImaginary);
+        return;
+    }
+    
+    // Count the stages, so that the last one can write straight into the output
+    std::size_t stageCount = 0;
+    for (std::size_t length = size, run = lanes; length > 1; ++stageCount)
+    {
+        const std::size_t radix = (run == 1 && length >= 16) ? 16 : (length >= 4 ? 4 : 2);
+        length /= radix;
+        run *= radix;
+    }
+    
+    const T* sourceReal = inReal;
+    const T* sourceImaginary = inImaginary;
+    std::size_t stage = 0;
+    std::size_t run = lanes;
+    
+    for (std::size_t length = size; length > 1; ++stage)
+    {
+        const bool last = stage + 1 == stageCount;
+        T* destinationReal = last ? outReal : (stage % 2 == 0 ? workReal1 : workReal2);
+        T* destinationImaginary = last ? outImaginary : (stage % 2 == 0 ? workImaginary1 : workImaginary2);
+        
+        if (run == 1 && length >= 16)
+        {
+            const std::size_t m = length / 16;
+            radix16(m, twiddles, sourceReal, sourceImaginary, destinationReal, destinationImaginary);
+            
+            twiddles += m * 4 * 6 + m * 6;
+            length /= 16;
+            run *= 16;
+        } else if (length >= 4) {
+            const std::size_t m = length / 4;
+            radix4(m, run, twiddles, sourceReal, sourceImaginary, destinationReal, destinationImaginary);
+            
+            twiddles += m * 6;
+            length /= 4;
+            run *= 4;
+        } else {
+            radix2(run, sourceReal, sourceImaginary, destinationReal, destinationImaginary);
+            
+            length /= 2;
+            run *= 2;
+        }
+        
+        sourceReal = destinationReal;
+        sourceImaginary = destinationImaginary;
+    }
+}
+
+template <typename T>
+void forwardComplex(std::size_t size, std::size_t lanes, const T* twiddles,
+                    const T* inReal, const T* inImaginary, T* outReal, T* outImaginary,
+                    T* workReal1, T* workImaginary1, T* workReal2, T* workImaginary2)
+{
+    // Reading the input in the first stage and writing the output in the last one keeps this safe in-place
+    stockham(size, lanes, twiddles, inReal, inImaginary, outReal, outImaginary, workReal1, workImaginary1, workReal2, workImaginary2);
+}
+
+template <typename T>
+void forwardReal(std::size_t size, std::size_t lanes, const T* halfTwiddles, const T* realTwiddles,
+                 const T* input, T* real, T* imaginary,
+                 T* workReal1, T* workImaginary1, T* workReal2, T* workImaginary2, T* workReal3, T* workImaginary3)
+{
+    const std::size_t half = size / 2;
+    
+    // Treat the even samples as real, the odd ones as imaginary part of a signal of half the size
+    if (lanes == 1)
+    {
+        for (std::size_t e = 0; e < half; ++e)
+        {
+            workReal3[e] = input[e * 2];
+            workImaginary3[e] = input[e * 2 + 1];
+        }
+    } else {
+        for (std::size_t e = 0; e < half; ++e)
+        {
+            copy(lanes, input + e * 2 * lanes, workReal3 + e * lanes);
+            copy(lanes, input + (e * 2 + 1) * lanes, workImaginary3 + e * lanes);
+        }
+    }
+    
+    forwardComplex(half, lanes, halfTwiddles, workReal3, workImaginary3, workReal3, workImaginary3,
+                   workReal1, workImaginary1, workReal2, workImaginary2);
+    
+    const T* zr = workReal3;
+    const T* zi = workImaginary3;
+    const T* wr = realTwiddles;
+    const T* wi = realTwiddles + half;
+    
+    // DC and Nyquist are both real
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t l = 0; l < lanes; ++l)
+    {
+        real[l] = zr[l] + zi[l];
+        imaginary[l] = 0;
+        real[half * lanes + l] = zr[l] - zi[l];
+        imaginary[half * lanes + l] = 0;
+    }
+    
+    // Untangle the spectra of the even and odd samples, and combine them
+    for (std::size_t k = 1; k < half; ++k)
+    {
+        const std::size_t a = k * lanes;
+        const std::size_t b = (half - k) * lanes;
+        
+        GRIZZLY_SIMD_INDEPENDENT
+        for (std::size_t l = 0; l < lanes; ++l)
+        {
+            const T ar = zr[a + l], ai = zi[a + l];
+            const T br = zr[b + l], bi = -zi[b + l];
+            
+            const T evenReal = (ar + br) * T(0.5);
+            const T evenImaginary = (ai + bi) * T(0.5);
+            const T oddReal = (ai - bi) * T(0.5);
+            const T oddImaginary = (br - ar) * T(0.5);
+            
+            real[a + l] = evenReal + wr[k] * oddReal - wi[k] * oddImaginary;
+            imaginary[a + l] = evenImaginary + wr[k] * oddImaginary + wi[k] * oddReal;
+        }
+    }
+}
+
+template <typename T>
+void inverseReal(std::size_t size, std::size_t lanes, const T* halfTwiddles, const T* realTwiddles,
+                 const T* real, const T* imaginary, T* output,
+                 T* workReal1, T* workImaginary1, T* workReal2, T* workImaginary2, T* workReal3, T* workImaginary3)
+{
+    const std::size_t half = size / 2;
+    const T* wr = realTwiddles;
+    const T* wi = realTwiddles + half;
+    
+    // Tangle the spectrum back into the one of a complex signal of half the size. The real and
+    // imaginary parts are swapped, so that the forward transform computes the inverse one.
+    for (std::size_t k = 0; k < half; ++k)
+    {
+        const std::size_t a = k * lanes;
+        const std::size_t b = (half - k) * lanes;
+        
+        GRIZZLY_SIMD_INDEPENDENT
+        for (std::size_t l = 0; l < lanes; ++l)
+        {
+            const T ar = real[a + l], ai = imaginary[a + l];
+            const T br = real[b + l], bi = -imaginary[b + l];
+            
+            const T evenReal = (ar + br) * T(0.5);
+            const T evenImaginary = (ai + bi) * T(0.5);
+            const T differenceReal = (ar - br) * T(0.5);
+            const T differenceImaginary = (ai - bi) * T(0.5);
+            
+            const T oddReal = wr[k] * differenceReal + wi[k] * differenceImaginary;
+            const T oddImaginary = wr[k] * differenceImaginary - wi[k] * differenceReal;
+            
+            workImaginary3[a + l] = evenReal - oddImaginary;
+            workReal3[a + l] = evenImaginary + oddReal;
+        }
+    }
+    
+    forwardComplex(half, lanes, halfTwiddles, workReal3, workImaginary3, workReal3, workImaginary3,
+                   workReal1, workImaginary1, workReal2, workImaginary2);
+    
+    // Swap back, scale and interleave the even and odd samples
+    const T factor = T(1) / half;
+    if (lanes == 1)
+    {
+        for (std::size_t e = 0; e < half; ++e)
+        {
+            output[e * 2] = workImaginary3[e] * factor;
+            output[e * 2 + 1] = workReal3[e] * factor;
+        }
+    } else {
+        for (std::size_t e = 0; e < half; ++e)
+        {
+            GRIZZLY_SIMD_INDEPENDENT
+            for (std::size_t l = 0; l < lanes; ++l)
+            {
+                output[e * 2 * lanes + l] = workImaginary3[e * lanes + l] * factor;
+                output[(e * 2 + 1) * lanes + l] = workReal3[e * lanes + l] * factor;
+            }
+        }
+    }
+}
+
+template <typename T>
+void scale(std::size_t count, T factor, T* real, T* imaginary)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        real[i] *= factor;
+        imaginary[i] *= factor;
+    }
+}
+
+//! Return the kernels
+/*! @param vectorSize: The size of a vector register of the instruction set, in bytes */
+template <typename T>
+const Kernels<T>& getKernels(std::size_t vectorSize)
+{
+    static const Kernels<T> kernels = { &forwardComplex<T>, &forwardReal<T>, &inverseReal<T>, &scale<T>, vectorSize / sizeof(T) };
+    return kernels;
+}
@@ -0,0 +1,63 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#include "FastFourierTransformSimd.hpp"
+#include "SpectrumKernels.hpp"
+
+namespace dsp
+{
+    namespace simd
+    {
+        //! Return the kernels for the best instruction set of this CPU
+        template <typename T>
+        static const SpectrumKernels<T>& selectSpectrumKernels()
+        {
+            switch (FastFourierTransformSimd::detectInstructionSet())
+            {
+#ifdef GRIZZLY_SIMD_AVX512
+                case FastFourierTransformSimd::InstructionSet::AVX512: return getAvx512SpectrumKernels(T());
+#endif
+#ifdef GRIZZLY_SIMD_AVX2
+                case FastFourierTransformSimd::InstructionSet::AVX2: return getAvx2SpectrumKernels(T());
+#endif
+                default: return getGenericSpectrumKernels(T());
+            }
+        }
+        
+        const SpectrumKernels<float>& getBestSpectrumKernels(float)
+        {
+            static const auto& kernels = selectSpectrumKernels<float>();
+            return kernels;
+        }
+        
+        const SpectrumKernels<double>& getBestSpectrumKernels(double)
+        {
+            static const auto& kernels = selectSpectrumKernels<double>();
+            return kernels;
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_SPECTRUM_KERNELS_HPP
+#define GRIZZLY_SPECTRUM_KERNELS_HPP
+
+#include <cstddef>
+
+namespace dsp
+{
+    namespace simd
+    {
+        //! The sums a pass of the spectral feature kernel produces, with k the bin index and m its magnitude
+        enum FeatureSum
+        {
+            MAGNITUDE_SUM,              //!< sum of m
+            INDEX_WEIGHTED_SUM,         //!< sum of k * m
+            SQUARE_INDEX_WEIGHTED_SUM,  //!< sum of k^2 * m
+            INDEX_WEIGHTED_POWER_SUM,   //!< sum of k * m^2
+            POWER_SUM,                  //!< sum of m^2
+            LOG_POWER_SUM,              //!< sum of ln(m^2), clamped to a minimum square magnitude
+            FLUX_SUM,                   //!< sum of the rises in m since the previous spectrum
+            FEATURE_SUM_COUNT
+        };
+        
+        //! The number of bins the feature kernel sums the power of in one block, to look up the rolloff afterwards
+        constexpr std::size_t FEATURE_BLOCK_SIZE = 64;
+        
+        //! The spectrum conversions compiled for one instruction set
+        /*! All routines work on split real/imaginary arrays of count bins. The output may be one of the inputs. The
+            routines that come in pairs have an exact variant at index 0 and a fast approximation at index 1. */
+        template <typename T>
+        struct SpectrumKernels
+        {
+            //! Square magnitudes
+            void (*power)(std::size_t count, const T* real, const T* imaginary, T* output);
+            
+            //! Magnitudes
+            void (*magnitude[2])(std::size_t count, const T* real, const T* imaginary, T* output);
+            
+            //! Square magnitudes in decibels, clamped to a minimum square magnitude
+            void (*decibels[2])(std::size_t count, const T* real, const T* imaginary, T* output, T minimum);
+            
+            //! Arguments, in [-pi, pi]
+            void (*phase[2])(std::size_t count, const T* real, const T* imaginary, T* output);
+            
+            //! Polar to cartesian conversion
+            void (*polar[2])(std::size_t count, const T* magnitudes, const T* phases, T* real, T* imaginary);
+            
+            //! Square magnitudes of interleaved complex bins, given as 2 * count real and imaginary parts
+            void (*powerInterleaved)(std::size_t count, const T* bins, T* output);
+            
+            //! Magnitudes of interleaved complex bins, given as 2 * count real and imaginary parts
+            void (*magnitudeInterleaved)(std::size_t count, const T* bins, T* output);
+            
+            //! Product of a banded sparse matrix and a vector
+            /*! Row r holds the weights [offsets[r], offsets[r + 1]), which multiply the input from firstColumns[r] on */
+            void (*bandedProduct)(std::size_t rowCount, const std::size_t* offsets, const std::size_t* firstColumns, const T* weights, const T* input, T* output);
+            
+            //! Complex products of two split spectra, added to a third one
+            void (*multiplyAccumulate)(std::size_t count, const T* lhsReal, const T* lhsImaginary, const T* rhsReal, const T* rhsImaginary, T* accumulatorReal, T* accumulatorImaginary);
+            
+            //! The FeatureSum sums over count magnitudes, in a single pass
+            /*! @param previous: The magnitudes of the previous spectrum, for the flux
+                @param minimum: The smallest square magnitude taken the logarithm of, which must be positive and normal
+                @param blockPowers: Receives the sum of m^2 of every FEATURE_BLOCK_SIZE bins, the last one possibly partial */
+            void (*features)(std::size_t count, const T* magnitudes, const T* previous, T minimum, T* sums, T* blockPowers);
+        };
+        
+        //! Kernels compiled for the baseline instruction set of the compiler (SSE2 on x86-64)
+        const SpectrumKernels<float>& getGenericSpectrumKernels(float);
+        const SpectrumKernels<double>& getGenericSpectrumKernels(double);
+        
+#ifdef GRIZZLY_SIMD_AVX2
+        //! Kernels compiled for AVX2 and FMA
+        const SpectrumKernels<float>& getAvx2SpectrumKernels(float);
+        const SpectrumKernels<double>& getAvx2SpectrumKernels(double);
+#endif
+        
+#ifdef GRIZZLY_SIMD_AVX512
+        //! Kernels compiled for AVX-512
+        const SpectrumKernels<float>& getAvx512SpectrumKernels(float);
+        const SpectrumKernels<double>& getAvx512SpectrumKernels(double);
+#endif
+        
+        //! Kernels for the best instruction set of this CPU, detected once
+        const SpectrumKernels<float>& getBestSpectrumKernels(float);
+        const SpectrumKernels<double>& getBestSpectrumKernels(double);
+    }
+}
+
+#endif /* GRIZZLY_SPECTRUM_KERNELS_HPP */
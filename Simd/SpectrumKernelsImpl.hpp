@@ -0,0 +1,483 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+// This file is included by each of the SpectrumKernels<InstructionSet>.cpp files, inside a namespace specific to that
+// instruction set, so that every instruction set gets its own copy of these templates. Like the transform kernels, it
+// stays clear of the standard library, and its loops are left to the auto-vectorizer.
+//
+// The math functions are written out as range reductions and polynomials, so that they vectorize. Their selects only
+// become blends when the compiler may ignore floating point exceptions and errno, hence the -fno-trapping-math and
+// -fno-math-errno in CMakeLists.txt. The exact variants are accurate to a few units in the last place of the precision,
+// the fast variants trade that for shorter polynomials and a square root estimate. Bit patterns are reinterpreted with
+// memcpy, which compilers turn into plain register moves.
+
+#ifndef GRIZZLY_SIMD_INDEPENDENT
+    #if defined(__clang__)
+        #define GRIZZLY_SIMD_INDEPENDENT _Pragma("clang loop vectorize(assume_safety)")
+    #elif defined(__GNUC__)
+        #define GRIZZLY_SIMD_INDEPENDENT _Pragma("GCC ivdep")
+    #else
+        #define GRIZZLY_SIMD_INDEPENDENT
+    #endif
+#endif
+
+//! The bit layout of a floating point type
+template <typename T>
+struct FloatBits;
+
+template <>
+struct FloatBits<float>
+{
+    using Integer = unsigned int;
+    static constexpr int mantissaBits = 23;
+    static constexpr Integer exponentMask = 0xFF;
+    static constexpr Integer bias = 127;
+    
+    //! The bit pattern of 2^23, whose lowest mantissa bits hold a small integer exactly
+    static constexpr Integer integerPattern = 0x4B000000;
+    
+    //! The initial estimate of 1 / sqrt(x) is this minus half the bit pattern of x
+    static constexpr Integer inverseSquareRootMagic = 0x5F375A86;
+};
+
+template <>
+struct FloatBits<double>
+{
+    using Integer = unsigned long long;
+    static constexpr int mantissaBits = 52;
+    static constexpr Integer exponentMask = 0x7FF;
+    static constexpr Integer bias = 1023;
+    static constexpr Integer integerPattern = 0x4330000000000000ULL;
+    static constexpr Integer inverseSquareRootMagic = 0x5FE6EB50C7B537A9ULL;
+};
+
+static_assert(sizeof(FloatBits<float>::Integer) == sizeof(float), "float and its integer should have the same size");
+static_assert(sizeof(FloatBits<double>::Integer) == sizeof(double), "double and its integer should have the same size");
+
+//! Reinterpret the bits of one type as another one of the same size
+template <typename To, typename From>
+inline To bitCast(From from)
+{
+    To to;
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_memcpy(&to, &from, sizeof(To));
+#else
+    std::memcpy(&to, &from, sizeof(To));
+#endif
+    return to;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+    inline float squareRoot(float x) { return __builtin_sqrtf(x); }
+    inline double squareRoot(double x) { return __builtin_sqrt(x); }
+#else
+    inline float squareRoot(float x) { return std::sqrt(x); }
+    inline double squareRoot(double x) { return std::sqrt(x); }
+#endif
+
+//! Round to the nearest integer, for |x| below 2^22 (float) or 2^51 (double)
+template <typename T>
+inline T roundToNearest(T x)
+{
+    // Adding 1.5 * 2^mantissaBits pushes the fraction out of the mantissa
+    const T magic = T(1.5) * T(1ULL << FloatBits<T>::mantissaBits);
+    return (x + magic) - magic;
+}
+
+//! Return the natural logarithm of a positive, normal number
+/*! The number is split into 2^e * m, with m between sqrt(1/2) and sqrt(2), and log(m) = 2 * atanh(s), with
+    s = (m - 1) / (m + 1), is summed as 2 * s * (1 + s^2 / 3 + s^4 / 5 + ...) up to s^(2 * terms) */
+template <typename T, int terms>
+inline T logarithm(T x)
+{
+    using Bits = FloatBits<T>;
+    using Integer = typename Bits::Integer;
+    
+    const auto bits = bitCast<Integer>(x);
+    
+    // Convert the biased exponent to floating point by planting it in the mantissa of 2^mantissaBits
+    const auto biasedExponent = bitCast<T>(Bits::integerPattern | ((bits >> Bits::mantissaBits) & Bits::exponentMask)) - bitCast<T>(Bits::integerPattern);
+    T exponent = biasedExponent - T(Bits::bias);
+    T mantissa = bitCast<T>((bits & ((Integer(1) << Bits::mantissaBits) - 1)) | (Bits::bias << Bits::mantissaBits));
+    
+    const bool above = mantissa > T(1.41421356237309504880);
+    mantissa = above ? mantissa * T(0.5) : mantissa;
+    exponent = above ? exponent + T(1) : exponent;
+    
+    const T s = (mantissa - T(1)) / (mantissa + T(1));
+    const T z = s * s;
+    
+    T sum = T(1) / T(2 * terms + 1);
+    for (int k = terms - 1; k >= 0; --k)
+        sum = sum * z + T(1) / T(2 * k + 1);
+    
+    return exponent * T(0.693147180559945309417) + T(2) * s * sum;
+}
+
+//! Return the arc tangent of t in [0, 1], accurate to a few ulp (Cephes atanf)
+inline float arcTangentExact(float t)
+{
+    // Reduce to |t| <= tan(pi / 8)
+    const bool reduce = t > 0.4142135623730950f;
+    const float x = reduce ? (t - 1.f) / (t + 1.f) : t;
+    const float z = x * x;
+    const float y = (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * x + x;
+    return reduce ? y + 0.785398163397448309616f : y;
+}
+
+//! Return the arc tangent of t in [0, 1], accurate to a few ulp (Cephes atan)
+inline double arcTangentExact(double t)
+{
+    // Reduce to |t| <= 0.66
+    const bool reduce = t > 0.66;
+    const double x = reduce ? (t - 1.) / (t + 1.) : t;
+    const double z = x * x;
+    const double p = (((-8.750608600031904122785e-1 * z - 1.615753718733365076637e1) * z - 7.500855792314704667340e1) * z - 1.228866684490136173410e2) * z - 6.485021904942025371773e1;
+    const double q = ((((z + 2.485846490142306297962e1) * z + 1.650270098316988542046e2) * z + 4.328810604912902668951e2) * z + 4.853903996359136964868e2) * z + 1.945506571482613964425e2;
+    const double y = x * z * p / q + x;
+    return reduce ? y + (0.785398163397448309616 + 3.061616997868382943065e-17) : y;
+}
+
+//! Return the arc tangent of t in [0, 1], with an error below 1e-5 plus rounding (Abramowitz and Stegun 4.4.49)
+template <typename T>
+inline T arcTangentFast(T t)
+{
+    const T z = t * t;
+    return t * ((((T(0.0208351) * z - T(0.0851330)) * z + T(0.1801410)) * z - T(0.3302995)) * z + T(0.9998660));
+}
+
+//! Compute the sine and cosine of x, reduced to [-pi / 4, pi / 4] (Cephes sinf and cosf)
+inline void sineCosineExact(float x, float& sine, float& cosine)
+{
+    const float z = x * x;
+    sine = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * x + x;
+    cosine = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.f;
+}
+
+//! Compute the sine and cosine of x, reduced to [-pi / 4, pi / 4] (Cephes sin and cos)
+inline void sineCosineExact(double x, double& sine, double& cosine)
+{
+    const double z = x * x;
+    sine = x + x * z * (((((1.58962301576546568060e-10 * z - 2.50507477628578072866e-8) * z + 2.75573136213857245213e-6) * z - 1.98412698295895385996e-4) * z + 8.33333333332211858878e-3) * z - 1.66666666666666307295e-1);
+    cosine = 1. - 0.5 * z + z * z * (((((-1.13585365213876817300e-11 * z + 2.08757008419747316778e-9) * z - 2.75573141792967388112e-7) * z + 2.48015872888517045348e-5) * z - 1.38888888888730564116e-3) * z + 4.16666666666665929218e-2);
+}
+
+//! Compute the sine and cosine of x, reduced to [-pi / 4, pi / 4], with an error below 4e-5
+template <typename T>
+inline void sineCosineFast(T x, T& sine, T& cosine)
+{
+    const T z = x * x;
+    sine = ((T(1) / T(120) * z - T(1) / T(6)) * z + T(1)) * x;
+    cosine = ((T(-1) / T(720) * z + T(1) / T(24)) * z - T(0.5)) * z + T(1);
+}
+
+//! Square magnitudes of complex numbers
+template <typename T>
+void power(std::size_t count, const T* real, const T* imaginary, T* output)
+{
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t i = 0; i < count; ++i)
+        output[i] = real[i] * real[i] + imaginary[i] * imaginary[i];
+}
+
+//! Magnitudes of complex numbers
+template <typename T>
+void magnitude(std::size_t count, const T* real, const T* imaginary, T* output)
+{
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t i = 0; i < count; ++i)
+        output[i] = squareRoot(real[i] * real[i] + imaginary[i] * imaginary[i]);
+}
+
+//! Magnitudes of complex numbers, with a relative error below 1e-5
+/*! The bit pattern estimate of 1 / sqrt(x) is refined with two Newton steps, and multiplied by x */
+template <typename T>
+void magnitudeFast(std::size_t count, const T* real, const T* imaginary, T* output)
+{
+    using Bits = FloatBits<T>;
+    using Integer = typename Bits::Integer;
+    
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const T x = real[i] * real[i] + imaginary[i] * imaginary[i];
+        T y = bitCast<T>(Bits::inverseSquareRootMagic - (bitCast<Integer>(x) >> 1));
+        y = y * (T(1.5) - T(0.5) * x * y * y);
+        y = y * (T(1.5) - T(0.5) * x * y * y);
+        output[i] = x * y;
+    }
+}
+
+//! Square magnitudes of complex numbers in decibels
+/*! @param minimum: The smallest square magnitude, which must be positive and normal */
+template <typename T, int terms>
+void decibels(std::size_t count, const T* real, const T* imaginary, T* output, T minimum)
+{
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const T x = real[i] * real[i] + imaginary[i] * imaginary[i];
+        output[i] = T(4.34294481903251827651) * logarithm<T, terms>(x > minimum ? x : minimum);
+    }
+}
+
+//! Arguments of complex numbers, in [-pi, pi]
+template <typename T, bool fast>
+void phase(std::size_t count, const T* real, const T* imaginary, T* output)
+{
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const T x = real[i];
+        const T y = imaginary[i];
+        const T absoluteX = x < 0 ? -x : x;
+        const T absoluteY = y < 0 ? -y : y;
+        
+        // Take the arc tangent in the first octant and mirror it to the right one
+        const bool swap = absoluteY > absoluteX;
+        const T large = swap ? absoluteY : absoluteX;
+        const T small = swap ? absoluteX : absoluteY;
+        const T t = large > 0 ? small / large : T(0);
+        
+        T angle = fast ? arcTangentFast(t) : arcTangentExact(t);
+        angle = swap ? T(1.57079632679489661923) - angle : angle;
+        angle = x < 0 ? T(3.14159265358979323846) - angle : angle;
+        output[i] = y < 0 ? -angle : angle;
+    }
+}
+
+//! Convert polar coordinates to cartesian ones
+/*! The phases are reduced to [-pi / 4, pi / 4] in three parts (Cody-Waite), which keeps the exact variant accurate for
+    phases up to about 1e5 (float) or 1e13 (double) radians */
+template <typename T, bool fast>
+void polar(std::size_t count, const T* magnitudes, const T* phases, T* real, T* imaginary)
+{
+    const T halfPi1 = (sizeof(T) == sizeof(float)) ? T(1.5703125) : T(1.57079625129699707031);
+    const T halfPi2 = (sizeof(T) == sizeof(float)) ? T(4.837512969970703125e-4) : T(7.54978941586159635335e-8);
+    const T halfPi3 = (sizeof(T) == sizeof(float)) ? T(7.54978995489188216e-8) : T(5.39030285815811905290e-15);
+    
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const T k = roundToNearest(phases[i] * T(0.636619772367581343076));
+        const T x = ((phases[i] - k * halfPi1) - k * halfPi2) - k * halfPi3;
+        
+        T s, c;
+        if (fast)
+            sineCosineFast(x, s, c);
+        else
+            sineCosineExact(x, s, c);
+        
+        // The quadrant is k modulo 4, computed as k - 4 * floor(k / 4)
+        const T quadrant = k - T(4) * roundToNearest(k * T(0.25) - T(0.375));
+        const bool odd = quadrant == T(1) || quadrant == T(3);
+        const T sine = odd ? c : s;
+        const T cosine = odd ? s : c;
+        
+        const T magnitude = magnitudes[i];
+        real[i] = (quadrant == T(1) || quadrant == T(2)) ? -magnitude * cosine : magnitude * cosine;
+        imaginary[i] = (quadrant >= T(2)) ? -magnitude * sine : magnitude * sine;
+    }
+}
+
+//! Square magnitudes of interleaved complex numbers
+template <typename T>
+void powerInterleaved(std::size_t count, const T* bins, T* output)
+{
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t i = 0; i < count; ++i)
+        output[i] = bins[2 * i] * bins[2 * i] + bins[2 * i + 1] * bins[2 * i + 1];
+}
+
+//! Magnitudes of interleaved complex numbers
+template <typename T>
+void magnitudeInterleaved(std::size_t count, const T* bins, T* output)
+{
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t i = 0; i < count; ++i)
+        output[i] = squareRoot(bins[2 * i] * bins[2 * i] + bins[2 * i + 1] * bins[2 * i + 1]);
+}
+
+//! Product of a banded sparse matrix and a vector, see SpectrumKernels::bandedProduct
+/*! Like the feature sums, each dot product is spread over a vector's worth of lanes */
+template <typename T>
+void bandedProduct(std::size_t rowCount, const std::size_t* offsets, const std::size_t* firstColumns, const T* weights, const T* input, T* output)
+{
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    
+    for (std::size_t row = 0; row < rowCount; ++row)
+    {
+        const std::size_t count = offsets[row + 1] - offsets[row];
+        const T* rowWeights = weights + offsets[row];
+        const T* rowInput = input + firstColumns[row];
+        
+        T sum[lanes] = {};
+        std::size_t i = 0;
+        for (; i + lanes <= count; i += lanes)
+        {
+            GRIZZLY_SIMD_INDEPENDENT
+            for (std::size_t lane = 0; lane < lanes; ++lane)
+                sum[lane] += rowWeights[i + lane] * rowInput[i + lane];
+        }
+        
+        for (std::size_t lane = 0; i < count; ++i, ++lane)
+            sum[lane] += rowWeights[i] * rowInput[i];
+        
+        T total = 0;
+        for (std::size_t lane = 0; lane < lanes; ++lane)
+            total += sum[lane];
+        
+        output[row] = total;
+    }
+}
+
+//! Complex products of two split spectra, added to a third one
+template <typename T>
+void multiplyAccumulate(std::size_t count, const T* lhsReal, const T* lhsImaginary, const T* rhsReal, const T* rhsImaginary, T* accumulatorReal, T* accumulatorImaginary)
+{
+    GRIZZLY_SIMD_INDEPENDENT
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        accumulatorReal[i] += lhsReal[i] * rhsReal[i] - lhsImaginary[i] * rhsImaginary[i];
+        accumulatorImaginary[i] += lhsReal[i] * rhsImaginary[i] + lhsImaginary[i] * rhsReal[i];
+    }
+}
+
+//! The sums the spectral features are derived from, see SpectrumKernels::features
+/*! Every sum is spread over a vector's worth of lanes, so that the vectorizer can keep them in registers without having
+    to reorder the additions. The lanes are only added together per block and at the end. */
+template <typename T, int terms>
+void features(std::size_t count, const T* magnitudes, const T* previous, T minimum, T* sums, T* blockPowers)
+{
+    constexpr std::size_t lanes = 64 / sizeof(T);
+    
+    T magnitudeSum[lanes] = {};
+    T indexWeightedSum[lanes] = {};
+    T squareIndexWeightedSum[lanes] = {};
+    T indexWeightedPowerSum[lanes] = {};
+    T logPowerSum[lanes] = {};
+    T fluxSum[lanes] = {};
+    T powerSum = 0;
+    
+    // The bin indices are kept in floating point, vectors of 64-bit integers don't convert without AVX-512DQ
+    T laneIndices[lanes];
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+        laneIndices[lane] = T(lane);
+    
+    for (std::size_t begin = 0, block = 0; begin < count; begin += FEATURE_BLOCK_SIZE, ++block)
+    {
+        const std::size_t end = (count - begin > FEATURE_BLOCK_SIZE) ? begin + FEATURE_BLOCK_SIZE : count;
+        T blockPowerSum[lanes] = {};
+        
+        // Full vectors first, then whatever is left of the last block one bin at a time, in the lane it would have had
+        std::size_t i = begin;
+        for (; i + lanes <= end; i += lanes)
+        {
+            const T offset = T(i);
+            
+            GRIZZLY_SIMD_INDEPENDENT
+            for (std::size_t lane = 0; lane < lanes; ++lane)
+            {
+                const T k = offset + laneIndices[lane];
+                const T m = magnitudes[i + lane];
+                const T p = m * m;
+                const T rise = m - previous[i + lane];
+                
+                magnitudeSum[lane] += m;
+                indexWeightedSum[lane] += k * m;
+                squareIndexWeightedSum[lane] += k * k * m;
+                indexWeightedPowerSum[lane] += k * p;
+                blockPowerSum[lane] += p;
+                logPowerSum[lane] += logarithm<T, terms>(p > minimum ? p : minimum);
+                fluxSum[lane] += rise > 0 ? rise : T(0);
+            }
+        }
+        
+        for (std::size_t lane = 0; i < end; ++i, ++lane)
+        {
+            const T k = T(i);
+            const T m = magnitudes[i];
+            const T p = m * m;
+            const T rise = m - previous[i];
+            
+            magnitudeSum[lane] += m;
+            indexWeightedSum[lane] += k * m;
+            squareIndexWeightedSum[lane] += k * k * m;
+            indexWeightedPowerSum[lane] += k * p;
+            blockPowerSum[lane] += p;
+            logPowerSum[lane] += logarithm<T, terms>(p > minimum ? p : minimum);
+            fluxSum[lane] += rise > 0 ? rise : T(0);
+        }
+        
+        T blockPower = 0;
+        for (std::size_t lane = 0; lane < lanes; ++lane)
+            blockPower += blockPowerSum[lane];
+        
+        blockPowers[block] = blockPower;
+        powerSum += blockPower;
+    }
+    
+    for (std::size_t sum = 0; sum < FEATURE_SUM_COUNT; ++sum)
+        sums[sum] = 0;
+    
+    for (std::size_t lane = 0; lane < lanes; ++lane)
+    {
+        sums[MAGNITUDE_SUM] += magnitudeSum[lane];
+        sums[INDEX_WEIGHTED_SUM] += indexWeightedSum[lane];
+        sums[SQUARE_INDEX_WEIGHTED_SUM] += squareIndexWeightedSum[lane];
+        sums[INDEX_WEIGHTED_POWER_SUM] += indexWeightedPowerSum[lane];
+        sums[LOG_POWER_SUM] += logPowerSum[lane];
+        sums[FLUX_SUM] += fluxSum[lane];
+    }
+    
+    sums[POWER_SUM] = powerSum;
+}
+
+//! The number of logarithm series terms for the exact decibels of a precision
+template <typename T>
+constexpr int getExactLogarithmTerms() { return (sizeof(T) == sizeof(float)) ? 5 : 10; }
+
+//! Return the kernels
+template <typename T>
+const SpectrumKernels<T>& getSpectrumKernels()
+{
+    static const SpectrumKernels<T> kernels =
+    {
+        &power<T>,
+        { &magnitude<T>, &magnitudeFast<T> },
+        { &decibels<T, getExactLogarithmTerms<T>()>, &decibels<T, 1> },
+        { &phase<T, false>, &phase<T, true> },
+        { &polar<T, false>, &polar<T, true> },
+        &powerInterleaved<T>,
+        &magnitudeInterleaved<T>,
+        &bandedProduct<T>,
+        &multiplyAccumulate<T>,
+        &features<T, getExactLogarithmTerms<T>()>
+    };
+    
+    return kernels;
+}
@@ -0,0 +1,179 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <vector>
+
+#include "Simd/SpectrumKernels.hpp"
+#include "SpectralFeatures.hpp"
+
+using namespace std;
+
+namespace dsp
+{
+    //! The number of power blocks that fit on the stack, enough for spectra of a 32768-point transform
+    static constexpr size_t STACK_BLOCK_COUNT = 16384 / simd::FEATURE_BLOCK_SIZE;
+    
+    //! Return the number of power blocks for a spectrum of a number of bins
+    static size_t getBlockCount(size_t count)
+    {
+        return (count + simd::FEATURE_BLOCK_SIZE - 1) / simd::FEATURE_BLOCK_SIZE;
+    }
+    
+    //! Find the first bin at which the cumulative power reaches a fraction of the total
+    /*! The block sums narrow it down to one block, which is then summed bin by bin */
+    template <typename T>
+    static T findRolloff(const T* magnitudes, size_t count, const T* blockPowers, T energy, T fraction)
+    {
+        const T target = fraction * energy;
+        const auto blockCount = getBlockCount(count);
+        
+        T cumulative = 0;
+        size_t block = 0;
+        while (block + 1 < blockCount && cumulative + blockPowers[block] < target)
+            cumulative += blockPowers[block++];
+        
+        // The bin by bin sum might round differently than the block sum, so don't run past the block
+        const auto begin = block * simd::FEATURE_BLOCK_SIZE;
+        const auto end = min(begin + simd::FEATURE_BLOCK_SIZE, count);
+        for (auto bin = begin; bin < end - 1; ++bin)
+        {
+            cumulative += magnitudes[bin] * magnitudes[bin];
+            if (cumulative >= target)
+                return bin;
+        }
+        
+        return end - 1;
+    }
+    
+    //! Compute the features, with room for the power blocks passed in
+    template <typename T>
+    static SpectralFeatures<T> computeFeatures(const T* magnitudes, const T* previous, size_t count, T rolloffFraction, T* blockPowers)
+    {
+        SpectralFeatures<T> features;
+        if (count == 0)
+            return features;
+        
+        // Without a previous spectrum, compare against the current one for a flux of zero
+        T sums[simd::FEATURE_SUM_COUNT];
+        simd::getBestSpectrumKernels(T()).features(count, magnitudes, previous ? previous : magnitudes, numeric_limits<T>::min(), sums, blockPowers);
+        
+        features.flux = sums[simd::FLUX_SUM];
+        if (sums[simd::MAGNITUDE_SUM] <= 0)
+            return features;
+        
+        const T size = count;
+        features.centroid = sums[simd::INDEX_WEIGHTED_SUM] / sums[simd::MAGNITUDE_SUM];
+        features.spread = sqrt(max(sums[simd::SQUARE_INDEX_WEIGHTED_SUM] / sums[simd::MAGNITUDE_SUM] - features.centroid * features.centroid, T(0)));
+        features.energy = sums[simd::POWER_SUM];
+        features.flatness = min(exp(sums[simd::LOG_POWER_SUM] / size) / (features.energy / size), T(1));
+        features.rolloff = findRolloff(magnitudes, count, blockPowers, features.energy, rolloffFraction);
+        features.highFrequencyContentBrossier = sums[simd::INDEX_WEIGHTED_SUM] / size;
+        features.highFrequencyContentMasri = sums[simd::INDEX_WEIGHTED_POWER_SUM] / size;
+        features.highFrequencyContentJensen = sums[simd::SQUARE_INDEX_WEIGHTED_SUM] / size;
+        
+        return features;
+    }
+    
+    template <typename T>
+    static SpectralFeatures<T> computeFeatures(const T* magnitudes, const T* previous, size_t count, T rolloffFraction)
+    {
+        const auto blockCount = getBlockCount(count);
+        if (blockCount <= STACK_BLOCK_COUNT)
+        {
+            T blockPowers[STACK_BLOCK_COUNT];
+            return computeFeatures(magnitudes, previous, count, rolloffFraction, blockPowers);
+        }
+        
+        vector<T> blockPowers(blockCount);
+        return computeFeatures(magnitudes, previous, count, rolloffFraction, blockPowers.data());
+    }
+    
+    template <typename T>
+    static void computeFeatures(const Spectrogram<T>& spectrogram, T* output, T rolloffFraction)
+    {
+        const auto frameCount = spectrogram.getFrameCount();
+        const auto binCount = spectrogram.getBinCount();
+        const auto& kernels = simd::getBestSpectrumKernels(T());
+        
+        // The magnitudes of the current and previous frame take turns in one buffer
+        vector<T> magnitudes(2 * binCount);
+        vector<T> blockPowers(getBlockCount(binCount));
+        vector<complex<T>> gathered;
+        
+        for (size_t frame = 0; frame < frameCount; ++frame)
+        {
+            // Bin-major frames are strided, and are gathered first
+            const auto span = spectrogram.getFrame(frame);
+            const complex<T>* bins = span.data();
+            if (!span.isContiguous())
+            {
+                gathered.assign(span.begin(), span.end());
+                bins = gathered.data();
+            }
+            
+            T* current = magnitudes.data() + (frame % 2) * binCount;
+            const T* previous = (frame > 0) ? magnitudes.data() + ((frame + 1) % 2) * binCount : nullptr;
+            kernels.magnitudeInterleaved(binCount, reinterpret_cast<const T*>(bins), current);
+            
+            const auto features = computeFeatures(current, previous, binCount, rolloffFraction, blockPowers.data());
+            const auto row = [&](SpectralFeature feature) -> T& { return output[static_cast<size_t>(feature) * frameCount + frame]; };
+            row(SpectralFeature::CENTROID) = features.centroid;
+            row(SpectralFeature::SPREAD) = features.spread;
+            row(SpectralFeature::ROLLOFF) = features.rolloff;
+            row(SpectralFeature::FLATNESS) = features.flatness;
+            row(SpectralFeature::FLUX) = features.flux;
+            row(SpectralFeature::ENERGY) = features.energy;
+            row(SpectralFeature::HIGH_FREQUENCY_CONTENT_BROSSIER) = features.highFrequencyContentBrossier;
+            row(SpectralFeature::HIGH_FREQUENCY_CONTENT_MASRI) = features.highFrequencyContentMasri;
+            row(SpectralFeature::HIGH_FREQUENCY_CONTENT_JENSEN) = features.highFrequencyContentJensen;
+        }
+    }
+    
+    SpectralFeatures<float> computeSpectralFeatures(const float* magnitudes, const float* previous, size_t count, float rolloffFraction)
+    {
+        return computeFeatures(magnitudes, previous, count, rolloffFraction);
+    }
+    
+    SpectralFeatures<double> computeSpectralFeatures(const double* magnitudes, const double* previous, size_t count, double rolloffFraction)
+    {
+        return computeFeatures(magnitudes, previous, count, rolloffFraction);
+    }
+    
+    void computeSpectralFeatures(const Spectrogram<float>& spectrogram, float* output, float rolloffFraction)
+    {
+        computeFeatures(spectrogram, output, rolloffFraction);
+    }
+    
+    void computeSpectralFeatures(const Spectrogram<double>& spectrogram, double* output, double rolloffFraction)
+    {
+        computeFeatures(spectrogram, output, rolloffFraction);
+    }
+}
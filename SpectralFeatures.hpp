@@ -0,0 +1,100 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_SPECTRAL_FEATURES_HPP
+#define GRIZZLY_SPECTRAL_FEATURES_HPP
+
+#include <cstddef>
+
+#include "Spectrogram.hpp"
+
+namespace dsp
+{
+    //! Features of a magnitude spectrum, with frequencies expressed in bins
+    /*! The centroid and high-frequency contents are defined as in SpectralCentroid.hpp and HighFrequencyContent.hpp.
+        A silent spectrum gets zero for every feature. */
+    template <class T>
+    struct SpectralFeatures
+    {
+        //! The magnitude-weighted mean bin
+        T centroid = 0;
+        
+        //! The magnitude-weighted standard deviation of the bins around the centroid
+        T spread = 0;
+        
+        //! The first bin at which the cumulative energy reaches the rolloff fraction of the total
+        T rolloff = 0;
+        
+        //! The geometric mean of the square magnitudes divided by their arithmetic mean, from 0 (tonal) to 1 (white)
+        T flatness = 0;
+        
+        //! The sum of the magnitude rises since the previous spectrum (half-wave rectified spectral flux)
+        T flux = 0;
+        
+        //! The sum of the square magnitudes
+        T energy = 0;
+        
+        //! The high-frequency contents according to Brossier, Masri and Jensen
+        T highFrequencyContentBrossier = 0;
+        T highFrequencyContentMasri = 0;
+        T highFrequencyContentJensen = 0;
+    };
+    
+    //! The rows of the feature matrix computed from a spectrogram
+    enum class SpectralFeature
+    {
+        CENTROID,
+        SPREAD,
+        ROLLOFF,
+        FLATNESS,
+        FLUX,
+        ENERGY,
+        HIGH_FREQUENCY_CONTENT_BROSSIER,
+        HIGH_FREQUENCY_CONTENT_MASRI,
+        HIGH_FREQUENCY_CONTENT_JENSEN
+    };
+    
+    //! The number of rows in the feature matrix
+    constexpr std::size_t SPECTRAL_FEATURE_COUNT = 9;
+    
+    //! Compute all spectral features of a magnitude spectrum in a single vectorized pass
+    /*! @param previous: The magnitudes of the previous spectrum for the flux, or nullptr for a flux of zero
+        @param rolloffFraction: The fraction of the energy the rolloff bin accumulates, in [0, 1]
+        @note: This only allocates for spectra of more than 16384 bins */
+    SpectralFeatures<float> computeSpectralFeatures(const float* magnitudes, const float* previous, std::size_t count, float rolloffFraction = 0.85f);
+    SpectralFeatures<double> computeSpectralFeatures(const double* magnitudes, const double* previous, std::size_t count, double rolloffFraction = 0.85);
+    
+    //! Compute the spectral features of every frame of a spectrogram
+    /*! The magnitudes of each frame are computed once and fed straight into the feature pass. The flux of every frame is
+        taken against the one before it, and is zero for the first.
+        @param output: A SPECTRAL_FEATURE_COUNT x frame count matrix, one row per SpectralFeature, of which feature f of
+                       frame i ends up at output[f * frameCount + i] */
+    void computeSpectralFeatures(const Spectrogram<float>& spectrogram, float* output, float rolloffFraction = 0.85f);
+    void computeSpectralFeatures(const Spectrogram<double>& spectrogram, double* output, double rolloffFraction = 0.85);
+}
+
+#endif /* GRIZZLY_SPECTRAL_FEATURES_HPP */
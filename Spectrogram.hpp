@@ -0,0 +1,257 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_SPECTROGRAM_HPP
+#define GRIZZLY_SPECTROGRAM_HPP
+
+#include <complex>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Spectrum.hpp"
+
+namespace dsp
+{
+    //! Spectra of consecutive frames, stored in one contiguous frames x bins buffer
+    /*! Frames and bin tracks (one bin followed through all frames) are both available as zero-copy spans. The layout
+        decides which of them is contiguous: frame-major keeps the bins of a frame together, bin-major keeps the
+        frames of a bin together, for scanning through time. */
+    template <class T>
+    class Spectrogram
+    {
+    public:
+        using Bin = std::complex<T>;
+        
+        //! The order in which the bins are stored
+        enum class Layout { FRAME_MAJOR, BIN_MAJOR };
+        
+        //! A zero-copy view on a frame or a bin track, whose consecutive elements lie stride bins apart
+        template <class BinType>
+        class Span
+        {
+        public:
+            //! Random access iterator, stepping stride bins at a time
+            /*! It keeps the index of the element next to the start of the span, so that no pointer is formed beyond
+                the end of the underlying storage, which a strided end() would do. */
+            class Iterator
+            {
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using value_type = typename std::remove_const<BinType>::type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = BinType*;
+                using reference = BinType&;
+                
+            public:
+                Iterator() = default;
+                Iterator(BinType* first, std::size_t index, std::size_t stride) : first(first), index(index), stride(stride) { }
+                
+                reference operator*() const { return first[index * stride]; }
+                pointer operator->() const { return first + index * stride; }
+                reference operator[](difference_type distance) const { return first[(index + distance) * stride]; }
+                
+                Iterator& operator++() { ++index; return *this; }
+                Iterator operator++(int) { auto copy = *this; ++index; return copy; }
+                Iterator& operator--() { --index; return *this; }
+                Iterator operator--(int) { auto copy = *this; --index; return copy; }
+                
+                Iterator& operator+=(difference_type distance) { index += distance; return *this; }
+                Iterator& operator-=(difference_type distance) { index -= distance; return *this; }
+                Iterator operator+(difference_type distance) const { auto copy = *this; return copy += distance; }
+                Iterator operator-(difference_type distance) const { auto copy = *this; return copy -= distance; }
+                difference_type operator-(const Iterator& rhs) const { return static_cast<difference_type>(index) - static_cast<difference_type>(rhs.index); }
+                friend Iterator operator+(difference_type distance, const Iterator& iterator) { return iterator + distance; }
+                
+                bool operator==(const Iterator& rhs) const { return index == rhs.index; }
+                bool operator!=(const Iterator& rhs) const { return index != rhs.index; }
+                bool operator<(const Iterator& rhs) const { return index < rhs.index; }
+                bool operator>(const Iterator& rhs) const { return index > rhs.index; }
+                bool operator<=(const Iterator& rhs) const { return index <= rhs.index; }
+                bool operator>=(const Iterator& rhs) const { return index >= rhs.index; }
+                
+            private:
+                BinType* first = nullptr;
+                std::size_t index = 0;
+                std::size_t stride = 1;
+            };
+            
+        public:
+            Span(BinType* data, std::size_t size, std::size_t stride) : first(data), count(size), step(stride) { }
+            
+            //! Access one of the elements
+            BinType& operator[](std::size_t index) const { return first[index * step]; }
+            
+            //! Return the number of elements
+            std::size_t size() const { return count; }
+            
+            //! Return the distance between two consecutive elements, in bins
+            std::size_t stride() const { return step; }
+            
+            //! Return whether the elements lie next to each other, so data() can be used as an array
+            bool isContiguous() const { return step == 1 || count <= 1; }
+            
+            //! Return the address of the first element
+            BinType* data() const { return first; }
+            
+            // Return iterators for ranged for-loops and algorithms
+            Iterator begin() const { return {first, 0, step}; }
+            Iterator end() const { return {first, count, step}; }
+            
+        private:
+            BinType* first = nullptr;
+            std::size_t count = 0;
+            std::size_t step = 1;
+        };
+        
+    public:
+        //! Default constructor
+        Spectrogram() = default;
+        
+        //! Construct a zeroed spectrogram
+        Spectrogram(std::size_t frameCount, std::size_t binCount, Layout layout = Layout::FRAME_MAJOR) :
+            bins(frameCount * binCount),
+            frameCount(frameCount),
+            binCount(binCount),
+            layout(layout)
+        {
+            
+        }
+        
+        //! Change the number of frames and bins, zeroing all bins
+        void resize(std::size_t frameCount, std::size_t binCount)
+        {
+            bins.assign(frameCount * binCount, Bin{});
+            this->frameCount = frameCount;
+            this->binCount = binCount;
+        }
+        
+        //! Return the bins of one frame
+        /*! @throw std::out_of_range if the frame doesn't exist */
+        Span<Bin> getFrame(std::size_t frame) { checkFrame(frame); return {bins.data() + frame * getFrameStride(), binCount, getBinStride()}; }
+        
+        //! Return the bins of one frame
+        /*! @throw std::out_of_range if the frame doesn't exist */
+        Span<const Bin> getFrame(std::size_t frame) const { checkFrame(frame); return {bins.data() + frame * getFrameStride(), binCount, getBinStride()}; }
+        
+        //! Return one bin through all frames
+        /*! @throw std::out_of_range if the bin doesn't exist */
+        Span<Bin> getTrack(std::size_t bin) { checkBin(bin); return {bins.data() + bin * getBinStride(), frameCount, getFrameStride()}; }
+        
+        //! Return one bin through all frames
+        /*! @throw std::out_of_range if the bin doesn't exist */
+        Span<const Bin> getTrack(std::size_t bin) const { checkBin(bin); return {bins.data() + bin * getBinStride(), frameCount, getFrameStride()}; }
+        
+        //! Access a single bin
+        Bin& operator()(std::size_t frame, std::size_t bin) { return at(frame, bin); }
+        
+        //! Access a single bin
+        const Bin& operator()(std::size_t frame, std::size_t bin) const { return at(frame, bin); }
+        
+        //! Copy one frame out as a Spectrum
+        Spectrum<T> getSpectrum(std::size_t frame) const
+        {
+            const auto span = getFrame(frame);
+            return std::vector<Bin>(span.begin(), span.end());
+        }
+        
+        //! Change the layout, reordering the bins
+        void setLayout(Layout layout)
+        {
+            if (layout == this->layout)
+                return;
+            
+            std::vector<Bin> reordered(bins.size());
+            for (std::size_t frame = 0; frame < frameCount; ++frame)
+                for (std::size_t bin = 0; bin < binCount; ++bin)
+                    reordered[(layout == Layout::FRAME_MAJOR) ? frame * binCount + bin : bin * frameCount + frame] = at(frame, bin);
+            
+            bins.swap(reordered);
+            this->layout = layout;
+        }
+        
+        //! Return the order in which the bins are stored
+        Layout getLayout() const { return layout; }
+        
+        //! Return the number of frames
+        std::size_t getFrameCount() const { return frameCount; }
+        
+        //! Return the number of bins in each frame
+        std::size_t getBinCount() const { return binCount; }
+        
+        //! Return the contiguous buffer of all bins, in the order of the layout
+        Bin* data() { return bins.data(); }
+        
+        //! Return the contiguous buffer of all bins, in the order of the layout
+        const Bin* data() const { return bins.data(); }
+        
+    private:
+        //! Return the distance between two bins of a frame
+        std::size_t getBinStride() const { return (layout == Layout::FRAME_MAJOR) ? 1 : frameCount; }
+        
+        //! Return the distance between a bin in two consecutive frames
+        std::size_t getFrameStride() const { return (layout == Layout::FRAME_MAJOR) ? binCount : 1; }
+        
+        //! Throw if a frame doesn't exist
+        void checkFrame(std::size_t frame) const
+        {
+            if (frame >= frameCount)
+                throw std::out_of_range("spectrogram frame (" + std::to_string(frame) + ") >= frame count (" + std::to_string(frameCount) + ")");
+        }
+        
+        //! Throw if a bin doesn't exist
+        void checkBin(std::size_t bin) const
+        {
+            if (bin >= binCount)
+                throw std::out_of_range("spectrogram bin (" + std::to_string(bin) + ") >= bin count (" + std::to_string(binCount) + ")");
+        }
+        
+        //! Access a single bin
+        Bin& at(std::size_t frame, std::size_t bin) { return bins[frame * getFrameStride() + bin * getBinStride()]; }
+        
+        //! Access a single bin
+        const Bin& at(std::size_t frame, std::size_t bin) const { return bins[frame * getFrameStride() + bin * getBinStride()]; }
+        
+    private:
+        //! All bins, in the order of the layout
+        std::vector<Bin> bins;
+        
+        //! The number of frames
+        std::size_t frameCount = 0;
+        
+        //! The number of bins in each frame
+        std::size_t binCount = 0;
+        
+        //! The order in which the bins are stored
+        Layout layout = Layout::FRAME_MAJOR;
+    };
+}
+
+#endif /* GRIZZLY_SPECTROGRAM_HPP */
@@ -0,0 +1,250 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SpectrogramFile.hpp"
+
+using namespace std;
+
+namespace dsp
+{
+    //! The first bytes of every spectrogram file
+    static const char magic[8] = {'G', 'R', 'Z', 'S', 'P', 'E', 'C', 'T'};
+    
+    //! The format version written, and the only one read
+    static const uint32_t version = 1;
+    
+    //! The size of the fixed part of the header, and the alignment of the frame data
+    static const size_t headerSize = 64;
+    
+    //! The fixed part of the header, as it's laid out in the file
+    struct SpectrogramFileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t frameSize;
+        uint64_t hopSize;
+        uint64_t binCount;
+        uint64_t frameCount;
+        double sampleRate;
+        uint64_t windowSize;
+    };
+    
+    static_assert(sizeof(SpectrogramFileHeader) == headerSize, "the spectrogram file header should be 64 bytes");
+    
+    //! Return the offset of the frame data, behind the header and the window
+    static size_t getDataOffset(size_t windowSize)
+    {
+        return (headerSize + windowSize * sizeof(float) + headerSize - 1) / headerSize * headerSize;
+    }
+    
+    //! Return whether a header describes a file of the given size
+    /*! The sizes are compared by dividing, so that corrupt ones can't overflow into a seemingly valid file */
+    static bool isValidHeader(const SpectrogramFileHeader& header, size_t fileSize)
+    {
+        if (memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version || header.binCount != header.frameSize / 2 + 1)
+            return false;
+        
+        if (header.windowSize > (fileSize - headerSize) / sizeof(float))
+            return false;
+        
+        const auto dataOffset = getDataOffset(header.windowSize);
+        if (dataOffset > fileSize)
+            return false;
+        
+        return header.binCount != 0 && header.binCount <= numeric_limits<size_t>::max() / sizeof(complex<float>) &&
+               header.frameCount <= (fileSize - dataOffset) / (header.binCount * sizeof(complex<float>));
+    }
+    
+    SpectrogramFileWriter::SpectrogramFileWriter(const string& path, size_t frameSize, size_t hopSize, double sampleRate, vector<float> window) :
+        window(move(window)),
+        bins(frameSize / 2 + 1),
+        frameSize(frameSize),
+        hopSize(hopSize),
+        sampleRate(sampleRate)
+    {
+        if (hopSize == 0)
+            throw invalid_argument("SpectrogramFileWriter hop size should be at least 1");
+        
+        if (!this->window.empty() && this->window.size() != frameSize)
+            throw invalid_argument("SpectrogramFileWriter window should be as long as a frame");
+        
+        stream.open(path, ios::binary | ios::trunc);
+        if (!stream)
+            throw runtime_error("could not create spectrogram file " + path);
+        
+        // Write the header with a frame count of zero, close() fills it in
+        SpectrogramFileHeader header = {};
+        memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.frameSize = frameSize;
+        header.hopSize = hopSize;
+        header.binCount = getBinCount();
+        header.sampleRate = sampleRate;
+        header.windowSize = this->window.size();
+        
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(reinterpret_cast<const char*>(this->window.data()), this->window.size() * sizeof(float));
+        
+        const vector<char> padding(getDataOffset(this->window.size()) - headerSize - this->window.size() * sizeof(float), 0);
+        stream.write(padding.data(), padding.size());
+    }
+    
+    SpectrogramFileWriter::~SpectrogramFileWriter()
+    {
+        try
+        {
+            close();
+        } catch (...) {
+            
+        }
+    }
+    
+    void SpectrogramFileWriter::write(const complex<float>* bins)
+    {
+        stream.write(reinterpret_cast<const char*>(bins), getBinCount() * sizeof(complex<float>));
+        ++frameCount;
+    }
+    
+    void SpectrogramFileWriter::write(const float* real, const float* imaginary)
+    {
+        for (size_t k = 0; k < bins.size(); ++k)
+            bins[k] = {real[k], imaginary[k]};
+        
+        write(bins.data());
+    }
+    
+    void SpectrogramFileWriter::close()
+    {
+        if (!stream.is_open())
+            return;
+        
+        const uint64_t count = frameCount;
+        stream.seekp(offsetof(SpectrogramFileHeader, frameCount));
+        stream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        stream.close();
+        
+        if (!stream)
+            throw runtime_error("could not write spectrogram file");
+    }
+    
+    SpectrogramFile::SpectrogramFile(const string& path)
+    {
+        const auto file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            throw runtime_error("could not open spectrogram file " + path);
+        
+        struct stat status;
+        if (fstat(file, &status) != 0 || static_cast<size_t>(status.st_size) < headerSize)
+        {
+            ::close(file);
+            throw runtime_error("could not read spectrogram file " + path);
+        }
+        
+        // The mapping stays valid after the descriptor is closed
+        mappingSize = status.st_size;
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, file, 0);
+        ::close(file);
+        
+        if (mapping == MAP_FAILED)
+        {
+            mapping = nullptr;
+            throw runtime_error("could not map spectrogram file " + path);
+        }
+        
+        SpectrogramFileHeader header;
+        memcpy(&header, mapping, sizeof(header));
+        
+        if (!isValidHeader(header, mappingSize))
+        {
+            unmap();
+            throw runtime_error(path + " is not a valid spectrogram file");
+        }
+        
+        const auto dataOffset = getDataOffset(header.windowSize);
+        const auto windowBegin = reinterpret_cast<const float*>(static_cast<const char*>(mapping) + headerSize);
+        window.assign(windowBegin, windowBegin + header.windowSize);
+        
+        bins = reinterpret_cast<const complex<float>*>(static_cast<const char*>(mapping) + dataOffset);
+        frameCount = header.frameCount;
+        binCount = header.binCount;
+        frameSize = header.frameSize;
+        hopSize = header.hopSize;
+        sampleRate = header.sampleRate;
+    }
+    
+    SpectrogramFile::SpectrogramFile(SpectrogramFile&& rhs)
+    {
+        *this = move(rhs);
+    }
+    
+    SpectrogramFile& SpectrogramFile::operator=(SpectrogramFile&& rhs)
+    {
+        if (this == &rhs)
+            return *this;
+        
+        unmap();
+        
+        mapping = exchange(rhs.mapping, nullptr);
+        mappingSize = exchange(rhs.mappingSize, 0);
+        bins = exchange(rhs.bins, nullptr);
+        window = move(rhs.window);
+        frameCount = exchange(rhs.frameCount, 0);
+        binCount = rhs.binCount;
+        frameSize = rhs.frameSize;
+        hopSize = rhs.hopSize;
+        sampleRate = rhs.sampleRate;
+        
+        return *this;
+    }
+    
+    SpectrogramFile::~SpectrogramFile()
+    {
+        unmap();
+    }
+    
+    void SpectrogramFile::unmap()
+    {
+        if (mapping)
+            munmap(mapping, mappingSize);
+        
+        mapping = nullptr;
+        mappingSize = 0;
+    }
+}
@@ -0,0 +1,243 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_SPECTROGRAM_FILE_HPP
+#define GRIZZLY_SPECTROGRAM_FILE_HPP
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <experimental/optional>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "FastFourierTransform.hpp"
+#include "ShortTimeFourierTransform.hpp"
+#include "Spectrogram.hpp"
+
+namespace dsp
+{
+    //! Appends frames to a binary spectrogram file, for analyses too long to hold in memory
+    /*! A file starts with a 64 byte header, in native byte order:
+        - 8 bytes: the magic "GRZSPECT"
+        - uint32: the format version (1), uint32: reserved (0)
+        - uint64: frame size, hop size, bin count and frame count
+        - double: the sample rate
+        - uint64: the window size, 0 for a rectangular window
+        It's followed by the window as floats, zero padding up to a multiple of 64 bytes and then all frames one after
+        the other, each of bin count std::complex<float> values.
+        
+        Frames are written as they come in, so a spectrogram of any length is written in constant memory. The frame
+        count in the header is filled in by close(), which the destructor calls if it wasn't called before. */
+    class SpectrogramFileWriter
+    {
+    public:
+        //! Create or overwrite a file
+        /*! @param window: The analysis window, of frameSize samples (or empty, for no window)
+            @throw std::runtime_error if the file can't be created */
+        SpectrogramFileWriter(const std::string& path, std::size_t frameSize, std::size_t hopSize, double sampleRate, std::vector<float> window = {});
+        
+        SpectrogramFileWriter(const SpectrogramFileWriter&) = delete;
+        SpectrogramFileWriter& operator=(const SpectrogramFileWriter&) = delete;
+        
+        ~SpectrogramFileWriter();
+        
+        //! Append a frame of getBinCount() bins
+        void write(const std::complex<float>* bins);
+        
+        //! Append a frame of getBinCount() bins, in split form
+        void write(const float* real, const float* imaginary);
+        
+        //! Fill in the frame count and close the file
+        /*! @throw std::runtime_error if any write failed */
+        void close();
+        
+        //! Return the number of samples in each frame
+        std::size_t getFrameSize() const { return frameSize; }
+        
+        //! Return the number of samples between the start of two frames
+        std::size_t getHopSize() const { return hopSize; }
+        
+        //! Return the number of bins in each frame
+        std::size_t getBinCount() const { return frameSize / 2 + 1; }
+        
+        //! Return the number of frames written so far
+        std::size_t getFrameCount() const { return frameCount; }
+        
+        //! Return the sample rate of the analyzed signal
+        double getSampleRate() const { return sampleRate; }
+        
+        //! Return the analysis window (or an empty one, for no window)
+        const std::vector<float>& getWindow() const { return window; }
+        
+    private:
+        //! The file being written
+        std::ofstream stream;
+        
+        //! The analysis window
+        std::vector<float> window;
+        
+        //! Frame buffer for interleaving split spectra
+        std::vector<std::complex<float>> bins;
+        
+        //! The number of samples in each frame
+        std::size_t frameSize = 0;
+        
+        //! The number of samples between the start of two frames
+        std::size_t hopSize = 0;
+        
+        //! The number of frames written so far
+        std::size_t frameCount = 0;
+        
+        //! The sample rate of the analyzed signal
+        double sampleRate = 0;
+    };
+    
+    //! A spectrogram file, memory mapped for reading
+    /*! Frames and bin tracks are views straight into the mapping, so nothing is read from disk until it's touched and
+        the operating system can page frames in and out as needed. */
+    class SpectrogramFile
+    {
+    public:
+        //! A frame or bin track, pointing into the mapping
+        using Span = Spectrogram<float>::Span<const std::complex<float>>;
+        
+    public:
+        //! Open and map a file
+        /*! @throw std::runtime_error if the file can't be opened or isn't a valid spectrogram file */
+        SpectrogramFile(const std::string& path);
+        
+        SpectrogramFile(const SpectrogramFile&) = delete;
+        SpectrogramFile& operator=(const SpectrogramFile&) = delete;
+        
+        SpectrogramFile(SpectrogramFile&& rhs);
+        SpectrogramFile& operator=(SpectrogramFile&& rhs);
+        
+        ~SpectrogramFile();
+        
+        //! Return the bins of one frame
+        /*! @throw std::out_of_range if the frame doesn't exist */
+        Span getFrame(std::size_t frame) const { checkFrame(frame); return {bins + frame * binCount, binCount, 1}; }
+        
+        //! Return one bin through all frames
+        /*! @throw std::out_of_range if the bin doesn't exist */
+        Span getTrack(std::size_t bin) const { checkBin(bin); return {bins + bin, frameCount, binCount}; }
+        
+        //! Return the number of frames
+        std::size_t getFrameCount() const { return frameCount; }
+        
+        //! Return the number of bins in each frame
+        std::size_t getBinCount() const { return binCount; }
+        
+        //! Return the number of samples in each frame
+        std::size_t getFrameSize() const { return frameSize; }
+        
+        //! Return the number of samples between the start of two frames
+        std::size_t getHopSize() const { return hopSize; }
+        
+        //! Return the sample rate of the analyzed signal
+        double getSampleRate() const { return sampleRate; }
+        
+        //! Return the analysis window (or an empty one, for no window)
+        const std::vector<float>& getWindow() const { return window; }
+        
+    private:
+        //! Unmap the file
+        void unmap();
+        
+        //! Throw if a frame doesn't exist
+        void checkFrame(std::size_t frame) const
+        {
+            if (frame >= frameCount)
+                throw std::out_of_range("spectrogram file frame (" + std::to_string(frame) + ") >= frame count (" + std::to_string(frameCount) + ")");
+        }
+        
+        //! Throw if a bin doesn't exist
+        void checkBin(std::size_t bin) const
+        {
+            if (bin >= binCount)
+                throw std::out_of_range("spectrogram file bin (" + std::to_string(bin) + ") >= bin count (" + std::to_string(binCount) + ")");
+        }
+        
+    private:
+        //! The start of the mapping
+        void* mapping = nullptr;
+        
+        //! The length of the mapping, in bytes
+        std::size_t mappingSize = 0;
+        
+        //! The first bin of the first frame, inside the mapping
+        const std::complex<float>* bins = nullptr;
+        
+        //! The analysis window
+        std::vector<float> window;
+        
+        //! The number of frames
+        std::size_t frameCount = 0;
+        
+        //! The number of bins in each frame
+        std::size_t binCount = 0;
+        
+        //! The number of samples in each frame
+        std::size_t frameSize = 0;
+        
+        //! The number of samples between the start of two frames
+        std::size_t hopSize = 0;
+        
+        //! The sample rate of the analyzed signal
+        double sampleRate = 0;
+    };
+    
+    //! The short-time Fourier transform, streamed into a spectrogram file
+    /*! The frames are cut and windowed as in shortTimeFourierTransform() with the frame size, hop size and window of
+        the writer, and written one by one. Only one frame is held in memory at a time. */
+    template <typename InputIterator>
+    void shortTimeFourierTransform(InputIterator begin, InputIterator end, SpectrogramFileWriter& writer)
+    {
+        const auto frameSize = writer.getFrameSize();
+        const auto hopSize = writer.getHopSize();
+        const auto& window = writer.getWindow();
+        auto fourier = createFastFourierTransform(frameSize);
+        
+        const auto windowBegin = window.empty() ? std::experimental::optional<std::vector<float>::const_iterator>() : std::experimental::make_optional(window.begin());
+        
+        const auto size = static_cast<std::size_t>(std::distance(begin, end));
+        std::vector<float> frame(frameSize);
+        std::vector<std::complex<float>> bins(writer.getBinCount());
+        
+        for (std::size_t f = 0; f * hopSize < size; ++f)
+        {
+            transformFrame(f, begin, end, *fourier, windowBegin, hopSize, frame.data(), bins.begin());
+            writer.write(bins.data());
+        }
+    }
+}
+
+#endif /* GRIZZLY_SPECTROGRAM_FILE_HPP */
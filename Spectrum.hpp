@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <complex>
+#include <cstddef>
 #include <stdexcept>
 #include <vector>
 
@@ -39,6 +40,13 @@
 namespace dsp
 {
     //! Spectrum of frequency bins
+    /*! The magnitudes, powers and phases are computed on the first query and cached until the spectrum changes. The
+        replace methods and the mutable operator[], begin() and end() drop the cache. Writes to the data member, or
+        through a reference or iterator held on to across a query, need an explicit invalidate().
+     
+        The const queries fill the cache without synchronization, so a spectrum that is shared between threads must
+        either be queried from one thread at a time, or have its cache filled beforehand. Queries on distinct spectra
+        can run concurrently. */
     template <class T>
     class Spectrum
     {
@@ -72,26 +80,68 @@ namespace dsp
             return imaginary;
         }
         
-        //! return the magnitudes
-        std::vector<T> magnitudes() const
+        //! Return the magnitudes
+        /*! Repeated feature queries on the same spectrum cost a single pass. The reference stays valid until the cache
+            is invalidated. */
+        const std::vector<T>& magnitudes() const &
         {
-            std::vector<T> magnitudes(data.size());
-            std::transform(data.begin(), data.end(), magnitudes.begin(), [&](auto bin){ return std::abs(bin); });
-            return magnitudes;
+            if (!magnitudesCached)
+            {
+                magnitudesCache.resize(data.size());
+                for (std::size_t bin = 0; bin < data.size(); ++bin)
+                    magnitudesCache[bin] = std::abs(data[bin]);
+                
+                magnitudesCached = true;
+            }
+            
+            return magnitudesCache;
+        }
+        
+        //! Return the magnitudes of a temporary spectrum by value, so they don't outlive it
+        std::vector<T> magnitudes() && { return static_cast<const Spectrum&>(*this).magnitudes(); }
+        
+        //! Return the powers, or squared magnitudes
+        /*! Cached like the magnitudes */
+        const std::vector<T>& powers() const &
+        {
+            if (!powersCached)
+            {
+                powersCache.resize(data.size());
+                for (std::size_t bin = 0; bin < data.size(); ++bin)
+                    powersCache[bin] = std::norm(data[bin]);
+                
+                powersCached = true;
+            }
+            
+            return powersCache;
         }
         
+        //! Return the powers of a temporary spectrum by value, so they don't outlive it
+        std::vector<T> powers() && { return static_cast<const Spectrum&>(*this).powers(); }
+        
         //! Return the phases
-        std::vector<unit::radian<T>> phases() const
+        /*! Cached like the magnitudes */
+        const std::vector<unit::radian<T>>& phases() const &
         {
-            std::vector<unit::radian<T>> phases(data.size());
-            std::transform(data.begin(), data.end(), phases.begin(), [&](auto bin){ return std::arg(bin); });
-            return phases;
+            if (!phasesCached)
+            {
+                phasesCache.resize(data.size());
+                for (std::size_t bin = 0; bin < data.size(); ++bin)
+                    phasesCache[bin] = std::arg(data[bin]);
+                
+                phasesCached = true;
+            }
+            
+            return phasesCache;
         }
         
+        //! Return the phases of a temporary spectrum by value, so they don't outlive it
+        std::vector<unit::radian<T>> phases() && { return static_cast<const Spectrum&>(*this).phases(); }
+        
         //! Return the unwrapped phases
         std::vector<unit::radian<T>> unwrappedPhases() const
         {
-            auto wrappedPhases = phases();
+            const auto& wrappedPhases = phases();
             std::vector<unit::radian<T>> unwrappedPhases(wrappedPhases.size());
             unwrappedPhases.front() = wrappedPhases.front();
             auto previousValue = unwrappedPhases.front();
@@ -119,7 +169,8 @@ namespace dsp
             if (real.size() != data.size())
                 throw std::runtime_error("Sizes not equal");
             
-            std::transform(data.begin(), data.end(), real.begin(), data.begin(), [](std::complex<T> lhs, T rhs) { lhs.real(rhs); });
+            std::transform(data.begin(), data.end(), real.begin(), data.begin(), [](std::complex<T> lhs, T rhs) { lhs.real(rhs); return lhs; });
+            invalidate();
         }
         
         //! Replace the imaginary data of the spectrum
@@ -128,7 +179,8 @@ namespace dsp
             if (imaginary.size() != data.size())
                 throw std::invalid_argument("Sizes not equal");
             
-            std::transform(data.begin(), data.end(), imaginary.begin(), data.begin(), [](std::complex<T> lhs, T rhs) { lhs.imag(rhs); });
+            std::transform(data.begin(), data.end(), imaginary.begin(), data.begin(), [](std::complex<T> lhs, T rhs) { lhs.imag(rhs); return lhs; });
+            invalidate();
         }
         
         //! Replace the magnitudes of the spectrum
@@ -137,8 +189,12 @@ namespace dsp
             if (magnitudes.size() != data.size())
                 throw std::invalid_argument("Sizes not equal");
             
-            for (auto bin = 0; bin < data.size(); ++bin)
-                data[bin] = std::polar(magnitudes[bin], std::arg(data[bin]));
+            // Reuse the cached phases, they'll be computed here anyway
+            const auto& phases = this->phases();
+            for (std::size_t bin = 0; bin < data.size(); ++bin)
+                data[bin] = std::polar(magnitudes[bin], phases[bin].value);
+            
+            invalidate();
         }
         
         //! Replace the phases of the spectrum
@@ -147,28 +203,51 @@ namespace dsp
             if (phases.size() != data.size())
                 throw std::invalid_argument("Sizes not equal");
             
-            for (auto bin = 0; bin < data.size(); ++bin)
-                data[bin] = std::polar(std::abs(data[bin]), phases[bin].value);
+            const auto& magnitudes = this->magnitudes();
+            for (std::size_t bin = 0; bin < data.size(); ++bin)
+                data[bin] = std::polar(magnitudes[bin], phases[bin].value);
+            
+            invalidate();
         }
         
         //! Return the size of the spectrum
         auto size() const { return data.size(); }
         
-        // Return iterators for ranged for-loops
-        auto begin() { return data.begin(); }
+        //! Drop the cached magnitudes, powers and phases
+        /*! The mutable accessors do this for you, see the class description for when to call it yourself */
+        void invalidate()
+        {
+            magnitudesCached = false;
+            powersCached = false;
+            phasesCached = false;
+        }
+        
+        // Return iterators for ranged for-loops, the mutable ones invalidate the cache
+        auto begin() { invalidate(); return data.begin(); }
         auto begin() const { return data.begin(); }
-        auto end() { return data.end(); }
+        auto end() { invalidate(); return data.end(); }
         auto end() const { return data.end(); }
         
-        //! Return a single bin in cartesian coordinates
-        Bin& operator[](size_t index) { return data[index]; }
+        //! Return a single bin in cartesian coordinates, invalidating the cache
+        Bin& operator[](std::size_t index) { invalidate(); return data[index]; }
         
         //! Return a single const bin in cartesian coordinates
-        const Bin& operator[](size_t index) const { return data[index]; }
+        const Bin& operator[](std::size_t index) const { return data[index]; }
         
     public:
         //! Spectrum in cartesian coordinates
         std::vector<Bin> data;
+        
+    private:
+        //! Derived quantities, computed on demand
+        mutable std::vector<T> magnitudesCache;
+        mutable std::vector<T> powersCache;
+        mutable std::vector<unit::radian<T>> phasesCache;
+        
+        //! Whether the caches reflect the current data
+        mutable bool magnitudesCached = false;
+        mutable bool powersCached = false;
+        mutable bool phasesCached = false;
     };
 }
 
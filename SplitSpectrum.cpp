@@ -0,0 +1,122 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#include <cmath>
+#include <complex>
+#include <limits>
+
+#include "Simd/SpectrumKernels.hpp"
+#include "SplitSpectrum.hpp"
+
+using namespace std;
+
+namespace dsp
+{
+    //! Return the kernels for the best instruction set of this CPU
+    template <typename T>
+    static const simd::SpectrumKernels<T>& getKernels()
+    {
+        return simd::getBestSpectrumKernels(T());
+    }
+    
+    //! Return the square magnitude a decibel floor corresponds to, at least the smallest normal number
+    template <typename T>
+    static T getMinimumPower(T floor)
+    {
+        return max(pow(T(10), floor / T(10)), numeric_limits<T>::min());
+    }
+    
+    void computePowers(const float* real, const float* imaginary, float* output, size_t count)
+    {
+        getKernels<float>().power(count, real, imaginary, output);
+    }
+    
+    void computePowers(const double* real, const double* imaginary, double* output, size_t count)
+    {
+        getKernels<double>().power(count, real, imaginary, output);
+    }
+    
+    void computePowers(const complex<float>* bins, float* output, size_t count)
+    {
+        getKernels<float>().powerInterleaved(count, reinterpret_cast<const float*>(bins), output);
+    }
+    
+    void computePowers(const complex<double>* bins, double* output, size_t count)
+    {
+        getKernels<double>().powerInterleaved(count, reinterpret_cast<const double*>(bins), output);
+    }
+    
+    void computeMagnitudes(const float* real, const float* imaginary, float* output, size_t count, SpectrumAccuracy accuracy)
+    {
+        getKernels<float>().magnitude[static_cast<int>(accuracy)](count, real, imaginary, output);
+    }
+    
+    void computeMagnitudes(const double* real, const double* imaginary, double* output, size_t count, SpectrumAccuracy accuracy)
+    {
+        getKernels<double>().magnitude[static_cast<int>(accuracy)](count, real, imaginary, output);
+    }
+    
+    void computeDecibels(const float* real, const float* imaginary, float* output, size_t count, float floor, SpectrumAccuracy accuracy)
+    {
+        getKernels<float>().decibels[static_cast<int>(accuracy)](count, real, imaginary, output, getMinimumPower(floor));
+    }
+    
+    void computeDecibels(const double* real, const double* imaginary, double* output, size_t count, double floor, SpectrumAccuracy accuracy)
+    {
+        getKernels<double>().decibels[static_cast<int>(accuracy)](count, real, imaginary, output, getMinimumPower(floor));
+    }
+    
+    void computePhases(const float* real, const float* imaginary, float* output, size_t count, SpectrumAccuracy accuracy)
+    {
+        getKernels<float>().phase[static_cast<int>(accuracy)](count, real, imaginary, output);
+    }
+    
+    void computePhases(const double* real, const double* imaginary, double* output, size_t count, SpectrumAccuracy accuracy)
+    {
+        getKernels<double>().phase[static_cast<int>(accuracy)](count, real, imaginary, output);
+    }
+    
+    void polarToCartesian(const float* magnitudes, const float* phases, float* real, float* imaginary, size_t count, SpectrumAccuracy accuracy)
+    {
+        getKernels<float>().polar[static_cast<int>(accuracy)](count, magnitudes, phases, real, imaginary);
+    }
+    
+    void polarToCartesian(const double* magnitudes, const double* phases, double* real, double* imaginary, size_t count, SpectrumAccuracy accuracy)
+    {
+        getKernels<double>().polar[static_cast<int>(accuracy)](count, magnitudes, phases, real, imaginary);
+    }
+    
+    void multiplyAccumulate(const float* lhsReal, const float* lhsImaginary, const float* rhsReal, const float* rhsImaginary, float* accumulatorReal, float* accumulatorImaginary, size_t count)
+    {
+        getKernels<float>().multiplyAccumulate(count, lhsReal, lhsImaginary, rhsReal, rhsImaginary, accumulatorReal, accumulatorImaginary);
+    }
+    
+    void multiplyAccumulate(const double* lhsReal, const double* lhsImaginary, const double* rhsReal, const double* rhsImaginary, double* accumulatorReal, double* accumulatorImaginary, size_t count)
+    {
+        getKernels<double>().multiplyAccumulate(count, lhsReal, lhsImaginary, rhsReal, rhsImaginary, accumulatorReal, accumulatorImaginary);
+    }
+}
@@ -0,0 +1,166 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_SPLIT_SPECTRUM_HPP
+#define GRIZZLY_SPLIT_SPECTRUM_HPP
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include "Spectrum.hpp"
+
+namespace dsp
+{
+    //! The accuracy of the vectorized spectrum conversions
+    /*! EXACT is accurate to a few units in the last place. FAST uses shorter polynomials and a square root estimate,
+        with errors below 1e-5 relative for magnitudes, 2e-5 radians for phases, 1e-3 dB for decibels and 1e-4 relative
+        for polar to cartesian conversion. */
+    enum class SpectrumAccuracy { EXACT, FAST };
+    
+    //! Compute the square magnitudes of split complex bins
+    /*! @note: The output may point to one of the inputs */
+    void computePowers(const float* real, const float* imaginary, float* output, std::size_t count);
+    void computePowers(const double* real, const double* imaginary, double* output, std::size_t count);
+    
+    //! Compute the square magnitudes of interleaved complex bins
+    void computePowers(const std::complex<float>* bins, float* output, std::size_t count);
+    void computePowers(const std::complex<double>* bins, double* output, std::size_t count);
+    
+    //! Compute the magnitudes of split complex bins
+    /*! @note: The output may point to one of the inputs */
+    void computeMagnitudes(const float* real, const float* imaginary, float* output, std::size_t count, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT);
+    void computeMagnitudes(const double* real, const double* imaginary, double* output, std::size_t count, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT);
+    
+    //! Compute the magnitudes of split complex bins in decibels, 20 * log10(|bin|)
+    /*! @param floor: The lowest decibel value returned, also for bins of zero (at most the smallest normal power)
+        @note: The output may point to one of the inputs */
+    void computeDecibels(const float* real, const float* imaginary, float* output, std::size_t count, float floor = -200, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT);
+    void computeDecibels(const double* real, const double* imaginary, double* output, std::size_t count, double floor = -200, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT);
+    
+    //! Compute the phases of split complex bins, in [-pi, pi]
+    /*! Bins with a negative real part and an imaginary part of -0 get pi, not -pi.
+        @note: The output may point to one of the inputs */
+    void computePhases(const float* real, const float* imaginary, float* output, std::size_t count, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT);
+    void computePhases(const double* real, const double* imaginary, double* output, std::size_t count, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT);
+    
+    //! Convert magnitudes and phases to split complex bins
+    /*! The exact conversion stays accurate for phases up to about 1e5 (float) or 1e13 (double) radians, keep them wrapped
+        for more. The real and imaginary outputs may point to the magnitudes and phases respectively. */
+    void polarToCartesian(const float* magnitudes, const float* phases, float* real, float* imaginary, std::size_t count, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT);
+    void polarToCartesian(const double* magnitudes, const double* phases, double* real, double* imaginary, std::size_t count, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT);
+    
+    //! Multiply two split spectra bin by bin, and add the result to a third one
+    /*! This is the inner loop of partitioned convolution, which sums the products of many spectra */
+    void multiplyAccumulate(const float* lhsReal, const float* lhsImaginary, const float* rhsReal, const float* rhsImaginary, float* accumulatorReal, float* accumulatorImaginary, std::size_t count);
+    void multiplyAccumulate(const double* lhsReal, const double* lhsImaginary, const double* rhsReal, const double* rhsImaginary, double* accumulatorReal, double* accumulatorImaginary, std::size_t count);
+    
+    //! Spectrum with the real and imaginary parts of the bins in separate arrays
+    /*! This is the layout the Fourier transforms produce natively, so they can write into it without interleaving:
+        fourier.forward(input, spectrum.real.data(), spectrum.imaginary.data()). The polar conversions run as vectorized
+        kernels for the best instruction set of the CPU, writing into buffers of the caller. */
+    template <class T>
+    class SplitSpectrum
+    {
+    public:
+        using Bin = std::complex<T>;
+        
+    public:
+        //! Default constructor
+        SplitSpectrum() = default;
+        
+        //! Construct a zeroed spectrum of a given number of bins
+        SplitSpectrum(std::size_t size) :
+            real(size),
+            imaginary(size)
+        {
+            
+        }
+        
+        //! Construct from an interleaved spectrum
+        SplitSpectrum(const Spectrum<T>& spectrum) :
+            SplitSpectrum(spectrum.size())
+        {
+            for (std::size_t k = 0; k < spectrum.size(); ++k)
+                setBin(k, spectrum[k]);
+        }
+        
+        //! Return an interleaved copy of the spectrum
+        Spectrum<T> toSpectrum() const
+        {
+            std::vector<Bin> bins(size());
+            for (std::size_t k = 0; k < bins.size(); ++k)
+                bins[k] = getBin(k);
+            
+            return bins;
+        }
+        
+        //! Return a single bin
+        Bin getBin(std::size_t index) const { return {real[index], imaginary[index]}; }
+        
+        //! Change a single bin
+        void setBin(std::size_t index, const Bin& bin)
+        {
+            real[index] = bin.real();
+            imaginary[index] = bin.imag();
+        }
+        
+        //! Change the number of bins
+        void resize(std::size_t size)
+        {
+            real.resize(size);
+            imaginary.resize(size);
+        }
+        
+        //! Return the number of bins
+        std::size_t size() const { return real.size(); }
+        
+        //! Write the square magnitudes into a buffer of size() elements
+        void powers(T* output) const { computePowers(real.data(), imaginary.data(), output, size()); }
+        
+        //! Write the magnitudes into a buffer of size() elements
+        void magnitudes(T* output, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT) const { computeMagnitudes(real.data(), imaginary.data(), output, size(), accuracy); }
+        
+        //! Write the magnitudes in decibels into a buffer of size() elements
+        void decibels(T* output, T floor = -200, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT) const { computeDecibels(real.data(), imaginary.data(), output, size(), floor, accuracy); }
+        
+        //! Write the phases into a buffer of size() elements
+        void phases(T* output, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT) const { computePhases(real.data(), imaginary.data(), output, size(), accuracy); }
+        
+        //! Replace all bins by ones with given magnitudes and phases
+        void setPolar(const T* magnitudes, const T* phases, SpectrumAccuracy accuracy = SpectrumAccuracy::EXACT) { polarToCartesian(magnitudes, phases, real.data(), imaginary.data(), size(), accuracy); }
+        
+    public:
+        //! The real parts of the bins
+        std::vector<T> real;
+        
+        //! The imaginary parts of the bins
+        std::vector<T> imaginary;
+    };
+}
+
+#endif /* GRIZZLY_SPLIT_SPECTRUM_HPP */
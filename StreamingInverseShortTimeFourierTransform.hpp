@@ -0,0 +1,149 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_STREAMING_INVERSE_SHORT_TIME_FOURIER_TRANSFORM_HPP
+#define GRIZZLY_STREAMING_INVERSE_SHORT_TIME_FOURIER_TRANSFORM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "FastFourierTransform.hpp"
+#include "Window.hpp"
+
+namespace dsp
+{
+    //! Inverse short-time Fourier transform of a live stream of spectra, by weighted overlap-add
+    /*! Each spectrum written is inverse transformed, multiplied with the synthesis window and added to the frames
+        before it, after which the next hop of samples is complete. Given the spectra of a
+        StreamingShortTimeFourierTransform with the same frame size, hop size and window, the output is the original
+        stream delayed by frameSize - hopSize samples (apart from the first frameSize - hopSize samples, which miss
+        the frames before the stream started). Nothing is allocated after construction. */
+    template <typename T>
+    class StreamingInverseShortTimeFourierTransform
+    {
+    public:
+        //! Construct the transform
+        /*! @param frameSize: The number of samples in each frame
+            @param hopSize: The number of samples between the start of two frames (at least 1, at most frameSize)
+            @param window: The window the frames were analyzed with, of frameSize samples (or empty, for no window) */
+        StreamingInverseShortTimeFourierTransform(std::size_t frameSize, std::size_t hopSize, const std::vector<T>& window = {}) :
+            fourier(createFastFourierTransform(frameSize)),
+            frame(frameSize),
+            accumulator(frameSize),
+            hopSize(hopSize)
+        {
+            if (hopSize == 0 || hopSize > frameSize)
+                throw std::invalid_argument("StreamingInverseShortTimeFourierTransform hop size should be between 1 and the frame size");
+            
+            if (!window.empty() && window.size() != frameSize)
+                throw std::invalid_argument("StreamingInverseShortTimeFourierTransform window should be as long as a frame");
+            
+            synthesisWindow = createSynthesisWindow(window.empty() ? createRectangularWindow<T>(frameSize) : window, hopSize);
+        }
+        
+        //! Add the frame of a spectrum, and output the hopSize samples that are complete
+        /*! @param real: The real part of the spectrum, containing at least (frameSize / 2 + 1) elements
+            @param imaginary: The imaginary part of the spectrum, containing at least (frameSize / 2 + 1) elements
+            @param output: Address to write hopSize samples to */
+        void write(const T* real, const T* imaginary, T* output)
+        {
+            fourier->inverse(real, imaginary, frame.data());
+            
+            // Overlap-add the weighted frame, starting at the oldest sample in the accumulator
+            const auto size = accumulator.size();
+            const auto tail = size - position;
+            for (std::size_t n = 0; n < tail; ++n)
+                accumulator[position + n] += frame[n] * synthesisWindow[n];
+            
+            for (auto n = tail; n < size; ++n)
+                accumulator[n - tail] += frame[n] * synthesisWindow[n];
+            
+            read(output, hopSize);
+        }
+        
+        //! Output the frameSize - hopSize samples the last frames still hold, and start over
+        void flush(T* output)
+        {
+            read(output, accumulator.size() - hopSize);
+            reset();
+        }
+        
+        //! Forget all frames written
+        void reset()
+        {
+            std::fill(accumulator.begin(), accumulator.end(), 0);
+            position = 0;
+        }
+        
+        //! Return the window the frames are multiplied with before they're added
+        const std::vector<T>& getSynthesisWindow() const { return synthesisWindow; }
+        
+        //! Return the number of samples in each frame
+        std::size_t getFrameSize() const { return frame.size(); }
+        
+        //! Return the number of samples between the start of two frames
+        std::size_t getHopSize() const { return hopSize; }
+        
+    private:
+        //! Move samples out of the accumulator, oldest first, and clear their place for the next frames
+        void read(T* output, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                output[i] = accumulator[position];
+                accumulator[position] = 0;
+                
+                if (++position == accumulator.size())
+                    position = 0;
+            }
+        }
+        
+    private:
+        //! The Fourier transform of the frames
+        std::unique_ptr<FastFourierTransformBase> fourier;
+        
+        //! The window frames are multiplied with before they're added
+        std::vector<T> synthesisWindow;
+        
+        //! The inverse transformed frame
+        std::vector<T> frame;
+        
+        //! The sum of the frames that aren't complete yet, as a ring starting at position
+        std::vector<T> accumulator;
+        
+        //! The number of samples between the start of two frames
+        std::size_t hopSize = 0;
+        
+        //! The index of the oldest sample in the accumulator
+        std::size_t position = 0;
+    };
+}
+
+#endif /* GRIZZLY_STREAMING_INVERSE_SHORT_TIME_FOURIER_TRANSFORM_HPP */
@@ -0,0 +1,174 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_STREAMING_SHORT_TIME_FOURIER_TRANSFORM_HPP
+#define GRIZZLY_STREAMING_SHORT_TIME_FOURIER_TRANSFORM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "FastFourierTransform.hpp"
+
+namespace dsp
+{
+    //! Short-time Fourier transform of a live stream
+    /*! Blocks of any size are pushed with write() and buffered in a ring of one frame. As soon as the last sample of a
+        frame comes in, the frame is windowed and transformed, so the latency is bounded by one hop. The frames start
+        at sample 0 and follow each other at hop size intervals, as in shortTimeFourierTransform(). Nothing is
+        allocated after construction. */
+    template <typename T>
+    class StreamingShortTimeFourierTransform
+    {
+    public:
+        //! Construct the transform
+        /*! @param frameSize: The number of samples in each frame
+            @param hopSize: The number of samples between the start of two frames (at least 1)
+            @param window: The window frames are multiplied with, of frameSize samples (or empty, for no window) */
+        StreamingShortTimeFourierTransform(std::size_t frameSize, std::size_t hopSize, std::vector<T> window = {}) :
+            fourier(createFastFourierTransform(frameSize)),
+            window(std::move(window)),
+            ring(frameSize),
+            frame(frameSize),
+            real(frameSize / 2 + 1),
+            imaginary(frameSize / 2 + 1),
+            hopSize(hopSize),
+            remaining(frameSize)
+        {
+            if (hopSize == 0)
+                throw std::invalid_argument("StreamingShortTimeFourierTransform hop size should be at least 1");
+            
+            if (!this->window.empty() && this->window.size() != frameSize)
+                throw std::invalid_argument("StreamingShortTimeFourierTransform window should be as long as a frame");
+        }
+        
+        //! Push a block of samples, calling callback(real, imaginary) for every spectrum it completes
+        /*! The callback gets the (frameSize / 2 + 1) bins of the spectrum in split form, valid during the call */
+        template <typename Callback>
+        void write(const T* input, std::size_t count, Callback callback)
+        {
+            while (count > 0)
+            {
+                const auto consumed = write(input, count);
+                input += consumed;
+                count -= consumed;
+                
+                if (read(real.data(), imaginary.data()))
+                    callback(real.data(), imaginary.data());
+            }
+        }
+        
+        //! Push a block of samples, up to the point where the next spectrum is complete
+        /*! When a spectrum becomes ready, read it before writing the rest of the block
+            @return: The number of samples consumed */
+        std::size_t write(const T* input, std::size_t count)
+        {
+            const auto consumed = std::min(count, remaining);
+            for (std::size_t i = 0; i < consumed; ++i)
+            {
+                ring[position] = input[i];
+                if (++position == ring.size())
+                    position = 0;
+            }
+            
+            remaining -= consumed;
+            return consumed;
+        }
+        
+        //! Return whether a spectrum is complete, and can be read
+        bool isReady() const { return remaining == 0; }
+        
+        //! Compute the next spectrum, if it's complete
+        /*! @param real: The real part of the spectrum, containing at least (frameSize / 2 + 1) elements
+            @param imaginary: The imaginary part of the spectrum, containing at least (frameSize / 2 + 1) elements
+            @return: Whether a spectrum was ready */
+        bool read(T* real, T* imaginary)
+        {
+            if (!isReady())
+                return false;
+            
+            // The oldest sample is the one about to be overwritten
+            std::copy(ring.begin() + position, ring.end(), frame.begin());
+            std::copy(ring.begin(), ring.begin() + position, frame.begin() + (ring.size() - position));
+            
+            if (!window.empty())
+                std::transform(frame.begin(), frame.end(), window.begin(), frame.begin(), [](const T& lhs, const T& rhs){ return lhs * rhs; });
+            
+            fourier->forward(frame.data(), real, imaginary);
+            
+            remaining = hopSize;
+            return true;
+        }
+        
+        //! Forget all buffered samples, the next frame starts at the next sample written
+        void reset()
+        {
+            std::fill(ring.begin(), ring.end(), 0);
+            position = 0;
+            remaining = ring.size();
+        }
+        
+        //! Return the number of samples in each frame
+        std::size_t getFrameSize() const { return ring.size(); }
+        
+        //! Return the number of samples between the start of two frames
+        std::size_t getHopSize() const { return hopSize; }
+        
+        //! Return the number of bins in each spectrum
+        std::size_t getBinCount() const { return real.size(); }
+        
+    private:
+        //! The Fourier transform of the frames
+        std::unique_ptr<FastFourierTransformBase> fourier;
+        
+        //! The window frames are multiplied with, or empty
+        std::vector<T> window;
+        
+        //! The last frameSize samples written
+        std::vector<T> ring;
+        
+        //! The frame being transformed, in order and windowed
+        std::vector<T> frame;
+        
+        //! The spectrum handed to the callback
+        std::vector<T> real;
+        std::vector<T> imaginary;
+        
+        //! The number of samples between the start of two frames
+        std::size_t hopSize = 0;
+        
+        //! The index in the ring the next sample is written to
+        std::size_t position = 0;
+        
+        //! The number of samples still needed to complete the next frame
+        std::size_t remaining = 0;
+    };
+}
+
+#endif /* GRIZZLY_STREAMING_SHORT_TIME_FOURIER_TRANSFORM_HPP */
@@ -0,0 +1,318 @@
+/*
+ 
+ This file is a part of Grizzly, a modern C++ library for digital signal
+ processing. See https://github.com/dsperados/grizzly for more information.
+ 
+ Copyright (C) 2016 Dsperados <info@dsperados.com>
+ 
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>
+ 
+ --------------------------------------------------------------------
+ 
+ If you would like to use Grizzly for commercial or closed-source
+ purposes, please contact us for a commercial license.
+ 
+ */
+
+#ifndef GRIZZLY_UNIFORM_PARTITIONED_CONVOLUTION_HPP
+#define GRIZZLY_UNIFORM_PARTITIONED_CONVOLUTION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "FastFourierTransform.hpp"
+#include "SplitSpectrum.hpp"
+
+namespace dsp
+{
+    //! The spectra of a kernel cut into partitions of equal size
+    /*! Partition p holds the taps [p * partitionSize, (p + 1) * partitionSize), zero-padded to twice the partition size
+        and transformed. They're computed once and can be shared by several convolvers, one per channel for example. */
+    template <class T>
+    class ConvolutionPartitions
+    {
+    public:
+        //! Partition and transform a kernel
+        /*! @param partitionSize: The number of taps in each partition, a power of two for the fastest transforms */
+        ConvolutionPartitions(std::size_t partitionSize, const T* kernel, std::size_t kernelSize) :
+            partitionSize(partitionSize),
+            binCount(checkPartitionSize(partitionSize) + 1),
+            partitionCount(std::max<std::size_t>((kernelSize + partitionSize - 1) / partitionSize, 1)),
+            real(partitionCount * binCount),
+            imaginary(partitionCount * binCount)
+        {
+            const auto fourier = createFastFourierTransform(2 * partitionSize);
+            std::vector<T> taps(2 * partitionSize);
+            for (std::size_t p = 0; p < partitionCount; ++p)
+            {
+                const auto begin = std::min(p * partitionSize, kernelSize);
+                const auto end = std::min(begin + partitionSize, kernelSize);
+                std::fill(std::copy(kernel + begin, kernel + end, taps.begin()), taps.end(), T(0));
+                
+                fourier->forward(taps.data(), getReal(p), getImaginary(p));
+            }
+        }
+        
+        //! Partition and transform a kernel
+        template <typename Iterator>
+        ConvolutionPartitions(std::size_t partitionSize, Iterator begin, Iterator end) :
+            ConvolutionPartitions(partitionSize, std::vector<T>(begin, end))
+        {
+            
+        }
+        
+        //! Return the real parts of the bins of a partition
+        const T* getReal(std::size_t partition) const { return real.data() + partition * binCount; }
+        
+        //! Return the imaginary parts of the bins of a partition
+        const T* getImaginary(std::size_t partition) const { return imaginary.data() + partition * binCount; }
+        
+        //! Return the number of taps in each partition
+        std::size_t getPartitionSize() const { return partitionSize; }
+        
+        //! Return the number of partitions
+        std::size_t getPartitionCount() const { return partitionCount; }
+        
+        //! Return the number of bins of each partition, partitionSize + 1
+        std::size_t getBinCount() const { return binCount; }
+        
+    private:
+        //! Delegate for the iterator constructor, to keep the copy alive while transforming
+        ConvolutionPartitions(std::size_t partitionSize, const std::vector<T>& kernel) :
+            ConvolutionPartitions(partitionSize, kernel.data(), kernel.size())
+        {
+            
+        }
+        
+        //! Throw if the partition size is zero, return it otherwise
+        static std::size_t checkPartitionSize(std::size_t partitionSize)
+        {
+            if (partitionSize == 0)
+                throw std::invalid_argument("ConvolutionPartitions partition size should be at least 1");
+            
+            return partitionSize;
+        }
+        
+        T* getReal(std::size_t partition) { return real.data() + partition * binCount; }
+        T* getImaginary(std::size_t partition) { return imaginary.data() + partition * binCount; }
+        
+    private:
+        //! The number of taps in each partition
+        std::size_t partitionSize = 0;
+        
+        //! The number of bins of each partition
+        std::size_t binCount = 0;
+        
+        //! The number of partitions
+        std::size_t partitionCount = 0;
+        
+        //! The real parts of the bins, partition after partition
+        std::vector<T> real;
+        
+        //! The imaginary parts of the bins, partition after partition
+        std::vector<T> imaginary;
+    };
+    
+    //! Convolution with a long kernel, by uniformly partitioned overlap-save
+    /*! The kernel is cut into partitions of the block size, which are transformed once. Every block of input is
+        transformed along with the block before it, and its spectrum goes into a frequency-domain delay line. The output
+        block is the inverse transform of the sum of the products of the last spectra in that line with the partitions,
+        computed by the vectorized multiplyAccumulate(). Per sample, that costs two transforms of twice the block size
+        divided by the block size, plus a complex multiply-add per partition, instead of a multiply-add per tap.
+        
+        processBlock() convolves whole blocks, with the output block belonging to the input block just given.
+        process() takes any number of samples, and delays the output by a block to collect them. Nothing is allocated
+        while processing. */
+    template <class T>
+    class UniformPartitionedConvolution
+    {
+    public:
+        //! Construct with a kernel
+        /*! @param blockSize: The number of samples processed at once, a power of two for the fastest transforms */
+        template <typename Iterator>
+        UniformPartitionedConvolution(std::size_t blockSize, Iterator begin, Iterator end) :
+            UniformPartitionedConvolution(std::make_shared<const ConvolutionPartitions<T>>(blockSize, begin, end))
+        {
+            
+        }
+        
+        //! Construct with a kernel that has already been partitioned, with the block size being the partition size
+        UniformPartitionedConvolution(std::shared_ptr<const ConvolutionPartitions<T>> partitions) :
+            blockSize(partitions->getPartitionSize()),
+            binCount(partitions->getBinCount()),
+            fourier(createFastFourierTransform(2 * blockSize)),
+            frame(2 * blockSize),
+            scratch(2 * blockSize),
+            accumulatorReal(binCount),
+            accumulatorImaginary(binCount),
+            inputBlock(blockSize),
+            outputBlock(blockSize)
+        {
+            setPartitions(std::move(partitions));
+        }
+        
+        //! Convolve a single block of getBlockSize() samples
+        /*! @note: The output may point to the input */
+        void processBlock(const T* input, T* output)
+        {
+            // Slide the input through the frame, which overlaps the block before it
+            std::copy(frame.begin() + blockSize, frame.end(), frame.begin());
+            std::copy(input, input + blockSize, frame.begin() + blockSize);
+            
+            position = (position + 1) % partitionCount;
+            fourier->forward(frame.data(), getDelayedReal(position), getDelayedImaginary(position));
+            
+            // Partition p multiplies the spectrum of p blocks ago
+            std::fill(accumulatorReal.begin(), accumulatorReal.end(), T(0));
+            std::fill(accumulatorImaginary.begin(), accumulatorImaginary.end(), T(0));
+            for (std::size_t p = 0; p < partitionCount; ++p)
+            {
+                const auto slot = (position + partitionCount - p) % partitionCount;
+                multiplyAccumulate(getDelayedReal(slot), getDelayedImaginary(slot), partitions->getReal(p), partitions->getImaginary(p), accumulatorReal.data(), accumulatorImaginary.data(), binCount);
+            }
+            
+            // The first half of the circular convolution wraps around, the second half is the output
+            fourier->inverse(accumulatorReal.data(), accumulatorImaginary.data(), scratch.data());
+            std::copy(scratch.begin() + blockSize, scratch.end(), output);
+        }
+        
+        //! Convolve any number of samples, with a latency of getBlockSize()
+        /*! @note: The output may point to the input */
+        void process(const T* input, T* output, std::size_t count)
+        {
+            while (count > 0)
+            {
+                const auto chunk = std::min(count, blockSize - fill);
+                for (std::size_t i = 0; i < chunk; ++i)
+                {
+                    const auto x = input[i];
+                    output[i] = outputBlock[fill + i];
+                    inputBlock[fill + i] = x;
+                }
+                
+                fill += chunk;
+                input += chunk;
+                output += chunk;
+                count -= chunk;
+                
+                if (fill == blockSize)
+                {
+                    processBlock(inputBlock.data(), outputBlock.data());
+                    fill = 0;
+                }
+            }
+        }
+        
+        //! Change the kernel
+        /*! This allocates when the number of partitions grows. The frequency-domain delay line is kept, so the new kernel
+            applies to past input as well. */
+        template <typename Iterator>
+        void setKernel(Iterator begin, Iterator end)
+        {
+            setPartitions(std::make_shared<const ConvolutionPartitions<T>>(blockSize, begin, end));
+        }
+        
+        //! Change the kernel to one that has already been partitioned
+        /*! @see setKernel() */
+        void setPartitions(std::shared_ptr<const ConvolutionPartitions<T>> partitions)
+        {
+            if (!partitions || partitions->getPartitionSize() != blockSize)
+                throw std::invalid_argument("UniformPartitionedConvolution partitions should have the block size");
+            
+            this->partitions = std::move(partitions);
+            
+            const auto count = this->partitions->getPartitionCount();
+            if (count != partitionCount)
+            {
+                partitionCount = count;
+                position = 0;
+                delayReal.assign(partitionCount * binCount, T(0));
+                delayImaginary.assign(partitionCount * binCount, T(0));
+            }
+        }
+        
+        //! Clear all input history
+        void reset()
+        {
+            std::fill(frame.begin(), frame.end(), T(0));
+            std::fill(delayReal.begin(), delayReal.end(), T(0));
+            std::fill(delayImaginary.begin(), delayImaginary.end(), T(0));
+            std::fill(inputBlock.begin(), inputBlock.end(), T(0));
+            std::fill(outputBlock.begin(), outputBlock.end(), T(0));
+            position = 0;
+            fill = 0;
+        }
+        
+        //! Return the number of samples processBlock() takes
+        std::size_t getBlockSize() const { return blockSize; }
+        
+        //! Return the number of samples process() delays the output by
+        std::size_t getLatency() const { return blockSize; }
+        
+        //! Return the partitioned kernel
+        const ConvolutionPartitions<T>& getPartitions() const { return *partitions; }
+        
+    private:
+        T* getDelayedReal(std::size_t slot) { return delayReal.data() + slot * binCount; }
+        T* getDelayedImaginary(std::size_t slot) { return delayImaginary.data() + slot * binCount; }
+        
+    private:
+        //! The number of samples in a block
+        std::size_t blockSize = 0;
+        
+        //! The number of bins of each spectrum
+        std::size_t binCount = 0;
+        
+        //! The Fourier transform, of twice the block size
+        std::unique_ptr<FastFourierTransformBase> fourier;
+        
+        //! The partitioned kernel
+        std::shared_ptr<const ConvolutionPartitions<T>> partitions;
+        
+        //! The number of partitions, and the number of spectra in the delay line
+        std::size_t partitionCount = 0;
+        
+        //! The last two blocks of input
+        std::vector<T> frame;
+        
+        //! The inverse transform of the accumulated spectrum
+        std::vector<T> scratch;
+        
+        //! The spectra of the last frames, partitionCount of them, as a circular buffer
+        std::vector<T> delayReal;
+        std::vector<T> delayImaginary;
+        
+        //! The slot in the delay line holding the spectrum of the latest frame
+        std::size_t position = 0;
+        
+        //! The sum of the products of the delayed spectra and the partitions
+        std::vector<T> accumulatorReal;
+        std::vector<T> accumulatorImaginary;
+        
+        //! The block process() is collecting input into
+        std::vector<T> inputBlock;
+        
+        //! The last output block, which process() reads from while collecting the next input block
+        std::vector<T> outputBlock;
+        
+        //! The number of samples in the input block
+        std::size_t fill = 0;
+    };
+}
+
+#endif /* GRIZZLY_UNIFORM_PARTITIONED_CONVOLUTION_HPP */
@@ -28,9 +28,11 @@
 #ifndef GRIZZLY_WINDOW_HPP
 #define GRIZZLY_WINDOW_HPP
 
+#include <algorithm>
 #include <cmath>
 #include <dsperados/math/constants.hpp>
 #include <limits>
+#include <stdexcept>
 #include <unit/radian.hpp>
 #include <vector>
 
@@ -52,7 +54,7 @@ namespace dsp
         std::vector<T> window(size);
         auto increment = 1.l / size;
         
-        for (auto i = 0; i < size; ++i)
+        for (std::size_t i = 0; i < size; ++i)
             window[i] = generateUnipolarTriangle<T>(increment * i);
         
         return window;
@@ -65,7 +67,7 @@ namespace dsp
         std::vector<T> window(size);
         auto increment = 1.l / (size-1);
         
-        for (auto i = 0; i < size; ++i)
+        for (std::size_t i = 0; i < size; ++i)
             window[i] = generateUnipolarTriangle<T>(increment * i);
         
         return window;
@@ -77,7 +79,7 @@ namespace dsp
     {
         std::vector<T> window(size);
         
-        for (auto i = 0; i < size; ++i)
+        for (std::size_t i = 0; i < size; ++i)
             window[i] = (1 - cos(math::TWO_PI<long double> * i / size)) * 0.5;
         
         return window;
@@ -89,7 +91,7 @@ namespace dsp
     {
         std::vector<T> window(size);
         
-        for (auto i = 0; i < size; ++i)
+        for (std::size_t i = 0; i < size; ++i)
             window[i] = (1 - cos(math::TWO_PI<long double> * i / (size - 1))) * 0.5;
         
         return window;
@@ -101,7 +103,7 @@ namespace dsp
     {
         std::vector<T> window(size);
         
-        for (auto i = 0; i < size; ++i)
+        for (std::size_t i = 0; i < size; ++i)
             window[i] = 0.54 - 0.46 * cos(math::TWO_PI<long double> * i / size);
         
         return window;
@@ -113,7 +115,7 @@ namespace dsp
     {
         std::vector<T> window(size);
         
-        for (auto i = 0; i < size; ++i)
+        for (std::size_t i = 0; i < size; ++i)
             window[i] = 0.54 - 0.46 * cos(math::TWO_PI<long double> * i / (size - 1));
         
         return window;
@@ -125,7 +127,7 @@ namespace dsp
     {
         std::vector<T> window(size);
         
-        for (auto i = 0; i < size; ++i)
+        for (std::size_t i = 0; i < size; ++i)
             window[i] = 0.42 - 0.5 * cos(math::TWO_PI<long double> * i / size) + 0.08 * cos(2 * math::TWO_PI<long double> * i / size);
         
         return window;
@@ -137,7 +139,7 @@ namespace dsp
     {
         std::vector<T> window(size);
         
-        for (auto i = 0; i < size; ++i)
+        for (std::size_t i = 0; i < size; ++i)
             window[i] = 0.42 - 0.5 * cos(math::TWO_PI<long double> * i / (size - 1)) + 0.08 * cos(2 * math::TWO_PI<long double> * i / (size - 1));
         
         return window;
@@ -150,7 +152,7 @@ namespace dsp
         std::vector<T> sinc(size);
 
         auto halfSize = size / 2.l;
-        for (auto i = 0; i < size; ++i)
+        for (std::size_t i = 0; i < size; ++i)
         {
             auto indexMinusHalfSize = i - halfSize;
             if (indexMinusHalfSize == 0)
@@ -169,7 +171,7 @@ namespace dsp
         std::vector<T> sinc(size);
         
         auto halfSize = (size - 1) / 2.l;
-        for (auto i = 0; i < size; ++i)
+        for (std::size_t i = 0; i < size; ++i)
         {
             auto indexMinusHalfSize = i - halfSize;
             if (indexMinusHalfSize == 0)
@@ -215,7 +217,7 @@ namespace dsp
         
         const double bb = besseli0(beta);
         
-        for (auto n = 0; n < size; ++n)
+        for (std::size_t n = 0; n < size; ++n)
             kaiser[n] = besseli0(beta * std::sqrt(4 * n * (size - n)) / size) / bb;
         
         return kaiser;
@@ -235,11 +237,42 @@ namespace dsp
         const auto sizeMinusOne = size - 1;
         const double bb = besseli0(beta);
         
-        for (auto n = 0; n < size; ++n)
+        for (std::size_t n = 0; n < size; ++n)
             kaiser[n] = besseli0(beta * std::sqrt(4 * n * (sizeMinusOne - n)) / (sizeMinusOne)) / bb;
         
         return kaiser;
     }
+    
+    //! Create the synthesis window for weighted overlap-add resynthesis
+    /*! Frames analyzed with analysisWindow, inverse transformed, multiplied with the synthesis window and overlap-added
+        at the same hop size reconstruct the original signal: the synthesis window is the analysis window divided by
+        the sum of its squares over all frames overlapping a sample. Works for any window and hop size, as long as the
+        frames overlap every sample.
+        @param analysisWindow: The window the frames were analyzed with
+        @param hopSize: The number of samples between the start of two frames
+        @throw std::invalid_argument if the hop size is zero */
+    template <typename T>
+    std::vector<T> createSynthesisWindow(const std::vector<T>& analysisWindow, std::size_t hopSize)
+    {
+        if (hopSize == 0)
+            throw std::invalid_argument("hop size should be larger than zero");
+        
+        const auto size = analysisWindow.size();
+        
+        // Sum the squares of the overlapping frames, for each position within a hop
+        std::vector<T> normalization(std::min(hopSize, size), 0);
+        for (std::size_t n = 0; n < size; ++n)
+            normalization[n % hopSize] += analysisWindow[n] * analysisWindow[n];
+        
+        std::vector<T> synthesis(size);
+        for (std::size_t n = 0; n < size; ++n)
+        {
+            const auto sum = normalization[n % hopSize];
+            synthesis[n] = (sum > std::numeric_limits<T>::min()) ? analysisWindow[n] / sum : 0;
+        }
+        
+        return synthesis;
+    }
 }
 
 #endif /* GRIZZLY_WINDOW_HPP */
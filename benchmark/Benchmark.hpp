@@ -0,0 +1,117 @@
+#ifndef GRIZZLY_BENCHMARK_HPP
+#define GRIZZLY_BENCHMARK_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+    //! A benchmark is a named function that prints its own measurements
+    using Benchmark = std::pair<std::string, std::function<void()>>;
+    
+    //! All benchmarks registered in this executable
+    inline std::vector<Benchmark>& getBenchmarks()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+    
+    //! Registers a benchmark on construction, use through BENCHMARK()
+    struct Registration
+    {
+        Registration(const std::string& name, std::function<void()> function)
+        {
+            getBenchmarks().emplace_back(name, std::move(function));
+        }
+    };
+    
+    //! Run a function until enough time has passed to get a stable measurement
+    /*! @return: The average number of nanoseconds per call */
+    template <typename Function>
+    double measure(Function&& function, std::chrono::milliseconds duration = std::chrono::milliseconds(200))
+    {
+        using Clock = std::chrono::steady_clock;
+        
+        // Warm up caches and branch predictors
+        function();
+        
+        std::size_t iterations = 0;
+        const auto begin = Clock::now();
+        auto end = begin;
+        
+        do
+        {
+            for (auto i = 0; i < 8; ++i)
+                function();
+            
+            iterations += 8;
+            end = Clock::now();
+        } while (end - begin < duration);
+        
+        return std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
+    }
+    
+    //! The number of heap allocations made so far, counted by the operator new in main.cpp
+    inline std::atomic<std::size_t>& getAllocationCounter()
+    {
+        static std::atomic<std::size_t> counter{0};
+        return counter;
+    }
+    
+    //! Return the average number of heap allocations a function makes per call
+    template <typename Function>
+    double countAllocations(Function&& function, std::size_t calls = 16)
+    {
+        // Leave lazy initialization out of the count
+        function();
+        
+        const auto begin = getAllocationCounter().load();
+        for (std::size_t i = 0; i < calls; ++i)
+            function();
+        
+        return static_cast<double>(getAllocationCounter().load() - begin) / calls;
+    }
+    
+    //! A measurement, described by labels and metrics, that ends up in the JSON report
+    struct Result
+    {
+        std::vector<std::pair<std::string, std::string>> labels;
+        std::vector<std::pair<std::string, double>> metrics;
+    };
+    
+    //! All results recorded in this executable
+    inline std::vector<Result>& getResults()
+    {
+        static std::vector<Result> results;
+        return results;
+    }
+    
+    //! Record a result for the JSON report
+    inline void record(Result result)
+    {
+        getResults().emplace_back(std::move(result));
+    }
+    
+    //! Prevent the optimizer from removing a computation whose result is unused
+    template <typename T>
+    void doNotOptimize(const T& value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+}
+
+#define GRIZZLY_BENCHMARK_CONCAT2(a, b) a##b
+#define GRIZZLY_BENCHMARK_CONCAT(a, b) GRIZZLY_BENCHMARK_CONCAT2(a, b)
+
+//! Define and register a benchmark
+#define BENCHMARK(name) \
+    static void GRIZZLY_BENCHMARK_CONCAT(benchmark, __LINE__)(); \
+    static bench::Registration GRIZZLY_BENCHMARK_CONCAT(registration, __LINE__)(name, &GRIZZLY_BENCHMARK_CONCAT(benchmark, __LINE__)); \
+    static void GRIZZLY_BENCHMARK_CONCAT(benchmark, __LINE__)()
+
+#endif
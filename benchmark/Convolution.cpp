@@ -0,0 +1,61 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../Convolution.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("Convolution")
+{
+    // Nanoseconds per output sample, for the direct and Fourier paths and the automatic choice between them. The
+    // constants in isFourierConvolutionFaster() are fitted to these: nanoseconds per multiply-add for the direct path,
+    // and per size * (log2(size) + 1) for every block of the Fourier path.
+    printf("%8s %8s %12s %12s %12s %12s %12s\n", "input", "kernel", "direct", "fourier", "convolve", "ns/madd", "ns/unit");
+    
+    for (size_t inputSize : {64, 1024, 16384, 262144})
+    {
+        for (size_t kernelSize : {4, 16, 32, 64, 128, 256, 1024, 8192})
+        {
+            if (kernelSize > inputSize)
+                continue;
+            
+            vector<float> input(inputSize), kernel(kernelSize), output(inputSize + kernelSize - 1);
+            for (size_t i = 0; i < inputSize; ++i)
+                input[i] = sin(i * 0.01f);
+            for (size_t i = 0; i < kernelSize; ++i)
+                kernel[i] = exp(-0.01f * i);
+            
+            const auto direct = bench::measure([&]{ convolveDirect(input.data(), inputSize, kernel.data(), kernelSize, output.data()); bench::doNotOptimize(output[1]); });
+            const auto fourier = bench::measure([&]{ convolveFourier(input.data(), inputSize, kernel.data(), kernelSize, output.data()); bench::doNotOptimize(output[1]); });
+            const auto automatic = bench::measure([&]{ convolve(input.data(), inputSize, kernel.data(), kernelSize, output.data()); bench::doNotOptimize(output[1]); });
+            
+            const auto size = getFourierConvolutionSize(inputSize, kernelSize);
+            const auto blockCount = (inputSize + size - kernelSize) / (size - kernelSize + 1);
+            const auto units = blockCount * size * (log2(size) + 1);
+            
+            printf("%8zu %8zu %12.3f %12.3f %12.3f %12.4f %12.4f\n", inputSize, kernelSize, direct / output.size(), fourier / output.size(), automatic / output.size(), direct / (inputSize * kernelSize), fourier / units);
+        }
+    }
+}
+
+BENCHMARK("Convolution processBlock")
+{
+    // Nanoseconds per sample for the streaming FIR, and per multiply-add of its dot product
+    printf("%8s %12s %12s\n", "kernel", "ns/sample", "ns/madd");
+    for (size_t kernelSize : {4, 16, 64, 256})
+    {
+        vector<float> kernel(kernelSize);
+        for (size_t i = 0; i < kernelSize; ++i)
+            kernel[i] = exp(-0.01f * i);
+        
+        Convolution<float> convolution(kernel.begin(), kernel.end());
+        vector<float> input(256, 0.5f), output(256);
+        
+        const auto time = bench::measure([&]{ convolution.processBlock(input.data(), output.data(), input.size()); bench::doNotOptimize(output[1]); }) / input.size();
+        printf("%8zu %12.3f %12.4f\n", kernelSize, time, time / kernelSize);
+    }
+}
@@ -0,0 +1,54 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../DiscreteCosineTransform.hpp"
+#include "../DiscreteSineTransform.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("DiscreteCosineTransform versus direct sum")
+{
+    printf("%10s %14s %14s %14s %14s %14s\n", "size", "direct (ns)", "DCT-II (ns)", "DCT-III (ns)", "DCT-IV (ns)", "DST-II (ns)");
+    
+    for (size_t size : {16, 64, 256, 1024, 4096})
+    {
+        vector<float> input(size);
+        for (size_t i = 0; i < size; ++i)
+            input[i] = sin(i * 0.01f) + 0.5f * cos(i * 0.37f);
+        
+        vector<float> output(size);
+        
+        // The direct DCT-II, with its cosines computed up front as a matrix
+        vector<float> matrix(size * size);
+        for (size_t k = 0; k < size; ++k)
+            for (size_t n = 0; n < size; ++n)
+                matrix[k * size + n] = static_cast<float>(cos(M_PI * (n + 0.5) * k / size));
+        
+        const auto directTime = bench::measure([&]
+        {
+            for (size_t k = 0; k < size; ++k)
+            {
+                float sum = 0;
+                for (size_t n = 0; n < size; ++n)
+                    sum += matrix[k * size + n] * input[n];
+                output[k] = sum;
+            }
+            
+            bench::doNotOptimize(output[1]);
+        });
+        
+        DiscreteCosineTransform dct(size);
+        DiscreteSineTransform dst(size);
+        
+        const auto twoTime = bench::measure([&]{ dct.transform(DiscreteCosineTransform::Type::II, input.data(), output.data()); bench::doNotOptimize(output[1]); });
+        const auto threeTime = bench::measure([&]{ dct.transform(DiscreteCosineTransform::Type::III, input.data(), output.data()); bench::doNotOptimize(output[1]); });
+        const auto fourTime = bench::measure([&]{ dct.transform(DiscreteCosineTransform::Type::IV, input.data(), output.data()); bench::doNotOptimize(output[1]); });
+        const auto sineTime = bench::measure([&]{ dst.transform(DiscreteSineTransform::Type::II, input.data(), output.data()); bench::doNotOptimize(output[1]); });
+        
+        printf("%10zu %14.1f %14.1f %14.1f %14.1f %14.1f\n", size, directTime, twoTime, threeTime, fourTime, sineTime);
+    }
+}
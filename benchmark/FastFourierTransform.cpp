@@ -0,0 +1,94 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../FastFourierTransform.hpp"
+#include "../Simd/FastFourierTransformSimd.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! A backend, by name and a function creating it for a size
+using Backend = pair<string, function<unique_ptr<FastFourierTransformBase>(size_t)>>;
+
+//! Return all backends available on this platform
+static vector<Backend> getBackends()
+{
+    vector<Backend> backends;
+    backends.emplace_back("ooura", [](size_t size){ return make_unique<FastFourierTransformOoura>(size); });
+    backends.emplace_back("simd", [](size_t size){ return make_unique<FastFourierTransformSimd>(size); });
+    backends.emplace_back("mixed-radix", [](size_t size){ return make_unique<FastFourierTransformMixedRadix>(size); });
+#ifdef __APPLE__
+    backends.emplace_back("accelerate", [](size_t size){ return make_unique<FastFourierTransformAccelerate>(size); });
+#endif
+    return backends;
+}
+
+//! Measure one transform, print it and record it for the JSON report
+/*! The GFLOPS are estimated the usual way, as 5 * N * log2(N) floating point operations for a complex transform,
+    and half of that for a real one */
+template <typename Function>
+static void measureTransform(const string& backend, const string& precision, const string& type, const string& direction, size_t size, Function function)
+{
+    const auto nanoseconds = bench::measure(function, chrono::milliseconds(50));
+    const auto allocations = bench::countAllocations(function);
+    
+    const auto operations = (type == "complex" ? 5.0 : 2.5) * size * log2(size);
+    const auto gflops = operations / nanoseconds;
+    
+    printf("%-12s %-7s %-8s %-8s %8zu %14.1f %8.2f %8.2f\n", backend.c_str(), precision.c_str(), type.c_str(), direction.c_str(), size, nanoseconds, gflops, allocations);
+    
+    bench::record({{{"benchmark", "FastFourierTransform suite"}, {"backend", backend}, {"precision", precision}, {"type", type}, {"direction", direction}},
+                   {{"size", size}, {"nanoseconds", nanoseconds}, {"gflops", gflops}, {"allocations", allocations}}});
+}
+
+//! Measure the real and complex, forward and inverse transforms of one backend, size and precision
+template <typename T>
+static void measureTransforms(const string& backend, const string& precision, FastFourierTransformBase& fft)
+{
+    const auto size = fft.getSize();
+    
+    vector<T> input(size);
+    vector<T> inputImaginary(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        input[i] = static_cast<T>(sin(i * 0.01));
+        inputImaginary[i] = static_cast<T>(cos(i * 0.03));
+    }
+    
+    vector<T> real(size);
+    vector<T> imaginary(size);
+    vector<T> output(size);
+    vector<T> outputImaginary(size);
+    
+    fft.forward(input.data(), real.data(), imaginary.data());
+    measureTransform(backend, precision, "real", "forward", size, [&]{ fft.forward(input.data(), real.data(), imaginary.data()); bench::doNotOptimize(real[1]); });
+    measureTransform(backend, precision, "real", "inverse", size, [&]{ fft.inverse(real.data(), imaginary.data(), output.data()); bench::doNotOptimize(output[1]); });
+    
+    fft.forwardComplex(input.data(), inputImaginary.data(), real.data(), imaginary.data());
+    measureTransform(backend, precision, "complex", "forward", size, [&]{ fft.forwardComplex(input.data(), inputImaginary.data(), real.data(), imaginary.data()); bench::doNotOptimize(real[1]); });
+    measureTransform(backend, precision, "complex", "inverse", size, [&]{ fft.inverseComplex(real.data(), imaginary.data(), output.data(), outputImaginary.data()); bench::doNotOptimize(output[1]); });
+}
+
+BENCHMARK("FastFourierTransform suite")
+{
+    // Every backend, precision, type and direction, for power of two sizes from 16 up to 2^20
+    printf("%-12s %-7s %-8s %-8s %8s %14s %8s %8s\n", "backend", "prec.", "type", "dir.", "size", "ns/transform", "GFLOPS", "allocs");
+    
+    for (auto& backend : getBackends())
+    {
+        for (size_t size = 16; size <= (1 << 20); size *= 2)
+        {
+            auto fft = backend.second(size);
+            measureTransforms<float>(backend.first, "float", *fft);
+            measureTransforms<double>(backend.first, "double", *fft);
+        }
+    }
+}
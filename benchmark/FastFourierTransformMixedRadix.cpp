@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../FastFourierTransform.hpp"
+#include "../MixedRadix/FastFourierTransformMixedRadix.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("FastFourierTransformMixedRadix broadcast frame sizes")
+{
+    printf("%10s %16s %16s %16s\n", "size", "mixed (ns)", "padded (ns)", "bluestein (ns)");
+    
+    for (size_t size : {480, 960, 1920})
+    {
+        // The power of two the frame would otherwise be zero-padded to
+        size_t padded = 1;
+        while (padded < size)
+            padded *= 2;
+        
+        // A prime size close by, which needs Bluestein's algorithm
+        size_t prime = size + 1;
+        while (FastFourierTransformMixedRadix::isFactorizable(prime) || [prime]{ for (size_t d = 2; d * d <= prime; ++d) if (prime % d == 0) return true; return false; }())
+            ++prime;
+        
+        FastFourierTransformMixedRadix mixed(size);
+        auto power = createFastFourierTransform(padded);
+        FastFourierTransformMixedRadix bluestein(prime);
+        
+        const auto largest = std::max(padded, prime);
+        vector<float> input(largest);
+        for (size_t i = 0; i < largest; ++i)
+            input[i] = sin(i * 0.01f);
+        
+        vector<float> real(largest / 2 + 1);
+        vector<float> imaginary(largest / 2 + 1);
+        
+        const auto mixedTime = bench::measure([&]{ mixed.forward(input.data(), real.data(), imaginary.data()); bench::doNotOptimize(real[1]); });
+        const auto paddedTime = bench::measure([&]{ power->forward(input.data(), real.data(), imaginary.data()); bench::doNotOptimize(real[1]); });
+        const auto bluesteinTime = bench::measure([&]{ bluestein.forward(input.data(), real.data(), imaginary.data()); bench::doNotOptimize(real[1]); });
+        
+        printf("%10zu %16.1f %16.1f %16.1f\n", size, mixedTime, paddedTime, bluesteinTime);
+    }
+}
@@ -0,0 +1,129 @@
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../Ooura/FastFourierTransformOoura.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("FastFourierTransformOoura float precision")
+{
+    printf("%10s %16s %16s %10s\n", "size", "single (ns)", "double (ns)", "speedup");
+    
+    for (size_t size = 64; size <= (1 << 16); size *= 4)
+    {
+        FastFourierTransformOoura single(size, FastFourierTransformOoura::FloatPrecision::SINGLE);
+        FastFourierTransformOoura doubled(size, FastFourierTransformOoura::FloatPrecision::DOUBLE);
+        
+        vector<float> input(size);
+        for (size_t i = 0; i < size; ++i)
+            input[i] = sin(i * 0.01f);
+        
+        vector<float> real(size / 2 + 1);
+        vector<float> imaginary(size / 2 + 1);
+        
+        const auto singleTime = bench::measure([&]{ single.forward(input.data(), real.data(), imaginary.data()); bench::doNotOptimize(real[1]); });
+        const auto doubleTime = bench::measure([&]{ doubled.forward(input.data(), real.data(), imaginary.data()); bench::doNotOptimize(real[1]); });
+        
+        printf("%10zu %16.1f %16.1f %9.2fx\n", size, singleTime, doubleTime, doubleTime / singleTime);
+    }
+}
+
+BENCHMARK("FastFourierTransformOoura threads")
+{
+    // Complex double transforms, in milliseconds, with the speedup over a single thread between parentheses
+    printf("hardware threads: %u\n", thread::hardware_concurrency());
+    printf("%10s", "size");
+    
+    const size_t threadCounts[] = {1, 2, 4, 8};
+    for (auto threadCount : threadCounts)
+        printf(" %12zu thr.", threadCount);
+    
+    printf("\n");
+    
+    for (auto size = size_t(1) << 16; size <= size_t(1) << 22; size *= 4)
+    {
+        vector<double> real(size);
+        vector<double> imaginary(size);
+        for (size_t i = 0; i < size; ++i)
+            real[i] = sin(i * 0.01);
+        
+        printf("%10zu", size);
+        
+        double singleTime = 0;
+        for (auto threadCount : threadCounts)
+        {
+            FastFourierTransformOoura fft(size);
+            fft.setThreadingThreshold(1);
+            fft.setThreadCount(threadCount);
+            
+            const auto time = bench::measure([&]{ fft.forwardComplex(real.data(), imaginary.data(), real.data(), imaginary.data()); bench::doNotOptimize(real[1]); }) / 1e6;
+            if (threadCount == 1)
+                singleTime = time;
+            
+            printf(" %8.2f (%4.2fx)", time, singleTime / time);
+        }
+        
+        printf("\n");
+    }
+}
+
+
+BENCHMARK("FastFourierTransformOoura packed filtering")
+{
+    // A forward transform, a multiplication by a filter spectrum and an inverse transform
+    printf("%10s %16s %16s %10s\n", "size", "split (ns)", "packed (ns)", "speedup");
+    
+    for (size_t size = 64; size <= (1 << 16); size *= 4)
+    {
+        FastFourierTransformOoura fft(size, FastFourierTransformOoura::FloatPrecision::SINGLE);
+        
+        vector<float> input(size);
+        vector<float> impulse(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            input[i] = sin(i * 0.01f);
+            impulse[i] = exp(-0.1f * i);
+        }
+        
+        vector<float> output(size);
+        
+        // Split spectra
+        vector<float> filterReal(size / 2 + 1), filterImaginary(size / 2 + 1);
+        fft.forward(impulse.data(), filterReal.data(), filterImaginary.data());
+        
+        vector<float> real(size / 2 + 1), imaginary(size / 2 + 1);
+        const auto splitTime = bench::measure([&]
+        {
+            fft.forward(input.data(), real.data(), imaginary.data());
+            for (size_t k = 0; k <= size / 2; ++k)
+            {
+                const auto re = real[k] * filterReal[k] - imaginary[k] * filterImaginary[k];
+                imaginary[k] = real[k] * filterImaginary[k] + imaginary[k] * filterReal[k];
+                real[k] = re;
+            }
+            
+            fft.inverse(real.data(), imaginary.data(), output.data());
+            bench::doNotOptimize(output[1]);
+        });
+        
+        // Packed spectra
+        PackedSpectrum<float> filter(size);
+        fft.forwardPacked(impulse.data(), filter);
+        
+        PackedSpectrum<float> spectrum(size);
+        const auto packedTime = bench::measure([&]
+        {
+            fft.forwardPacked(input.data(), spectrum);
+            multiply(spectrum, filter, spectrum);
+            fft.inversePacked(spectrum, output.data());
+            bench::doNotOptimize(output[1]);
+        });
+        
+        printf("%10zu %16.1f %16.1f %9.2fx\n", size, splitTime, packedTime, splitTime / packedTime);
+    }
+}
@@ -0,0 +1,83 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../Ooura/FastFourierTransformOoura.hpp"
+#include "../Simd/FastFourierTransformSimd.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("FastFourierTransformSimd instruction sets")
+{
+    printf("%10s %14s %14s %14s %14s\n", "size", "ooura (ns)", "generic (ns)", "avx2 (ns)", "avx512 (ns)");
+    
+    for (size_t size = 64; size <= (1 << 16); size *= 4)
+    {
+        FastFourierTransformOoura ooura(size);
+        
+        vector<float> input(size);
+        for (size_t i = 0; i < size; ++i)
+            input[i] = sin(i * 0.01f);
+        
+        vector<float> real(size / 2 + 1);
+        vector<float> imaginary(size / 2 + 1);
+        
+        printf("%10zu %14.1f", size, bench::measure([&]{ ooura.forward(input.data(), real.data(), imaginary.data()); bench::doNotOptimize(real[1]); }));
+        
+        for (auto instructionSet : {FastFourierTransformSimd::InstructionSet::GENERIC, FastFourierTransformSimd::InstructionSet::AVX2, FastFourierTransformSimd::InstructionSet::AVX512})
+        {
+            FastFourierTransformSimd simd(size, instructionSet);
+            if (simd.getInstructionSet() != instructionSet)
+            {
+                printf(" %14s", "-");
+                continue;
+            }
+            
+            printf(" %14.1f", bench::measure([&]{ simd.forward(input.data(), real.data(), imaginary.data()); bench::doNotOptimize(real[1]); }));
+        }
+        
+        printf("\n");
+    }
+}
+
+BENCHMARK("FastFourierTransformSimd batch")
+{
+    // Nanoseconds per frame, transforming 64 frames per call
+    const size_t count = 64;
+    printf("%10s %14s %14s %14s\n", "size", "isa", "per frame", "batch");
+    
+    for (size_t size : {64, 256, 1024, 4096})
+    {
+        vector<float> input(size * count);
+        for (size_t i = 0; i < input.size(); ++i)
+            input[i] = sin(i * 0.01f);
+        
+        vector<float> real((size / 2 + 1) * count);
+        vector<float> imaginary((size / 2 + 1) * count);
+        
+        for (auto instructionSet : {FastFourierTransformSimd::InstructionSet::GENERIC, FastFourierTransformSimd::InstructionSet::AVX2, FastFourierTransformSimd::InstructionSet::AVX512})
+        {
+            FastFourierTransformSimd simd(size, instructionSet);
+            if (simd.getInstructionSet() != instructionSet)
+                continue;
+            
+            const auto single = bench::measure([&]
+            {
+                for (size_t i = 0; i < count; ++i)
+                    simd.forward(input.data() + i * size, real.data() + i * (size / 2 + 1), imaginary.data() + i * (size / 2 + 1));
+                bench::doNotOptimize(real[1]);
+            });
+            
+            const auto batch = bench::measure([&]
+            {
+                simd.forwardBatch(input.data(), count, size, real.data(), imaginary.data(), size / 2 + 1);
+                bench::doNotOptimize(real[1]);
+            });
+            
+            printf("%10zu %14d %14.1f %14.1f\n", size, static_cast<int>(instructionSet), single / count, batch / count);
+        }
+    }
+}
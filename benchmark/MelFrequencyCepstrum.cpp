@@ -0,0 +1,64 @@
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../MelFrequencyCepstrum.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("MelFrequencyCepstrum")
+{
+    // Microseconds per 2048-point frame at 44.1kHz with 40 filters: the dense filter matrix versus the banded one, and
+    // whole MFCCs. Then a minute of frames at a hop of 512 in batch mode, in milliseconds.
+    const size_t frameSize = 2048;
+    const size_t binCount = frameSize / 2 + 1;
+    MelFrequencyCepstrum<float> cepstrum(frameSize, 44100, 40, 13);
+    const auto& bank = cepstrum.getFilterBank();
+    
+    vector<float> dense(bank.getFilterCount() * binCount);
+    for (size_t filter = 0; filter < bank.getFilterCount(); ++filter)
+        for (size_t bin = 0; bin < binCount; ++bin)
+            dense[filter * binCount + bin] = bank.getWeight(filter, bin);
+    
+    vector<float> powers(binCount), energies(bank.getFilterCount()), coefficients(13);
+    for (size_t bin = 0; bin < binCount; ++bin)
+        powers[bin] = 1 + (bin % 13);
+    
+    printf("weights stored: %zu of %zu (%.1f%%)\n", bank.getWeightCount(), dense.size(), 100.0 * bank.getWeightCount() / dense.size());
+    printf("%16s %14s\n", "", "us per frame");
+    
+    const auto denseTime = bench::measure([&]
+    {
+        for (size_t filter = 0; filter < bank.getFilterCount(); ++filter)
+        {
+            float sum = 0;
+            for (size_t bin = 0; bin < binCount; ++bin)
+                sum += dense[filter * binCount + bin] * powers[bin];
+            
+            energies[filter] = sum;
+        }
+        
+        bench::doNotOptimize(energies[0]);
+    }) / 1e3;
+    
+    const auto bandedTime = bench::measure([&]{ bank.apply(powers.data(), energies.data()); bench::doNotOptimize(energies[0]); }) / 1e3;
+    const auto cepstrumTime = bench::measure([&]{ cepstrum.compute(powers.data(), coefficients.data()); bench::doNotOptimize(coefficients[0]); }) / 1e3;
+    
+    printf("%16s %14.3f\n", "dense filters", denseTime);
+    printf("%16s %14.3f\n", "banded filters", bandedTime);
+    printf("%16s %14.3f\n", "mfcc", cepstrumTime);
+    
+    Spectrogram<float> spectrogram(44100 * 60 / 512, binCount);
+    for (size_t frame = 0; frame < spectrogram.getFrameCount(); ++frame)
+        for (size_t bin = 0; bin < binCount; ++bin)
+            spectrogram(frame, bin) = polar(1.f + (bin + frame) % 7, bin * 0.1f);
+    
+    vector<float> matrix(13 * spectrogram.getFrameCount());
+    const auto batch = bench::measure([&]{ cepstrum.compute(spectrogram, matrix.data()); bench::doNotOptimize(matrix[0]); }, chrono::milliseconds(1)) / 1e6;
+    printf("%16s %11.2f ms for %zu frames\n", "spectrogram", batch, spectrogram.getFrameCount());
+}
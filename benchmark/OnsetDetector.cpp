@@ -0,0 +1,54 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../OnsetDetector.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("OnsetDetector streams")
+{
+    // Microseconds per frame of 1024 samples, and the number of 44.1kHz streams at a hop of 256 one core keeps up with
+    const size_t frameSize = 1024;
+    const size_t hopSize = 256;
+    const size_t binCount = frameSize / 2 + 1;
+    
+    // A handful of different spectra to cycle through, so the detection function keeps moving
+    vector<vector<float>> real(8, vector<float>(binCount)), imaginary(8, vector<float>(binCount));
+    for (size_t i = 0; i < real.size(); ++i)
+    {
+        for (size_t k = 0; k < binCount; ++k)
+        {
+            real[i][k] = (1 + (i * 7 + k) % 5) * cos(k * 0.3f + i);
+            imaginary[i][k] = (1 + (i * 7 + k) % 5) * sin(k * 0.3f + i);
+        }
+    }
+    
+    printf("%34s %14s %14s %14s\n", "", "us per frame", "streams", "allocations");
+    
+    const pair<const char*, OnsetDetectionFunction> functions[] =
+    {
+        {"high-frequency content (Masri)", OnsetDetectionFunction::HIGH_FREQUENCY_CONTENT_MASRI},
+        {"spectral flux", OnsetDetectionFunction::SPECTRAL_FLUX},
+        {"complex domain", OnsetDetectionFunction::COMPLEX_DOMAIN}
+    };
+    
+    for (auto& function : functions)
+    {
+        OnsetDetector<float> detector(frameSize, hopSize, function.second);
+        auto frame = 0;
+        const auto process = [&]
+        {
+            bench::doNotOptimize(detector.process(real[frame % 8].data(), imaginary[frame % 8].data()));
+            ++frame;
+        };
+        
+        const auto time = bench::measure(process) / 1e3;
+        const auto allocations = bench::countAllocations(process);
+        printf("%34s %14.3f %14.0f %14.2f\n", function.first, time, 1e6 * hopSize / 44100.0 / time, allocations);
+    }
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../PhaseVocoder.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("PhaseVocoder stereo")
+{
+    // Stereo at 48kHz with frames of 4096 and a hop of 1024, pulled in blocks of 512 samples. The real-time factor is
+    // the duration of the output divided by the time it took to compute.
+    const size_t sampleRate = 48000;
+    const size_t blockSize = 512;
+    
+    vector<float> input(sampleRate * 10);
+    for (size_t i = 0; i < input.size(); ++i)
+        input[i] = sin(i * 0.05f) + 0.5f * sin(i * 0.173f) + 0.25f * sin(i * 0.0071f);
+    
+    printf("%10s %10s %16s %16s\n", "stretch", "shift", "real-time", "allocations");
+    
+    for (auto factors : {make_pair(1.0, 1.0), make_pair(1.25, 1.0), make_pair(0.8, 1.0), make_pair(1.0, 1.5), make_pair(1.25, 0.75)})
+    {
+        PhaseVocoder<float> left(4096, 1024, blockSize);
+        PhaseVocoder<float> right(4096, 1024, blockSize);
+        for (auto vocoder : {&left, &right})
+        {
+            vocoder->setTimeStretch(factors.first);
+            vocoder->setPitchShift(factors.second);
+        }
+        
+        size_t leftPosition = 0, rightPosition = 0;
+        vector<float> output(blockSize);
+        
+        // Produce one block per channel, writing input as it's needed and looping over the signal
+        auto pull = [&](PhaseVocoder<float>& vocoder, size_t& position)
+        {
+            while (vocoder.getAvailable() < blockSize)
+            {
+                const auto required = min(vocoder.getSamplesRequired(), input.size() - position);
+                vocoder.write(input.data() + position, required);
+                position = (position + required) % input.size();
+            }
+            
+            vocoder.read(output.data(), blockSize);
+            bench::doNotOptimize(output[0]);
+        };
+        
+        auto block = [&]{ pull(left, leftPosition); pull(right, rightPosition); };
+        
+        const auto allocations = bench::countAllocations(block, 256);
+        const auto time = bench::measure(block, chrono::milliseconds(500));
+        
+        printf("%10.2f %10.2f %15.1fx %16.2f\n", factors.first, factors.second, blockSize * 1e9 / sampleRate / time, allocations);
+    }
+}
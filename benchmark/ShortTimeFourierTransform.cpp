@@ -0,0 +1,92 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <experimental/optional>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../ShortTimeFourierTransform.hpp"
+#include "../Window.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("ShortTimeFourierTransform threads")
+{
+    // Five minutes of audio at 44.1kHz, in frames of 2048 with a hop of 512, in milliseconds
+    const size_t frameSize = 2048;
+    const size_t hopSize = 512;
+    
+    vector<float> signal(44100 * 300);
+    for (size_t i = 0; i < signal.size(); ++i)
+        signal[i] = sin(i * 0.01f) + 0.25f * cos(i * 0.37f);
+    
+    const auto window = createHanningWindow<float>(frameSize);
+    const auto windowBegin = experimental::make_optional(window.begin());
+    
+    printf("hardware threads: %u\n", thread::hardware_concurrency());
+    printf("%10s %14s %10s\n", "threads", "time (ms)", "speedup");
+    
+    const auto serialTime = bench::measure([&]{ bench::doNotOptimize(shortTimeFourierTransform(signal.begin(), signal.end(), frameSize, windowBegin, hopSize)); }, chrono::milliseconds(1)) / 1e6;
+    printf("%10s %14.1f %9.2fx\n", "serial", serialTime, 1.0);
+    
+    for (size_t threadCount : {1, 2, 4, 8, 16, 32, 64})
+    {
+        const auto time = bench::measure([&]{ bench::doNotOptimize(parallelShortTimeFourierTransform(signal.begin(), signal.end(), frameSize, windowBegin, hopSize, threadCount)); }, chrono::milliseconds(1)) / 1e6;
+        printf("%10zu %14.1f %9.2fx\n", threadCount, time, serialTime / time);
+    }
+}
+
+BENCHMARK("ShortTimeFourierTransform spectrogram")
+{
+    // One minute of audio at 44.1kHz: analysis, and the magnitude sum of every bin through time, in milliseconds
+    const size_t frameSize = 2048;
+    const size_t hopSize = 512;
+    
+    vector<float> signal(44100 * 60);
+    for (size_t i = 0; i < signal.size(); ++i)
+        signal[i] = sin(i * 0.01f) + 0.25f * cos(i * 0.37f);
+    
+    const auto window = createHanningWindow<float>(frameSize);
+    const auto windowBegin = experimental::make_optional(window.begin());
+    auto fft = createFastFourierTransform(frameSize);
+    
+    printf("%24s %14s %14s\n", "", "analysis", "track scan");
+    
+    vector<Spectrum<float>> spectra;
+    const auto spectraTime = bench::measure([&]{ spectra = shortTimeFourierTransform(signal.begin(), signal.end(), *fft, windowBegin, hopSize); }, chrono::milliseconds(1)) / 1e6;
+    const auto spectraScan = bench::measure([&]
+    {
+        for (size_t bin = 0; bin <= frameSize / 2; ++bin)
+        {
+            float sum = 0;
+            for (auto& spectrum : spectra)
+                sum += abs(spectrum[bin]);
+            
+            bench::doNotOptimize(sum);
+        }
+    }, chrono::milliseconds(1)) / 1e6;
+    
+    printf("%24s %14.2f %14.2f\n", "vector<Spectrum<float>>", spectraTime, spectraScan);
+    
+    for (auto layout : {Spectrogram<float>::Layout::FRAME_MAJOR, Spectrogram<float>::Layout::BIN_MAJOR})
+    {
+        Spectrogram<float> spectrogram(0, 0, layout);
+        const auto time = bench::measure([&]{ shortTimeFourierTransform(signal.begin(), signal.end(), *fft, windowBegin, hopSize, spectrogram); }, chrono::milliseconds(1)) / 1e6;
+        const auto scan = bench::measure([&]
+        {
+            for (size_t bin = 0; bin < spectrogram.getBinCount(); ++bin)
+            {
+                float sum = 0;
+                for (auto& value : spectrogram.getTrack(bin))
+                    sum += abs(value);
+                
+                bench::doNotOptimize(sum);
+            }
+        }, chrono::milliseconds(1)) / 1e6;
+        
+        printf("%24s %14.2f %14.2f\n", (layout == Spectrogram<float>::Layout::FRAME_MAJOR) ? "frame-major" : "bin-major", time, scan);
+    }
+}
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../HighFrequencyContent.hpp"
+#include "../SpectralCentroid.hpp"
+#include "../SpectralFeatures.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("SpectralFeatures fused")
+{
+    // Nanoseconds per bin for the whole feature set of a 2049-bin frame, one loop per feature versus the fused pass
+    const size_t size = 2049;
+    
+    vector<float> magnitudes(size), previous(size);
+    for (size_t k = 0; k < size; ++k)
+    {
+        magnitudes[k] = 1.5f + sin(k * 0.37f);
+        previous[k] = 1.5f + sin(k * 0.29f);
+    }
+    
+    const auto separate = bench::measure([&]
+    {
+        const auto centroid = spectralCentroid(magnitudes.begin(), magnitudes.end());
+        bench::doNotOptimize(centroid);
+        bench::doNotOptimize(highFrequencyContentBrossier(magnitudes.begin(), magnitudes.end()));
+        bench::doNotOptimize(highFrequencyContentMasri(magnitudes.begin(), magnitudes.end()));
+        bench::doNotOptimize(highFrequencyContentJensen(magnitudes.begin(), magnitudes.end()));
+        
+        float sum = 0, spread = 0, energy = 0, logEnergy = 0, flux = 0;
+        for (size_t k = 0; k < size; ++k)
+        {
+            sum += magnitudes[k];
+            spread += magnitudes[k] * (k - centroid) * (k - centroid);
+        }
+        
+        for (size_t k = 0; k < size; ++k)
+            energy += magnitudes[k] * magnitudes[k];
+        
+        for (size_t k = 0; k < size; ++k)
+            logEnergy += log(max(magnitudes[k] * magnitudes[k], 1e-30f));
+        
+        for (size_t k = 0; k < size; ++k)
+            flux += max(magnitudes[k] - previous[k], 0.f);
+        
+        float cumulative = 0;
+        size_t rolloff = 0;
+        while (rolloff < size - 1 && (cumulative += magnitudes[rolloff] * magnitudes[rolloff]) < 0.85f * energy)
+            ++rolloff;
+        
+        bench::doNotOptimize(sqrt(spread / sum));
+        bench::doNotOptimize(exp(logEnergy / size) / (energy / size));
+        bench::doNotOptimize(flux);
+        bench::doNotOptimize(rolloff);
+    });
+    
+    const auto fused = bench::measure([&]{ bench::doNotOptimize(computeSpectralFeatures(magnitudes.data(), previous.data(), size)); });
+    
+    printf("%12s %14s\n", "", "ns per bin");
+    printf("%12s %14.3f\n", "separate", separate / size);
+    printf("%12s %14.3f\n", "fused", fused / size);
+    
+    // The batch mode over a minute of 2048-point spectra at a hop of 512, magnitudes included, in milliseconds
+    Spectrogram<float> spectrogram(44100 * 60 / 512, size);
+    for (size_t frame = 0; frame < spectrogram.getFrameCount(); ++frame)
+        for (size_t bin = 0; bin < size; ++bin)
+            spectrogram(frame, bin) = polar(1.f + (bin + frame) % 7, bin * 0.1f);
+    
+    vector<float> matrix(SPECTRAL_FEATURE_COUNT * spectrogram.getFrameCount());
+    const auto batch = bench::measure([&]{ computeSpectralFeatures(spectrogram, matrix.data()); bench::doNotOptimize(matrix[0]); }, chrono::milliseconds(1)) / 1e6;
+    printf("%12s %11.2f ms for %zu frames\n", "spectrogram", batch, spectrogram.getFrameCount());
+}
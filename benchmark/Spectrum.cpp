@@ -0,0 +1,51 @@
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../HighFrequencyContent.hpp"
+#include "../SpectralCentroid.hpp"
+#include "../Spectrum.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("Spectrum feature queries")
+{
+    // Microseconds for a centroid and the three high-frequency contents on one frame, recomputing or caching the magnitudes
+    const size_t size = 2049;
+    
+    Spectrum<float> spectrum{vector<complex<float>>(size)};
+    for (size_t k = 0; k < size; ++k)
+        spectrum[k] = polar(1.f + k % 13, k * 0.1f);
+    
+    // The magnitudes used to be returned by value: a fresh allocation and pass for every query
+    const auto recomputed = bench::measure([&]
+    {
+        const auto query = [&]{ spectrum.invalidate(); return vector<float>(spectrum.magnitudes()); };
+        const auto centroid = query();
+        bench::doNotOptimize(spectralCentroid(centroid.begin(), centroid.end()));
+        const auto brossier = query();
+        bench::doNotOptimize(highFrequencyContentBrossier(brossier.begin(), brossier.end()));
+        const auto masri = query();
+        bench::doNotOptimize(highFrequencyContentMasri(masri.begin(), masri.end()));
+        const auto jensen = query();
+        bench::doNotOptimize(highFrequencyContentJensen(jensen.begin(), jensen.end()));
+    }) / 1e3;
+    
+    // Now the first query of a new frame fills the cache and the rest reuse it
+    const auto cached = bench::measure([&]
+    {
+        spectrum.invalidate();
+        bench::doNotOptimize(spectralCentroid(spectrum.magnitudes().begin(), spectrum.magnitudes().end()));
+        bench::doNotOptimize(highFrequencyContentBrossier(spectrum.magnitudes().begin(), spectrum.magnitudes().end()));
+        bench::doNotOptimize(highFrequencyContentMasri(spectrum.magnitudes().begin(), spectrum.magnitudes().end()));
+        bench::doNotOptimize(highFrequencyContentJensen(spectrum.magnitudes().begin(), spectrum.magnitudes().end()));
+    }) / 1e3;
+    
+    printf("%12s %14s\n", "", "time (us)");
+    printf("%12s %14.2f\n", "recomputed", recomputed);
+    printf("%12s %14.2f\n", "cached", cached);
+}
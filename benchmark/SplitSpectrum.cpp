@@ -0,0 +1,57 @@
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../SplitSpectrum.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("SplitSpectrum conversions")
+{
+    // Nanoseconds per bin, for the interleaved Spectrum members and the split kernels
+    const size_t size = 4097;
+    
+    Spectrum<float> interleaved{vector<complex<float>>(size)};
+    for (size_t k = 0; k < size; ++k)
+        interleaved[k] = polar(1.f + k % 13, k * 0.1f);
+    
+    SplitSpectrum<float> split(interleaved);
+    vector<float> magnitudes(size), phases(size);
+    split.magnitudes(magnitudes.data());
+    split.phases(phases.data());
+    
+    printf("%12s %14s %14s %14s\n", "", "Spectrum", "exact", "fast");
+    
+    const auto print = [&](const char* name, double reference, double exact, double fast)
+    {
+        printf("%12s %14.3f %14.3f %14.3f\n", name, reference / size, exact / size, fast / size);
+    };
+    
+    print("magnitudes",
+          bench::measure([&]{ interleaved.invalidate(); bench::doNotOptimize(interleaved.magnitudes()); }),
+          bench::measure([&]{ split.magnitudes(magnitudes.data()); bench::doNotOptimize(magnitudes[1]); }),
+          bench::measure([&]{ split.magnitudes(magnitudes.data(), SpectrumAccuracy::FAST); bench::doNotOptimize(magnitudes[1]); }));
+    
+    print("phases",
+          bench::measure([&]{ interleaved.invalidate(); bench::doNotOptimize(interleaved.phases()); }),
+          bench::measure([&]{ split.phases(phases.data()); bench::doNotOptimize(phases[1]); }),
+          bench::measure([&]{ split.phases(phases.data(), SpectrumAccuracy::FAST); bench::doNotOptimize(phases[1]); }));
+    
+    vector<float> decibels(size);
+    print("decibels",
+          bench::measure([&]{ for (size_t k = 0; k < size; ++k) decibels[k] = 20 * log10(max(abs(interleaved[k]), 1e-10f)); bench::doNotOptimize(decibels[1]); }),
+          bench::measure([&]{ split.decibels(decibels.data()); bench::doNotOptimize(decibels[1]); }),
+          bench::measure([&]{ split.decibels(decibels.data(), -200, SpectrumAccuracy::FAST); bench::doNotOptimize(decibels[1]); }));
+    
+    split.magnitudes(magnitudes.data());
+    split.phases(phases.data());
+    const auto magnitudeVector = magnitudes;
+    print("polar",
+          bench::measure([&]{ interleaved.replaceMagnitudes(magnitudeVector); bench::doNotOptimize(interleaved[1]); }),
+          bench::measure([&]{ split.setPolar(magnitudes.data(), phases.data()); bench::doNotOptimize(split.real[1]); }),
+          bench::measure([&]{ split.setPolar(magnitudes.data(), phases.data(), SpectrumAccuracy::FAST); bench::doNotOptimize(split.real[1]); }));
+}
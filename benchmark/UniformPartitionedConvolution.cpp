@@ -0,0 +1,31 @@
+#include <cstdio>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+#include "../Convolution.hpp"
+#include "../UniformPartitionedConvolution.hpp"
+
+using namespace dsp;
+using namespace std;
+
+BENCHMARK("UniformPartitionedConvolution")
+{
+    // Nanoseconds per sample for a second of reverb at 48 kHz, against a direct convolution of the same block
+    const size_t kernelSize = 48000;
+    vector<float> kernel(kernelSize);
+    for (size_t i = 0; i < kernelSize; ++i)
+        kernel[i] = (static_cast<int>(i % 7) - 3) * (1.f - float(i) / kernelSize);
+    
+    printf("%8s %14s %14s\n", "block", "partitioned", "direct");
+    for (size_t blockSize : {64, 256, 1024, 4096})
+    {
+        UniformPartitionedConvolution<float> convolution(blockSize, kernel.begin(), kernel.end());
+        vector<float> input(blockSize, 0.5f), output(blockSize), direct(blockSize + kernelSize - 1);
+        
+        const auto partitioned = bench::measure([&]{ convolution.processBlock(input.data(), output.data()); bench::doNotOptimize(output[1]); });
+        const auto reference = bench::measure([&]{ convolveDirect(input.data(), blockSize, kernel.data(), kernelSize, direct.data()); bench::doNotOptimize(direct[1]); });
+        
+        printf("%8zu %14.3f %14.3f\n", blockSize, partitioned / blockSize, reference / blockSize);
+    }
+}
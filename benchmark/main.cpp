@@ -0,0 +1,119 @@
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "Benchmark.hpp"
+
+using namespace std;
+
+// Count every heap allocation, for bench::countAllocations()
+void* operator new(size_t size)
+{
+    ++bench::getAllocationCounter();
+    
+    if (void* pointer = malloc(size ? size : 1))
+        return pointer;
+    
+    throw bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+//! Write a string as a JSON string literal
+static void writeString(ostream& stream, const string& text)
+{
+    stream << '"';
+    for (auto c : text)
+    {
+        if (c == '"' || c == '\\')
+            stream << '\\';
+        stream << c;
+    }
+    stream << '"';
+}
+
+//! Write all recorded results as a JSON array of objects
+static void writeJson(ostream& stream)
+{
+    stream.precision(10);
+    stream << "[\n";
+    
+    const auto& results = bench::getResults();
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        stream << "  {";
+        
+        auto first = true;
+        for (auto& label : results[i].labels)
+        {
+            stream << (first ? "" : ", ");
+            writeString(stream, label.first);
+            stream << ": ";
+            writeString(stream, label.second);
+            first = false;
+        }
+        
+        for (auto& metric : results[i].metrics)
+        {
+            stream << (first ? "" : ", ");
+            writeString(stream, metric.first);
+            stream << ": " << metric.second;
+            first = false;
+        }
+        
+        stream << (i + 1 < results.size() ? "},\n" : "}\n");
+    }
+    
+    stream << "]\n";
+}
+
+//! Run all benchmarks, or only those whose name contains the filter
+/*! Usage: grizzly-bench [filter] [--json file], where the recorded results are written to file as JSON */
+int main(int argc, char** argv)
+{
+    string filter;
+    const char* jsonPath = nullptr;
+    
+    for (auto i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else
+            filter = argv[i];
+    }
+    
+    for (auto& benchmark : bench::getBenchmarks())
+    {
+        if (benchmark.first.find(filter) == string::npos)
+            continue;
+        
+        cout << "--- " << benchmark.first << " ---" << endl;
+        benchmark.second();
+        cout << endl;
+    }
+    
+    if (jsonPath)
+    {
+        ofstream file(jsonPath);
+        if (!file)
+        {
+            cerr << "Could not open " << jsonPath << endl;
+            return 1;
+        }
+        
+        writeJson(file);
+    }
+    
+    return 0;
+}
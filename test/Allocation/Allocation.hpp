@@ -0,0 +1,18 @@
+#ifndef GRIZZLY_TEST_ALLOCATION_HPP
+#define GRIZZLY_TEST_ALLOCATION_HPP
+
+#include <cstddef>
+
+//! The number of heap allocations made by this executable so far
+std::size_t& getAllocationCount();
+
+//! Return the number of heap allocations done by a function
+template <typename Function>
+std::size_t countAllocationsOf(Function function)
+{
+    const auto begin = getAllocationCount();
+    function();
+    return getAllocationCount() - begin;
+}
+
+#endif /* GRIZZLY_TEST_ALLOCATION_HPP */
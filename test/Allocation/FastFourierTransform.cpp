@@ -0,0 +1,70 @@
+#include <complex>
+#include <vector>
+
+#include "../doctest.h"
+
+#include "../../MixedRadix/FastFourierTransformMixedRadix.hpp"
+#include "../../Ooura/FastFourierTransformOoura.hpp"
+#include "../../Simd/FastFourierTransformSimd.hpp"
+
+#include "Allocation.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Check that the overloads writing to caller-owned memory don't allocate, right after construction
+template <typename T>
+static void checkAllocationFree(FastFourierTransformBase& fft)
+{
+    const auto size = fft.getSize();
+    
+    vector<T> signal(size, 0.5);
+    vector<complex<T>> spectrum(size / 2 + 1);
+    vector<complex<T>> complexSignal(size, {0.5, 0.25});
+    vector<complex<T>> complexSpectrum(size);
+    vector<T> real(size);
+    vector<T> imaginary(size);
+    PackedSpectrum<T> packed(size);
+    
+    CHECK(countAllocationsOf([&]{ fft.forward(signal.data(), spectrum.begin()); }) == 0);
+    CHECK(countAllocationsOf([&]{ fft.inverse(spectrum.begin(), signal.data()); }) == 0);
+    CHECK(countAllocationsOf([&]{ fft.forwardComplex(complexSignal.begin(), complexSpectrum.begin()); }) == 0);
+    CHECK(countAllocationsOf([&]{ fft.inverseComplex(complexSpectrum.begin(), complexSignal.begin()); }) == 0);
+    CHECK(countAllocationsOf([&]{ fft.forward(signal.data(), real.data(), imaginary.data()); }) == 0);
+    CHECK(countAllocationsOf([&]{ fft.inverse(real.data(), imaginary.data(), signal.data()); }) == 0);
+    CHECK(countAllocationsOf([&]{ fft.forwardPacked(signal.data(), packed); }) == 0);
+    CHECK(countAllocationsOf([&]{ fft.inversePacked(packed, signal.data()); }) == 0);
+    
+    for (auto& x : signal)
+        CHECK(x == doctest::Approx(0.5));
+    
+    for (auto& x : complexSignal)
+    {
+        CHECK(x.real() == doctest::Approx(0.5));
+        CHECK(x.imag() == doctest::Approx(0.25));
+    }
+}
+
+TEST_CASE("FastFourierTransform allocations")
+{
+    SUBCASE("Ooura")
+    {
+        FastFourierTransformOoura fft(16);
+        checkAllocationFree<float>(fft);
+        checkAllocationFree<double>(fft);
+    }
+    
+    SUBCASE("Simd")
+    {
+        FastFourierTransformSimd fft(16);
+        checkAllocationFree<float>(fft);
+        checkAllocationFree<double>(fft);
+    }
+    
+    SUBCASE("MixedRadix")
+    {
+        FastFourierTransformMixedRadix fft(12);
+        checkAllocationFree<float>(fft);
+        checkAllocationFree<double>(fft);
+    }
+}
@@ -0,0 +1,53 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#define DOCTEST_CONFIG_COLORS_NONE
+#include "../doctest.h"
+
+#include <cstdlib>
+#include <new>
+
+#include "Allocation.hpp"
+
+using namespace std;
+
+// Replace the global allocation functions to count every heap allocation. This executable is kept apart from
+// grizzly-test, so the replacement doesn't affect the other tests.
+void* operator new(size_t size)
+{
+    ++getAllocationCount();
+    
+    if (void* pointer = malloc(size ? size : 1))
+        return pointer;
+    
+    throw bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+size_t& getAllocationCount()
+{
+    static size_t count = 0;
+    return count;
+}
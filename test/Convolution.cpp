@@ -1,12 +1,54 @@
+#include <algorithm>
+#include <cmath>
+#include <list>
 #include <vector>
 
 #include "doctest.h"
 
 #include "../Convolution.hpp"
 
+#include "ConvolutionFixtures.hpp"
+
 using namespace dsp;
 using namespace std;
 
+//! Convolve straight from the definition, in long double
+template <typename T>
+static vector<long double> referenceConvolve(const vector<T>& input, const vector<T>& kernel)
+{
+	vector<long double> output(input.size() + kernel.size() - 1);
+	for (size_t n = 0; n < output.size(); ++n)
+		for (size_t h = 0; h < kernel.size(); ++h)
+			if (n >= h && n - h < input.size())
+				output[n] += static_cast<long double>(kernel[h]) * input[n - h];
+
+	return output;
+}
+
+template <typename T>
+static void checkFourierConvolution(long double tolerance)
+{
+	const vector<pair<size_t, size_t>> sizes = {{1, 1}, {5, 3}, {3, 5}, {64, 64}, {100, 7}, {1000, 300}, {4097, 1000}, {300, 20000}};
+	for (auto& size : sizes)
+	{
+		vector<T> input(size.first), kernel(size.second);
+		for (size_t i = 0; i < input.size(); ++i)
+			input[i] = sin(i * 0.3) + cos(i * 0.0071);
+		for (size_t i = 0; i < kernel.size(); ++i)
+			kernel[i] = exp(-0.01 * i) * cos(i * 1.3);
+
+		const auto reference = referenceConvolve(input, kernel);
+		vector<T> direct(reference.size()), fourier(reference.size()), automatic(reference.size());
+		convolveDirect(input.data(), input.size(), kernel.data(), kernel.size(), direct.data());
+		convolveFourier(input.data(), input.size(), kernel.data(), kernel.size(), fourier.data());
+		convolve(input.data(), input.size(), kernel.data(), kernel.size(), automatic.data());
+
+		CHECK(getRelativeError(direct, reference) < tolerance);
+		CHECK(getRelativeError(fourier, reference) < tolerance);
+		CHECK(getRelativeError(automatic, reference) < tolerance);
+	}
+}
+
 TEST_CASE("Convolution")
 {
 	SUBCASE("Construction by ")
@@ -47,6 +89,56 @@ TEST_CASE("Convolution")
 		CHECK(convolution.getKernel() == kernel);
 	}
 
+	SUBCASE("processBlock()")
+	{
+		vector<float> input(300), kernel(37);
+		for (size_t i = 0; i < input.size(); ++i)
+			input[i] = sin(i * 0.7f);
+		for (size_t i = 0; i < kernel.size(); ++i)
+			kernel[i] = 1.f / (i + 1);
+
+		const auto expected = convolve(input.begin(), input.end(), kernel.begin(), kernel.end());
+
+		// Blocks of uneven sizes, in place, mixed with single samples
+		Convolution<float> convolution(kernel.begin(), kernel.end());
+		auto output = input;
+		for (size_t i = 0, block = 1; i < output.size(); i += block, block = block % 23 + 2)
+		{
+			block = min(block, output.size() - i);
+			if (block == 2)
+				for (auto j = i; j < i + block; ++j)
+					output[j] = convolution(output[j]);
+			else
+				convolution.processBlock(output.data() + i, output.data() + i, block);
+		}
+
+		for (size_t i = 0; i < output.size(); ++i)
+			CHECK(output[i] == doctest::Approx(expected[i]).epsilon(1e-5));
+
+		convolution.reset();
+		CHECK(convolution(1) == doctest::Approx(1));
+		CHECK(convolution(0) == doctest::Approx(0.5));
+	}
+
+	SUBCASE("setKernel() keeps the history")
+	{
+		Convolution<int> convolution = { 1, 1, 1, 1 };
+		for (auto x : { 1, 2, 3, 4 })
+			convolution(x);
+
+		const vector<int> longer = { 0, 0, 1, 1 };
+		convolution.setKernel(longer.begin(), longer.end());
+		CHECK(convolution(5) == 5);
+		CHECK(convolution(6) == 7);
+
+		const vector<int> shorter = { 1, 10 };
+		convolution.setKernel(shorter.begin(), shorter.end());
+		CHECK(convolution(7) == 67);
+
+		Convolution<int> empty = {};
+		CHECK(empty(3) == 0);
+	}
+
 	SUBCASE("convolve()")
 	{
 		std::vector<float> input = { 1, 0, 0, 0 };
@@ -61,4 +153,33 @@ TEST_CASE("Convolution")
 		CHECK(result[3] == doctest::Approx(0));
 		CHECK(result[4] == doctest::Approx(0));
 	}
+
+	SUBCASE("convolve() tail")
+	{
+		const vector<int> input = { 1, 2 };
+		const list<int> kernel = { 1, 2, 3 };
+
+		CHECK(convolve(input.begin(), input.end(), kernel.begin(), kernel.end()) == vector<int>({ 1, 4, 7, 6 }));
+		CHECK(convolve(input.begin(), input.end(), kernel.begin(), kernel.begin()).empty());
+	}
+
+	SUBCASE("convolve() with the Fourier transform")
+	{
+		checkFourierConvolution<float>(1e-5);
+		checkFourierConvolution<double>(1e-12);
+	}
+
+	SUBCASE("Choice between direct and Fourier convolution")
+	{
+		CHECK(!isFourierConvolutionFaster(1, 1));
+		CHECK(!isFourierConvolutionFaster(16384, 4));
+		CHECK(!isFourierConvolutionFaster(4, 16384));
+		CHECK(isFourierConvolutionFaster(16384, 1024));
+		CHECK(isFourierConvolutionFaster(1024, 16384));
+
+		// Long inputs are partitioned in blocks a few times the size of the kernel
+		CHECK(getFourierConvolutionSize(1 << 20, 1000) >= 2048);
+		CHECK(getFourierConvolutionSize(1 << 20, 1000) <= 16384);
+		CHECK(getFourierConvolutionSize(1000, 1000) == 2048);
+	}
 }
\ No newline at end of file
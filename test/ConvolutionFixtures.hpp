@@ -0,0 +1,62 @@
+#ifndef GRIZZLY_TEST_CONVOLUTION_FIXTURES_HPP
+#define GRIZZLY_TEST_CONVOLUTION_FIXTURES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+#include "../Convolution.hpp"
+
+//! Return a buffer of noise
+template <typename T>
+std::vector<T> createNoise(std::size_t size, unsigned int seed)
+{
+    std::srand(seed);
+    std::vector<T> noise(size);
+    for (auto& x : noise)
+        x = std::rand() / T(RAND_MAX) - T(0.5);
+    
+    return noise;
+}
+
+//! Return a decaying noise kernel, like a reverb impulse response
+template <typename T>
+std::vector<T> createKernel(std::size_t size)
+{
+    auto kernel = createNoise<T>(size, 7);
+    for (std::size_t i = 0; i < size; ++i)
+        kernel[i] *= std::exp(T(-3) * i / size);
+    
+    return kernel;
+}
+
+//! Return the first samples of the direct convolution of an input and a kernel
+template <typename T>
+std::vector<T> convolveReference(const std::vector<T>& input, const std::vector<T>& kernel)
+{
+    std::vector<T> output(input.size() + kernel.size() - 1);
+    dsp::convolveDirect(input.data(), input.size(), kernel.data(), kernel.size(), output.data());
+    output.resize(input.size());
+    
+    return output;
+}
+
+//! Return the largest difference between two buffers, relative to the largest sample of the second
+/*! The difference is computed in the precision of the expected buffer, which may be higher than that of the output */
+template <typename T, typename Expected>
+Expected getRelativeError(const std::vector<T>& output, const std::vector<Expected>& expected)
+{
+    Expected error = 0;
+    Expected peak = 0;
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        error = std::max(error, std::abs(output[i] - expected[i]));
+        peak = std::max(peak, std::abs(expected[i]));
+    }
+    
+    return error / peak;
+}
+
+#endif /* GRIZZLY_TEST_CONVOLUTION_FIXTURES_HPP */
@@ -47,6 +47,11 @@ TEST_CASE("Delay")
         
         REQUIRE_NOTHROW(delay.read(-0.2));
         CHECK(delay.read(-0.2) == doctest::Approx(1));
+        
+        // Whole sample delays are clamped the same way
+        CHECK(delay.read(5) == 0);
+        CHECK(delay.read(-3) == 1);
+        CHECK(delay.read(size_t(1)) == 0);
     }
     
     SUBCASE("resize()")
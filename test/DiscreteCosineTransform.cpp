@@ -0,0 +1,96 @@
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../DiscreteCosineTransform.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Direct sum of a cosine transform to compare against
+static vector<double> directCosineTransform(DiscreteCosineTransform::Type type, const vector<double>& input)
+{
+    const auto size = input.size();
+    vector<double> output(size);
+    
+    for (size_t k = 0; k < size; ++k)
+    {
+        for (size_t n = 0; n < size; ++n)
+        {
+            switch (type)
+            {
+                case DiscreteCosineTransform::Type::II: output[k] += input[n] * cos(M_PI * (n + 0.5) * k / size); break;
+                case DiscreteCosineTransform::Type::III: output[k] += (n == 0 ? 0.5 : 1.0) * input[n] * cos(M_PI * n * (k + 0.5) / size); break;
+                case DiscreteCosineTransform::Type::IV: output[k] += input[n] * cos(M_PI * (n + 0.5) * (k + 0.5) / size); break;
+            }
+        }
+    }
+    
+    return output;
+}
+
+template <typename T>
+static void testTransform(std::size_t size, double epsilon)
+{
+    DiscreteCosineTransform dct(size);
+    CHECK(dct.getSize() == size);
+    
+    vector<T> input(size);
+    vector<double> reference(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        input[i] = sin(i * 0.37) + 0.25 * cos(i * 1.3) + 0.1;
+        reference[i] = input[i];
+    }
+    
+    for (auto type : {DiscreteCosineTransform::Type::II, DiscreteCosineTransform::Type::III, DiscreteCosineTransform::Type::IV})
+    {
+        const auto expected = directCosineTransform(type, reference);
+        
+        vector<T> output(size);
+        dct.transform(type, input.data(), output.data());
+        for (size_t k = 0; k < size; ++k)
+            CHECK(output[k] == doctest::Approx(expected[k]).epsilon(epsilon));
+        
+        // In-place
+        auto inPlace = input;
+        dct.transform(type, inPlace.data(), inPlace.data());
+        CHECK(inPlace == output);
+    }
+    
+    // Round trip
+    vector<T> spectrum(size);
+    dct.forward(input.data(), spectrum.data());
+    
+    vector<T> output(size);
+    dct.inverse(spectrum.data(), output.data());
+    for (size_t i = 0; i < size; ++i)
+        CHECK(output[i] == doctest::Approx(input[i]).epsilon(epsilon));
+    
+    // DCT-IV is its own inverse
+    dct.transform(DiscreteCosineTransform::Type::IV, input.data(), spectrum.data());
+    dct.transform(DiscreteCosineTransform::Type::IV, spectrum.data(), output.data());
+    for (size_t i = 0; i < size; ++i)
+        CHECK(output[i] * 2 / size == doctest::Approx(input[i]).epsilon(epsilon));
+}
+
+TEST_CASE("DiscreteCosineTransform")
+{
+    SUBCASE("Sizes")
+    {
+        CHECK_THROWS_AS(DiscreteCosineTransform(0), std::invalid_argument);
+        CHECK_THROWS_AS(DiscreteCosineTransform(1), std::invalid_argument);
+        CHECK_THROWS_AS(DiscreteCosineTransform(12), std::invalid_argument);
+    }
+    
+    SUBCASE("Transforms")
+    {
+        for (std::size_t size : {2, 4, 8, 16, 64, 512})
+        {
+            testTransform<float>(size, 1e-3);
+            testTransform<double>(size, 1e-9);
+        }
+    }
+}
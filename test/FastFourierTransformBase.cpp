@@ -0,0 +1,62 @@
+#include <complex>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../Ooura/FastFourierTransformOoura.hpp"
+
+using namespace dsp;
+using namespace std;
+
+TEST_CASE("FastFourierTransformBase")
+{
+    const size_t size = 16;
+    FastFourierTransformOoura fft(size);
+    
+    SUBCASE("Batch")
+    {
+        // Default implementation, transforming the frames one by one
+        const size_t count = 3;
+        const size_t stride = size + 2;
+        vector<float> frames(count * stride);
+        for (size_t i = 0; i < frames.size(); ++i)
+            frames[i] = sin(i * 0.3f);
+        
+        vector<float> real(count * stride);
+        vector<float> imaginary(count * stride);
+        fft.forwardBatch(frames.data(), count, stride, real.data(), imaginary.data(), stride);
+        
+        vector<float> expectedReal(size / 2 + 1);
+        vector<float> expectedImaginary(size / 2 + 1);
+        vector<float> output(count * stride);
+        fft.inverseBatch(real.data(), imaginary.data(), count, stride, output.data(), stride);
+        
+        for (size_t frame = 0; frame < count; ++frame)
+        {
+            fft.forward(frames.data() + frame * stride, expectedReal.data(), expectedImaginary.data());
+            for (size_t k = 0; k <= size / 2; ++k)
+            {
+                CHECK(real[frame * stride + k] == doctest::Approx(expectedReal[k]));
+                CHECK(imaginary[frame * stride + k] == doctest::Approx(expectedImaginary[k]));
+            }
+            
+            for (size_t i = 0; i < size; ++i)
+                CHECK(output[frame * stride + i] == doctest::Approx(frames[frame * stride + i]));
+        }
+    }
+    
+    SUBCASE("Returning overloads")
+    {
+        vector<float> signal(size, 1.f);
+        auto spectrum = fft.forward(signal.data());
+        
+        REQUIRE(spectrum.size() == size / 2 + 1);
+        CHECK(spectrum[0].real() == doctest::Approx(size));
+        CHECK(spectrum[1].real() == doctest::Approx(0));
+        
+        auto output = fft.inverse(spectrum.begin());
+        REQUIRE(output.size() == size);
+        for (auto& x : output)
+            CHECK(x == doctest::Approx(1));
+    }
+}
@@ -0,0 +1,163 @@
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../FastFourierTransform.hpp"
+#include "../MixedRadix/FastFourierTransformMixedRadix.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Naive discrete Fourier transform to compare against
+static vector<complex<double>> dft(const vector<complex<double>>& input)
+{
+    const auto size = input.size();
+    vector<complex<double>> output(size);
+    
+    for (size_t k = 0; k < size; ++k)
+        for (size_t n = 0; n < size; ++n)
+            output[k] += input[n] * polar(1.0, -2 * M_PI * ((k * n) % size) / size);
+    
+    return output;
+}
+
+template <typename T>
+static void testTransform(FastFourierTransformMixedRadix& fft, std::size_t size, double epsilon)
+{
+    vector<T> inputReal(size);
+    vector<T> inputImaginary(size);
+    vector<complex<double>> input(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        inputReal[i] = sin(i * 0.37) + 0.25 * cos(i * 1.3);
+        inputImaginary[i] = cos(i * 0.91) - 0.5;
+        input[i] = {static_cast<double>(inputReal[i]), static_cast<double>(inputImaginary[i])};
+    }
+    
+    // Real
+    {
+        vector<complex<double>> realInput(size);
+        for (size_t i = 0; i < size; ++i)
+            realInput[i] = inputReal[i];
+        
+        const auto expected = dft(realInput);
+        
+        vector<T> real(size / 2 + 1);
+        vector<T> imaginary(size / 2 + 1);
+        fft.forward(inputReal.data(), real.data(), imaginary.data());
+        
+        for (size_t k = 0; k <= size / 2; ++k)
+        {
+            CHECK(real[k] == doctest::Approx(expected[k].real()).epsilon(epsilon));
+            CHECK(imaginary[k] == doctest::Approx(expected[k].imag()).epsilon(epsilon));
+        }
+        
+        vector<T> output(size);
+        fft.inverse(real.data(), imaginary.data(), output.data());
+        
+        for (size_t i = 0; i < size; ++i)
+            CHECK(output[i] == doctest::Approx(inputReal[i]).epsilon(epsilon));
+    }
+    
+    // Complex
+    {
+        const auto expected = dft(input);
+        
+        vector<T> real(size);
+        vector<T> imaginary(size);
+        fft.forwardComplex(inputReal.data(), inputImaginary.data(), real.data(), imaginary.data());
+        
+        for (size_t k = 0; k < size; ++k)
+        {
+            CHECK(real[k] == doctest::Approx(expected[k].real()).epsilon(epsilon));
+            CHECK(imaginary[k] == doctest::Approx(expected[k].imag()).epsilon(epsilon));
+        }
+        
+        // In-place
+        fft.inverseComplex(real.data(), imaginary.data(), real.data(), imaginary.data());
+        
+        for (size_t i = 0; i < size; ++i)
+        {
+            CHECK(real[i] == doctest::Approx(inputReal[i]).epsilon(epsilon));
+            CHECK(imaginary[i] == doctest::Approx(inputImaginary[i]).epsilon(epsilon));
+        }
+    }
+}
+
+TEST_CASE("FastFourierTransformMixedRadix")
+{
+    SUBCASE("Factorization")
+    {
+        CHECK(FastFourierTransformMixedRadix::isFactorizable(1));
+        CHECK(FastFourierTransformMixedRadix::isFactorizable(480));
+        CHECK(FastFourierTransformMixedRadix::isFactorizable(1920));
+        CHECK(FastFourierTransformMixedRadix::isFactorizable(2 * 3 * 5 * 7 * 7));
+        CHECK(!FastFourierTransformMixedRadix::isFactorizable(11));
+        CHECK(!FastFourierTransformMixedRadix::isFactorizable(2 * 13));
+        CHECK_THROWS_AS(FastFourierTransformMixedRadix(0), std::invalid_argument);
+    }
+    
+    SUBCASE("Mixed radix")
+    {
+        for (std::size_t size : {1, 2, 3, 5, 6, 7, 9, 12, 15, 20, 35, 49, 60, 210, 480})
+        {
+            FastFourierTransformMixedRadix fft(size);
+            CHECK(!fft.usesBluestein());
+            
+            testTransform<float>(fft, size, 1e-3);
+            testTransform<double>(fft, size, 1e-9);
+        }
+    }
+    
+    SUBCASE("Bluestein")
+    {
+        for (std::size_t size : {11, 13, 22, 97, 101, 254})
+        {
+            FastFourierTransformMixedRadix fft(size);
+            CHECK(fft.usesBluestein());
+            
+            testTransform<float>(fft, size, 1e-3);
+            testTransform<double>(fft, size, 1e-9);
+        }
+    }
+    
+    SUBCASE("Packed")
+    {
+        // The default implementation, packing the split spectrum
+        const size_t size = 60;
+        FastFourierTransformMixedRadix fft(size);
+        
+        vector<double> input(size);
+        for (size_t i = 0; i < size; ++i)
+            input[i] = sin(i * 0.37) + 0.25 * cos(i * 1.3);
+        
+        vector<double> real(size / 2 + 1), imaginary(size / 2 + 1);
+        fft.forward(input.data(), real.data(), imaginary.data());
+        
+        PackedSpectrum<double> spectrum(size);
+        fft.forwardPacked(input.data(), spectrum);
+        for (size_t k = 0; k <= size / 2; ++k)
+        {
+            CHECK(spectrum.getBin(k).real() == doctest::Approx(real[k]));
+            CHECK(spectrum.getBin(k).imag() == doctest::Approx(imaginary[k]));
+        }
+        
+        vector<double> output(size);
+        fft.inversePacked(spectrum, output.data());
+        for (size_t i = 0; i < size; ++i)
+            CHECK(output[i] == doctest::Approx(input[i]));
+    }
+    
+    SUBCASE("createFastFourierTransform")
+    {
+#ifdef GRIZZLY_FAST_FOURIER_TRANSFORM_SIMD
+        CHECK(dynamic_cast<FastFourierTransformSimd*>(createFastFourierTransform(512).get()) != nullptr);
+#else
+        CHECK(dynamic_cast<FastFourierTransform*>(createFastFourierTransform(512).get()) != nullptr);
+#endif
+        CHECK(dynamic_cast<FastFourierTransformMixedRadix*>(createFastFourierTransform(480).get()) != nullptr);
+        CHECK(dynamic_cast<FastFourierTransformMixedRadix*>(createFastFourierTransform(1).get()) != nullptr);
+    }
+}
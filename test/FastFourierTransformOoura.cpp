@@ -1,3 +1,5 @@
+#include <cmath>
+#include <complex>
 #include <vector>
 
 #include "doctest.h"
@@ -150,4 +152,240 @@ TEST_CASE("FastFourierTransformOoura")
             }
         }
     }
+    
+    SUBCASE("Float in double precision")
+    {
+        FastFourierTransformOoura single(64, FastFourierTransformOoura::FloatPrecision::SINGLE);
+        FastFourierTransformOoura doubled(64, FastFourierTransformOoura::FloatPrecision::DOUBLE);
+        
+        CHECK(single.getFloatPrecision() == FastFourierTransformOoura::FloatPrecision::SINGLE);
+        CHECK(doubled.getFloatPrecision() == FastFourierTransformOoura::FloatPrecision::DOUBLE);
+        
+        // Single precision has to be asked for
+        CHECK(FastFourierTransformOoura(64).getFloatPrecision() == FastFourierTransformOoura::FloatPrecision::DOUBLE);
+        
+        vector<float> input(64);
+        for (auto i = 0; i < 64; ++i)
+            input[i] = sin(i * 0.3f) + 0.25f * cos(i * 1.7f);
+        
+        vector<float> singleReal(33), singleImaginary(33);
+        vector<float> doubleReal(33), doubleImaginary(33);
+        single.forward(input.data(), singleReal.data(), singleImaginary.data());
+        doubled.forward(input.data(), doubleReal.data(), doubleImaginary.data());
+        
+        for (auto i = 0; i < 33; ++i)
+        {
+            CHECK(singleReal[i] == doctest::Approx(doubleReal[i]).epsilon(0.001));
+            CHECK(singleImaginary[i] == doctest::Approx(doubleImaginary[i]).epsilon(0.001));
+        }
+        
+        vector<float> output(64);
+        single.inverse(singleReal.data(), singleImaginary.data(), output.data());
+        for (auto i = 0; i < 64; ++i)
+            CHECK(output[i] == doctest::Approx(input[i]).epsilon(0.001));
+    }
+    
+    SUBCASE("Complex with imaginary input")
+    {
+        vector<double> inReal = {1, 2, 3, 4, 0, -1, 2, 0.5};
+        vector<double> inImaginary = {0.3, -1, 2, 0, 1, 0, 0, 4};
+        
+        // Transform the real signal first, so the real and complex tables have to coexist
+        vector<double> real(8), imaginary(8);
+        fft.forward(inReal.data(), real.data(), imaginary.data());
+        fft.forwardComplex(inReal.data(), inImaginary.data(), real.data(), imaginary.data());
+        
+        for (auto k = 0; k < 8; ++k)
+        {
+            complex<double> expected = 0;
+            for (auto j = 0; j < 8; ++j)
+                expected += complex<double>(inReal[j], inImaginary[j]) * polar(1.0, -2 * M_PI * j * k / 8);
+            
+            CHECK(real[k] == doctest::Approx(expected.real()));
+            CHECK(imaginary[k] == doctest::Approx(expected.imag()));
+        }
+        
+        vector<double> outReal(8), outImaginary(8);
+        fft.inverseComplex(real.data(), imaginary.data(), outReal.data(), outImaginary.data());
+        
+        for (auto i = 0; i < 8; ++i)
+        {
+            CHECK(outReal[i] == doctest::Approx(inReal[i]));
+            CHECK(outImaginary[i] == doctest::Approx(inImaginary[i]));
+        }
+    }
+    
+    SUBCASE("Packed")
+    {
+        const size_t size = 64;
+        FastFourierTransformOoura single(size, FastFourierTransformOoura::FloatPrecision::SINGLE);
+        FastFourierTransformOoura doubled(size, FastFourierTransformOoura::FloatPrecision::DOUBLE);
+        
+        vector<double> input(size);
+        vector<float> floatInput(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            input[i] = sin(i * 0.37) + 0.25 * cos(i * 1.3);
+            floatInput[i] = input[i];
+        }
+        
+        vector<double> real(size / 2 + 1), imaginary(size / 2 + 1);
+        single.forward(input.data(), real.data(), imaginary.data());
+        
+        PackedSpectrum<double> spectrum(size);
+        single.forwardPacked(input.data(), spectrum);
+        
+        PackedSpectrum<float> floatSpectrum(size);
+        single.forwardPacked(floatInput.data(), floatSpectrum);
+        
+        PackedSpectrum<float> doubledSpectrum(size);
+        doubled.forwardPacked(floatInput.data(), doubledSpectrum);
+        
+        for (size_t k = 0; k <= size / 2; ++k)
+        {
+            CHECK(spectrum.getBin(k).real() == doctest::Approx(real[k]));
+            CHECK(spectrum.getBin(k).imag() == doctest::Approx(imaginary[k]));
+            CHECK(floatSpectrum.getBin(k).real() == doctest::Approx(real[k]).epsilon(0.001));
+            CHECK(floatSpectrum.getBin(k).imag() == doctest::Approx(imaginary[k]).epsilon(0.001));
+            CHECK(doubledSpectrum.getBin(k).real() == doctest::Approx(real[k]).epsilon(0.001));
+            CHECK(doubledSpectrum.getBin(k).imag() == doctest::Approx(imaginary[k]).epsilon(0.001));
+        }
+        
+        vector<double> output(size);
+        single.inversePacked(spectrum, output.data());
+        
+        vector<float> floatOutput(size);
+        doubled.inversePacked(doubledSpectrum, floatOutput.data());
+        
+        for (size_t i = 0; i < size; ++i)
+        {
+            CHECK(output[i] == doctest::Approx(input[i]));
+            CHECK(floatOutput[i] == doctest::Approx(input[i]).epsilon(0.001));
+        }
+        
+        // In-place round trip
+        auto inPlace = floatInput;
+        single.forwardPacked(inPlace.data(), inPlace.data());
+        CHECK(inPlace == floatSpectrum.data);
+        
+        single.inversePacked(inPlace.data(), inPlace.data());
+        for (size_t i = 0; i < size; ++i)
+            CHECK(inPlace[i] == doctest::Approx(floatInput[i]).epsilon(0.001));
+        
+        // Filtering in the packed layout equals circular convolution
+        vector<double> impulse(size, 0);
+        impulse[0] = 0.5;
+        impulse[3] = -0.25;
+        
+        PackedSpectrum<double> filter(size);
+        single.forwardPacked(impulse.data(), filter);
+        multiply(spectrum, filter, spectrum);
+        single.inversePacked(spectrum, output.data());
+        
+        for (size_t i = 0; i < size; ++i)
+            CHECK(output[i] == doctest::Approx(0.5 * input[i] - 0.25 * input[(i + size - 3) % size]));
+    }
+    
+    SUBCASE("Threaded")
+    {
+        const size_t size = 1024;
+        FastFourierTransformOoura direct(size);
+        FastFourierTransformOoura threaded(size);
+        
+        CHECK(threaded.getThreadCount() == 1);
+        CHECK(!threaded.isThreaded());
+        
+        threaded.setThreadCount(3);
+        CHECK(!threaded.isThreaded());
+        
+        threaded.setThreadingThreshold(size);
+        CHECK(threaded.getThreadCount() == 3);
+        CHECK(threaded.getThreadingThreshold() == size);
+        REQUIRE(threaded.isThreaded());
+        
+        vector<double> input(size);
+        vector<double> inputImaginary(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            input[i] = sin(i * 0.37) + 0.25 * cos(i * 1.3);
+            inputImaginary[i] = cos(i * 0.91) - 0.5;
+        }
+        
+        // Real
+        vector<double> expectedReal(size / 2 + 1), expectedImaginary(size / 2 + 1);
+        direct.forward(input.data(), expectedReal.data(), expectedImaginary.data());
+        
+        vector<double> real(size / 2 + 1), imaginary(size / 2 + 1);
+        threaded.forward(input.data(), real.data(), imaginary.data());
+        
+        for (size_t k = 0; k <= size / 2; ++k)
+        {
+            CHECK(real[k] == doctest::Approx(expectedReal[k]));
+            CHECK(imaginary[k] == doctest::Approx(expectedImaginary[k]));
+        }
+        
+        vector<double> output(size);
+        threaded.inverse(real.data(), imaginary.data(), output.data());
+        for (size_t i = 0; i < size; ++i)
+            CHECK(output[i] == doctest::Approx(input[i]));
+        
+        // Complex, in-place
+        vector<double> complexReal(size), complexImaginary(size);
+        direct.forwardComplex(input.data(), inputImaginary.data(), complexReal.data(), complexImaginary.data());
+        
+        vector<double> inPlaceReal = input;
+        vector<double> inPlaceImaginary = inputImaginary;
+        threaded.forwardComplex(inPlaceReal.data(), inPlaceImaginary.data(), inPlaceReal.data(), inPlaceImaginary.data());
+        
+        for (size_t k = 0; k < size; ++k)
+        {
+            CHECK(inPlaceReal[k] == doctest::Approx(complexReal[k]));
+            CHECK(inPlaceImaginary[k] == doctest::Approx(complexImaginary[k]));
+        }
+        
+        threaded.inverseComplex(inPlaceReal.data(), inPlaceImaginary.data(), inPlaceReal.data(), inPlaceImaginary.data());
+        for (size_t i = 0; i < size; ++i)
+        {
+            CHECK(inPlaceReal[i] == doctest::Approx(input[i]));
+            CHECK(inPlaceImaginary[i] == doctest::Approx(inputImaginary[i]));
+        }
+        
+        // Float, in single precision
+        vector<float> floatInput(input.begin(), input.end());
+        vector<float> floatReal(size / 2 + 1), floatImaginary(size / 2 + 1);
+        threaded.forward(floatInput.data(), floatReal.data(), floatImaginary.data());
+        
+        for (size_t k = 0; k <= size / 2; ++k)
+        {
+            CHECK(floatReal[k] == doctest::Approx(expectedReal[k]).epsilon(0.001));
+            CHECK(floatImaginary[k] == doctest::Approx(expectedImaginary[k]).epsilon(0.001));
+        }
+        
+        // Packed, through the split transforms
+        PackedSpectrum<double> spectrum(size);
+        threaded.forwardPacked(input.data(), spectrum);
+        for (size_t k = 0; k <= size / 2; ++k)
+        {
+            CHECK(spectrum.getBin(k).real() == doctest::Approx(expectedReal[k]));
+            CHECK(spectrum.getBin(k).imag() == doctest::Approx(expectedImaginary[k]));
+        }
+        
+        threaded.inversePacked(spectrum, output.data());
+        for (size_t i = 0; i < size; ++i)
+            CHECK(output[i] == doctest::Approx(input[i]));
+        
+        // The same workers run every transform
+        for (auto n = 0; n < 100; ++n)
+            threaded.forward(input.data(), real.data(), imaginary.data());
+        
+        for (size_t k = 0; k <= size / 2; ++k)
+        {
+            CHECK(real[k] == doctest::Approx(expectedReal[k]));
+            CHECK(imaginary[k] == doctest::Approx(expectedImaginary[k]));
+        }
+        
+        // Back to a single thread
+        threaded.setThreadCount(1);
+        CHECK(!threaded.isThreaded());
+    }
 }
@@ -0,0 +1,119 @@
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../FastFourierTransform.hpp"
+#include "../FastFourierTransformPlanCache.hpp"
+#include "../MixedRadix/FastFourierTransformMixedRadix.hpp"
+#include "../Ooura/FastFourierTransformOoura.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! A plan that counts how often it's built
+struct CountingPlan
+{
+    CountingPlan(size_t size) : size(size) { ++constructions; }
+    
+    size_t size = 0;
+    
+    static atomic<size_t> constructions;
+};
+
+atomic<size_t> CountingPlan::constructions{0};
+
+TEST_CASE("FastFourierTransformPlanCache")
+{
+    FastFourierTransformPlanCache<CountingPlan>::clear();
+    CountingPlan::constructions = 0;
+    
+    SUBCASE("Plans are built once per size")
+    {
+        auto a = FastFourierTransformPlanCache<CountingPlan>::get(64);
+        auto b = FastFourierTransformPlanCache<CountingPlan>::get(64);
+        auto c = FastFourierTransformPlanCache<CountingPlan>::get(128);
+        
+        CHECK(a == b);
+        CHECK(a != c);
+        CHECK(a->size == 64);
+        CHECK(c->size == 128);
+        CHECK(CountingPlan::constructions == 2);
+        CHECK(FastFourierTransformPlanCache<CountingPlan>::getCount() == 2);
+    }
+    
+    SUBCASE("Clear releases the plans, but not the ones in use")
+    {
+        auto a = FastFourierTransformPlanCache<CountingPlan>::get(64);
+        FastFourierTransformPlanCache<CountingPlan>::clear();
+        
+        CHECK(FastFourierTransformPlanCache<CountingPlan>::getCount() == 0);
+        CHECK(a->size == 64);
+        
+        auto b = FastFourierTransformPlanCache<CountingPlan>::get(64);
+        CHECK(a != b);
+        CHECK(CountingPlan::constructions == 2);
+    }
+    
+    SUBCASE("Concurrent requests share one plan")
+    {
+        const size_t threadCount = 8;
+        vector<shared_ptr<const CountingPlan>> plans(threadCount);
+        vector<thread> threads;
+        
+        for (size_t i = 0; i < threadCount; ++i)
+            threads.emplace_back([&plans, i]{ plans[i] = FastFourierTransformPlanCache<CountingPlan>::get(256); });
+        
+        for (auto& thread : threads)
+            thread.join();
+        
+        CHECK(CountingPlan::constructions == 1);
+        for (auto& plan : plans)
+            CHECK(plan == plans[0]);
+    }
+    
+    SUBCASE("Transforms sharing tables give the same results")
+    {
+        // Ooura's tables are shared between the real and complex transforms, and between transforms of the same size
+        const size_t size = 64;
+        vector<float> input(size);
+        for (size_t i = 0; i < size; ++i)
+            input[i] = sin(i * 0.3f) + 0.5f * cos(i * 1.7f);
+        
+        FastFourierTransformOoura first(size);
+        vector<float> complexReal(size), complexImaginary(size);
+        first.forwardComplex(input.data(), input.data(), complexReal.data(), complexImaginary.data());
+        
+        vector<float> firstReal(size / 2 + 1), firstImaginary(size / 2 + 1);
+        first.forward(input.data(), firstReal.data(), firstImaginary.data());
+        
+        // A second transform of the same size, going through the factory as the helper functions do
+        auto second = createFastFourierTransform(size);
+        vector<float> secondReal(size / 2 + 1), secondImaginary(size / 2 + 1);
+        second->forward(input.data(), secondReal.data(), secondImaginary.data());
+        
+        for (size_t k = 0; k <= size / 2; ++k)
+        {
+            CHECK(secondReal[k] == doctest::Approx(firstReal[k]).epsilon(1e-4));
+            CHECK(secondImaginary[k] == doctest::Approx(firstImaginary[k]).epsilon(1e-4));
+        }
+        
+        // Two mixed radix transforms of the same size, one of them constructed while the other one is in use
+        FastFourierTransformMixedRadix mixed1(60);
+        vector<double> signal(60, 1);
+        vector<double> real(31), imaginary(31);
+        mixed1.forward(signal.data(), real.data(), imaginary.data());
+        
+        FastFourierTransformMixedRadix mixed2(60);
+        vector<double> real2(31), imaginary2(31);
+        mixed2.forward(signal.data(), real2.data(), imaginary2.data());
+        
+        CHECK(real == real2);
+        CHECK(imaginary == imaginary2);
+        CHECK(real[0] == doctest::Approx(60));
+    }
+}
@@ -0,0 +1,175 @@
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../Simd/FastFourierTransformSimd.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Naive discrete Fourier transform to compare against
+static vector<complex<double>> dft(const vector<complex<double>>& input)
+{
+    const auto size = input.size();
+    vector<complex<double>> output(size);
+    
+    for (size_t k = 0; k < size; ++k)
+        for (size_t n = 0; n < size; ++n)
+            output[k] += input[n] * polar(1.0, -2 * M_PI * k * n / size);
+    
+    return output;
+}
+
+template <typename T>
+static void testTransform(FastFourierTransformSimd& fft, std::size_t size, double epsilon)
+{
+    
+    vector<T> inputReal(size);
+    vector<T> inputImaginary(size);
+    vector<complex<double>> input(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        inputReal[i] = sin(i * 0.37) + 0.25 * cos(i * 1.3);
+        inputImaginary[i] = cos(i * 0.91) - 0.5;
+        input[i] = {static_cast<double>(inputReal[i]), static_cast<double>(inputImaginary[i])};
+    }
+    
+    // Real
+    {
+        vector<complex<double>> realInput(size);
+        for (size_t i = 0; i < size; ++i)
+            realInput[i] = inputReal[i];
+        
+        const auto expected = dft(realInput);
+        
+        vector<T> real(size / 2 + 1);
+        vector<T> imaginary(size / 2 + 1);
+        fft.forward(inputReal.data(), real.data(), imaginary.data());
+        
+        for (size_t k = 0; k <= size / 2; ++k)
+        {
+            CHECK(real[k] == doctest::Approx(expected[k].real()).epsilon(epsilon));
+            CHECK(imaginary[k] == doctest::Approx(expected[k].imag()).epsilon(epsilon));
+        }
+        
+        vector<T> output(size);
+        fft.inverse(real.data(), imaginary.data(), output.data());
+        
+        for (size_t i = 0; i < size; ++i)
+            CHECK(output[i] == doctest::Approx(inputReal[i]).epsilon(epsilon));
+    }
+    
+    // Complex
+    {
+        const auto expected = dft(input);
+        
+        vector<T> real(size);
+        vector<T> imaginary(size);
+        fft.forwardComplex(inputReal.data(), inputImaginary.data(), real.data(), imaginary.data());
+        
+        for (size_t k = 0; k < size; ++k)
+        {
+            CHECK(real[k] == doctest::Approx(expected[k].real()).epsilon(epsilon));
+            CHECK(imaginary[k] == doctest::Approx(expected[k].imag()).epsilon(epsilon));
+        }
+        
+        vector<T> outputReal(size);
+        vector<T> outputImaginary(size);
+        fft.inverseComplex(real.data(), imaginary.data(), outputReal.data(), outputImaginary.data());
+        
+        for (size_t i = 0; i < size; ++i)
+        {
+            CHECK(outputReal[i] == doctest::Approx(inputReal[i]).epsilon(epsilon));
+            CHECK(outputImaginary[i] == doctest::Approx(inputImaginary[i]).epsilon(epsilon));
+        }
+    }
+}
+
+template <typename T>
+static void testBatch(FastFourierTransformSimd& fft, size_t size, size_t count)
+{
+    // Strides larger than the frames check that the padding is left alone
+    const auto inputStride = size + 3;
+    const auto outputStride = size / 2 + 5;
+    
+    vector<T> input(count * inputStride, 7);
+    for (size_t frame = 0; frame < count; ++frame)
+        for (size_t i = 0; i < size; ++i)
+            input[frame * inputStride + i] = sin(i * 0.37 + frame) + 0.25 * cos(i * 1.3 * (frame + 1));
+    
+    vector<T> real(count * outputStride, 7);
+    vector<T> imaginary(count * outputStride, 7);
+    fft.forwardBatch(input.data(), count, inputStride, real.data(), imaginary.data(), outputStride);
+    
+    vector<T> output(count * inputStride, 7);
+    fft.inverseBatch(real.data(), imaginary.data(), count, outputStride, output.data(), inputStride);
+    
+    vector<T> expectedReal(size / 2 + 1);
+    vector<T> expectedImaginary(size / 2 + 1);
+    for (size_t frame = 0; frame < count; ++frame)
+    {
+        fft.forward(input.data() + frame * inputStride, expectedReal.data(), expectedImaginary.data());
+        
+        for (size_t k = 0; k <= size / 2; ++k)
+        {
+            CHECK(real[frame * outputStride + k] == doctest::Approx(expectedReal[k]));
+            CHECK(imaginary[frame * outputStride + k] == doctest::Approx(expectedImaginary[k]));
+        }
+        
+        for (auto k = size / 2 + 1; k < outputStride; ++k)
+            CHECK(real[frame * outputStride + k] == 7);
+        
+        for (size_t i = 0; i < size; ++i)
+            CHECK(output[frame * inputStride + i] == doctest::Approx(input[frame * inputStride + i]));
+        
+        for (auto i = size; i < inputStride; ++i)
+            CHECK(output[frame * inputStride + i] == 7);
+    }
+}
+
+TEST_CASE("FastFourierTransformSimd")
+{
+    SUBCASE("Invalid size")
+    {
+        CHECK_THROWS_AS(FastFourierTransformSimd(0), std::invalid_argument);
+        CHECK_THROWS_AS(FastFourierTransformSimd(1), std::invalid_argument);
+        CHECK_THROWS_AS(FastFourierTransformSimd(12), std::invalid_argument);
+    }
+    
+    SUBCASE("Instruction set is clamped to the CPU")
+    {
+        FastFourierTransformSimd fft(16, FastFourierTransformSimd::InstructionSet::AVX512);
+        CHECK(fft.getInstructionSet() <= FastFourierTransformSimd::detectInstructionSet());
+    }
+    
+    const FastFourierTransformSimd::InstructionSet instructionSets[] =
+    {
+        FastFourierTransformSimd::InstructionSet::GENERIC,
+        FastFourierTransformSimd::InstructionSet::AVX2,
+        FastFourierTransformSimd::InstructionSet::AVX512
+    };
+    
+    for (auto instructionSet : instructionSets)
+    {
+        // Odd and even powers of two exercise both the radix-4 and the trailing radix-2 stage
+        for (std::size_t size : {2, 4, 8, 16, 32, 128, 512, 1024})
+        {
+            FastFourierTransformSimd fft(size, instructionSet);
+            
+            testTransform<float>(fft, size, 1e-3);
+            testTransform<double>(fft, size, 1e-9);
+        }
+        
+        // Enough frames to fill a few groups of lanes, and some left over
+        for (std::size_t size : {2, 8, 32, 256})
+        {
+            FastFourierTransformSimd fft(size, instructionSet);
+            
+            testBatch<float>(fft, size, 35);
+            testBatch<double>(fft, size, 19);
+            testBatch<float>(fft, size, 1);
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include <cmath>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../FilterBank.hpp"
+
+using namespace dsp;
+using namespace std;
+
+TEST_CASE("FilterBank")
+{
+    SUBCASE("scales")
+    {
+        CHECK(hertzToMel(1000.0) == doctest::Approx(1000).epsilon(0.001));
+        CHECK(melToHertz(hertzToMel(4321.0)) == doctest::Approx(4321));
+        CHECK(hertzToBark(1000.0) == doctest::Approx(8.53).epsilon(0.01));
+        CHECK(barkToHertz(hertzToBark(4321.0)) == doctest::Approx(4321));
+    }
+    
+    for (auto scale : {FrequencyScale::MEL, FrequencyScale::BARK})
+    {
+        const size_t frameSize = 2048;
+        const double sampleRate = 44100;
+        FilterBank<double> bank(frameSize, sampleRate, 40, 20, 16000, scale);
+        
+        REQUIRE(bank.getFilterCount() == 40);
+        REQUIRE(bank.getBinCount() == frameSize / 2 + 1);
+        
+        // Only a small part of the dense matrix is stored
+        CHECK(bank.getWeightCount() < bank.getFilterCount() * bank.getBinCount() / 10);
+        
+        // The filters are triangles between the centres of their neighbours, peaking at one
+        const auto toScale = [&](double frequency){ return (scale == FrequencyScale::MEL) ? hertzToMel(frequency) : hertzToBark(frequency); };
+        const auto fromScale = [&](double value){ return (scale == FrequencyScale::MEL) ? melToHertz(value) : barkToHertz(value); };
+        
+        vector<double> spectrum(bank.getBinCount());
+        for (size_t bin = 0; bin < spectrum.size(); ++bin)
+            spectrum[bin] = 1 + sin(bin * 0.1);
+        
+        vector<double> output(bank.getFilterCount());
+        bank.apply(spectrum.data(), output.data());
+        
+        for (size_t filter = 0; filter < bank.getFilterCount(); ++filter)
+        {
+            const auto step = (toScale(16000) - toScale(20)) / 41;
+            const auto lower = fromScale(toScale(20) + step * filter);
+            const auto centre = fromScale(toScale(20) + step * (filter + 1));
+            const auto upper = fromScale(toScale(20) + step * (filter + 2));
+            
+            double expected = 0;
+            for (size_t bin = 0; bin < bank.getBinCount(); ++bin)
+            {
+                const auto frequency = bin * sampleRate / frameSize;
+                const auto weight = max(0.0, min((frequency - lower) / (centre - lower), (upper - frequency) / (upper - centre)));
+                CHECK(bank.getWeight(filter, bin) == doctest::Approx(weight));
+                expected += weight * spectrum[bin];
+            }
+            
+            CHECK(output[filter] == doctest::Approx(expected));
+        }
+    }
+    
+    SUBCASE("float")
+    {
+        FilterBank<float> bank(512, 16000, 26, 0, 8000);
+        vector<float> spectrum(257, 1), output(26);
+        bank.apply(spectrum.data(), output.data());
+        
+        for (auto filter = 0; filter < 26; ++filter)
+        {
+            float expected = 0;
+            for (auto bin = 0; bin < 257; ++bin)
+                expected += bank.getWeight(filter, bin);
+            
+            CHECK(output[filter] == doctest::Approx(expected));
+        }
+    }
+    
+    SUBCASE("invalid arguments")
+    {
+        CHECK_THROWS_AS(FilterBank<float>(512, 16000, 0, 0, 8000), invalid_argument);
+        CHECK_THROWS_AS(FilterBank<float>(512, 16000, 26, 0, 9000), invalid_argument);
+        CHECK_THROWS_AS(FilterBank<float>(512, 16000, 26, 4000, 2000), invalid_argument);
+    }
+}
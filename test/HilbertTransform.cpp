@@ -1,3 +1,4 @@
+#include <cmath>
 #include <vector>
 
 #include "doctest.h"
@@ -38,4 +39,18 @@ TEST_CASE("HilbertTransform")
         CHECK(out[6] == doctest::Approx(-1));
         CHECK(out[7] == doctest::Approx(-0.70710678118655));
     }
+    
+    SUBCASE("Size that isn't a power of two")
+    {
+        // The Hilbert transform of a sine is minus the cosine
+        std::vector<float> in(12);
+        for (auto i = 0; i < 12; ++i)
+            in[i] = std::sin(2 * M_PI * i / 12);
+        
+        std::vector<float> out(12);
+        hilbertTransform(in.begin(), in.end(), out.begin(), HilbertTransformDirection::FORWARD);
+        
+        for (auto i = 0; i < 12; ++i)
+            CHECK(out[i] == doctest::Approx(-std::cos(2 * M_PI * i / 12)));
+    }
 }
@@ -0,0 +1,107 @@
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../MelFrequencyCepstrum.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Compute the coefficients with a dense filter matrix and a direct DCT-II
+template <typename T>
+static vector<double> computeReference(const FilterBank<T>& bank, const vector<T>& powers, size_t coefficientCount)
+{
+    const auto filterCount = bank.getFilterCount();
+    vector<double> energies(filterCount);
+    for (size_t filter = 0; filter < filterCount; ++filter)
+    {
+        double energy = 0;
+        for (size_t bin = 0; bin < powers.size(); ++bin)
+            energy += bank.getWeight(filter, bin) * powers[bin];
+        
+        energies[filter] = log(max(energy, 1e-10));
+    }
+    
+    vector<double> coefficients(coefficientCount);
+    for (size_t k = 0; k < coefficientCount; ++k)
+    {
+        for (size_t n = 0; n < filterCount; ++n)
+            coefficients[k] += energies[n] * cos(M_PI * (n + 0.5) * k / filterCount);
+        
+        coefficients[k] *= sqrt(((k == 0) ? 1.0 : 2.0) / filterCount);
+    }
+    
+    return coefficients;
+}
+
+template <typename T>
+static void checkCepstrum(size_t filterCount, double epsilon)
+{
+    const size_t frameSize = 1024;
+    MelFrequencyCepstrum<T> cepstrum(frameSize, 44100, filterCount, 13, 50);
+    
+    vector<T> real(frameSize / 2 + 1), imaginary(frameSize / 2 + 1), powers(frameSize / 2 + 1);
+    for (size_t bin = 0; bin < real.size(); ++bin)
+    {
+        real[bin] = 1 + cos(bin * 0.05) + (bin % 7);
+        imaginary[bin] = sin(bin * 0.3);
+        powers[bin] = real[bin] * real[bin] + imaginary[bin] * imaginary[bin];
+    }
+    
+    const auto reference = computeReference(cepstrum.getFilterBank(), powers, 13);
+    
+    vector<T> coefficients(13);
+    cepstrum.compute(powers.data(), coefficients.data());
+    for (auto k = 0; k < 13; ++k)
+        CHECK(coefficients[k] == doctest::Approx(reference[k]).epsilon(epsilon));
+    
+    cepstrum.compute(real.data(), imaginary.data(), coefficients.data());
+    for (auto k = 0; k < 13; ++k)
+        CHECK(coefficients[k] == doctest::Approx(reference[k]).epsilon(epsilon));
+}
+
+TEST_CASE("MelFrequencyCepstrum fast transform")
+{
+    checkCepstrum<float>(32, 1e-4);
+    checkCepstrum<double>(64, 1e-9);
+}
+
+TEST_CASE("MelFrequencyCepstrum matrix transform")
+{
+    checkCepstrum<float>(40, 1e-4);
+    checkCepstrum<double>(26, 1e-9);
+}
+
+TEST_CASE("MelFrequencyCepstrum spectrogram")
+{
+    const size_t frameCount = 5;
+    const size_t frameSize = 512;
+    MelFrequencyCepstrum<float> cepstrum(frameSize, 16000, 40, 20);
+    
+    for (auto layout : {Spectrogram<float>::Layout::FRAME_MAJOR, Spectrogram<float>::Layout::BIN_MAJOR})
+    {
+        Spectrogram<float> spectrogram(frameCount, frameSize / 2 + 1, layout);
+        for (size_t frame = 0; frame < frameCount; ++frame)
+            for (size_t bin = 0; bin < spectrogram.getBinCount(); ++bin)
+                spectrogram(frame, bin) = polar(float(1 + sin(bin * 0.1 + frame)), float(bin));
+        
+        vector<float> matrix(20 * frameCount);
+        cepstrum.compute(spectrogram, matrix.data());
+        
+        for (size_t frame = 0; frame < frameCount; ++frame)
+        {
+            vector<float> powers(spectrogram.getBinCount()), coefficients(20);
+            for (size_t bin = 0; bin < powers.size(); ++bin)
+                powers[bin] = norm(spectrogram(frame, bin));
+            
+            cepstrum.compute(powers.data(), coefficients.data());
+            for (auto k = 0; k < 20; ++k)
+                CHECK(matrix[k * frameCount + frame] == doctest::Approx(coefficients[k]));
+        }
+    }
+    
+    CHECK_THROWS_AS(cepstrum.compute(Spectrogram<float>(2, 100), nullptr), invalid_argument);
+    CHECK_THROWS_AS(MelFrequencyCepstrum<float>(512, 16000, 10, 11), invalid_argument);
+}
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../Convolution.hpp"
+#include "../NonUniformPartitionedConvolution.hpp"
+
+#include "ConvolutionFixtures.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Convolve in place, in chunks of varying sizes
+static vector<float> processInChunks(NonUniformPartitionedConvolution<float>& convolution, vector<float> signal)
+{
+    for (size_t i = 0, chunk = 1; i < signal.size(); i += chunk, chunk = chunk * 7 % 301 + 1)
+        convolution.process(signal.data() + i, signal.data() + i, min(chunk, signal.size() - i));
+    
+    return signal;
+}
+
+TEST_CASE("NonUniformPartitionedConvolution")
+{
+    const auto input = createNoise<float>(20000, 3);
+    
+    SUBCASE("Equals direct convolution, without latency")
+    {
+        for (auto kernelSize : {1, 10, 16, 50, 64, 100, 1000, 9000})
+        {
+            const auto kernel = createKernel<float>(kernelSize);
+            NonUniformPartitionedConvolution<float> convolution(kernel.begin(), kernel.end(), 16, 256, PartitionScheduling::DETERMINISTIC);
+            
+            CHECK(getRelativeError(processInChunks(convolution, input), convolveReference(input, kernel)) < 1e-5f);
+            CHECK(convolution.getDeadlineMissCount() == 0);
+        }
+    }
+    
+    SUBCASE("Partition sizes")
+    {
+        const auto kernel = createKernel<float>(9000);
+        NonUniformPartitionedConvolution<float> convolution(kernel.begin(), kernel.end(), 16, 256, PartitionScheduling::DETERMINISTIC);
+        
+        // [16, 64), [64, 128), [128, 256), [256, 512), then the rest in partitions of the maximum
+        REQUIRE(convolution.getStageCount() == 5);
+        CHECK(convolution.getStageBlockSize(0) == 16);
+        CHECK(convolution.getStageBlockSize(1) == 32);
+        CHECK(convolution.getStageBlockSize(3) == 128);
+        CHECK(convolution.getStageBlockSize(4) == 256);
+        
+        NonUniformPartitionedConvolution<float> shortKernel({1, 2, 3}, 16);
+        CHECK(shortKernel.getStageCount() == 0);
+        CHECK(shortKernel(1) == 1);
+        CHECK(shortKernel(0) == 2);
+        CHECK(shortKernel(0) == 3);
+        CHECK(shortKernel(0) == 0);
+    }
+    
+    SUBCASE("The background worker gives the same output")
+    {
+        const auto kernel = createKernel<float>(9000);
+        NonUniformPartitionedConvolution<float> deterministic(kernel.begin(), kernel.end(), 16, 256, PartitionScheduling::DETERMINISTIC);
+        NonUniformPartitionedConvolution<float> background(kernel.begin(), kernel.end(), 16, 256, PartitionScheduling::BACKGROUND);
+        
+        CHECK(processInChunks(background, input) == processInChunks(deterministic, input));
+    }
+    
+    SUBCASE("Kernel changes and reset")
+    {
+        const auto kernel = createKernel<float>(500);
+        NonUniformPartitionedConvolution<float> convolution(kernel.begin(), kernel.end(), 32, 128);
+        CHECK(convolution.getKernel() == kernel);
+        processInChunks(convolution, input);
+        
+        const auto longer = createKernel<float>(3000);
+        convolution.setKernel(longer.begin(), longer.end());
+        CHECK(getRelativeError(processInChunks(convolution, input), convolveReference(input, longer)) < 1e-5f);
+        
+        convolution.reset();
+        CHECK(getRelativeError(processInChunks(convolution, input), convolveReference(input, longer)) < 1e-5f);
+        
+        CHECK_THROWS_AS(NonUniformPartitionedConvolution<float>({1, 2}, 16, 48), std::invalid_argument);
+        CHECK_THROWS_AS(NonUniformPartitionedConvolution<float>({1, 2}, 0, 16), std::invalid_argument);
+    }
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../OnsetDetector.hpp"
+#include "../StreamingShortTimeFourierTransform.hpp"
+#include "../Window.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! A quiet tone with decaying noise bursts starting at the given samples
+static vector<float> createBursts(const vector<size_t>& starts, size_t size)
+{
+    srand(3);
+    vector<float> signal(size);
+    for (size_t i = 0; i < size; ++i)
+        signal[i] = 0.01f * sin(i * 0.05f);
+    
+    for (auto start : starts)
+        for (auto i = start; i < min(size, start + 4000); ++i)
+            signal[i] += exp((float(start) - i) / 600.f) * (rand() / float(RAND_MAX) - 0.5f);
+    
+    return signal;
+}
+
+//! Run a signal through a streaming STFT and a detector, in blocks of an odd size, and return the onset positions
+static vector<size_t> detect(const vector<float>& signal, OnsetDetector<float>& detector)
+{
+    StreamingShortTimeFourierTransform<float> stft(detector.getFrameSize(), detector.getHopSize(), createHanningWindow<float>(detector.getFrameSize()));
+    
+    vector<size_t> onsets;
+    for (size_t i = 0; i < signal.size(); i += 333)
+    {
+        stft.write(signal.data() + i, min<size_t>(333, signal.size() - i), [&](const float* real, const float* imaginary)
+        {
+            if (auto onset = detector.process(real, imaginary))
+                onsets.emplace_back(onset->position);
+        });
+    }
+    
+    return onsets;
+}
+
+TEST_CASE("OnsetDetector")
+{
+    const vector<size_t> starts = {10000, 30000, 52000, 70123};
+    const auto signal = createBursts(starts, 90000);
+    
+    for (auto function : {OnsetDetectionFunction::HIGH_FREQUENCY_CONTENT_BROSSIER, OnsetDetectionFunction::HIGH_FREQUENCY_CONTENT_MASRI, OnsetDetectionFunction::HIGH_FREQUENCY_CONTENT_JENSEN, OnsetDetectionFunction::SPECTRAL_FLUX, OnsetDetectionFunction::COMPLEX_DOMAIN})
+    {
+        for (auto statistic : {OnsetThreshold::MEDIAN, OnsetThreshold::MEAN})
+        {
+            OnsetDetector<float> detector(1024, 256, function);
+            detector.setThreshold(0.1, 2, statistic);
+            detector.setMinimumInterval(2048);
+            
+            const auto onsets = detect(signal, detector);
+            REQUIRE(onsets.size() == starts.size());
+            
+            // The attacks are placed within a hop of where they enter the frames
+            for (size_t i = 0; i < starts.size(); ++i)
+                CHECK(abs(static_cast<long>(onsets[i]) - static_cast<long>(starts[i])) <= 256);
+        }
+    }
+}
+
+TEST_CASE("OnsetDetector peak picking")
+{
+    // A spectrum of a single bin, whose flux is the rise of that bin
+    OnsetDetector<float> detector(2, 100, OnsetDetectionFunction::SPECTRAL_FLUX, 5, 2);
+    detector.setThreshold(0.5, 1);
+    
+    const auto process = [&](float magnitude)
+    {
+        const float real[2] = {magnitude, 0};
+        const float imaginary[2] = {0, 0};
+        return detector.process(real, imaginary);
+    };
+    
+    SUBCASE("onsets are reported lookahead frames later, placed between frames")
+    {
+        // Flux 0, 0, 3, 1, 0, 0: the peak in frame 2 is leaning towards frame 3
+        CHECK(!process(0));
+        CHECK(!process(0));
+        CHECK(!process(3));
+        CHECK(!process(4));
+        
+        const auto onset = process(4);
+        REQUIRE(onset);
+        CHECK(onset->strength == doctest::Approx(3));
+        CHECK(onset->position == 2 * 100 + 10 + 1);
+        CHECK(!process(4));
+        
+        CHECK(detector.getLatency() == 2 * 100 + 1);
+    }
+    
+    SUBCASE("onset positions stay exact beyond the precision of T")
+    {
+        OnsetDetector<float> detector(2, 1024, OnsetDetectionFunction::SPECTRAL_FLUX, 5, 2);
+        detector.setThreshold(0.5, 1);
+        
+        const float zero[2] = {0, 0};
+        const float peak[2] = {3, 0};
+        
+        // 2^24 / 1024 frames take the stream past what a float counts exactly
+        const size_t jump = (1 << 24) / 1024 + 1001;
+        size_t onsets = 0;
+        for (size_t frame = 0; frame < jump; ++frame)
+            onsets += detector.process(zero, zero) ? 1 : 0;
+        
+        CHECK(onsets == 0);
+        
+        CHECK(!detector.process(peak, zero));
+        CHECK(!detector.process(peak, zero));
+        
+        const auto onset = detector.process(peak, zero);
+        REQUIRE(onset);
+        CHECK(onset->position == jump * 1024 + 1);
+    }
+    
+    SUBCASE("the threshold follows the median or mean")
+    {
+        for (auto magnitude : {1, 3, 4, 10, 10})
+            process(magnitude);
+        
+        // Flux 0, 2, 1, 6, 0
+        CHECK(detector.getDetectionFunction() == 0);
+        CHECK(detector.getThreshold() == doctest::Approx(0.5 + 1));
+        
+        detector.setThreshold(0.5, 1, OnsetThreshold::MEAN);
+        CHECK(detector.getThreshold() == doctest::Approx(0.5 + 9 / 5.0));
+        
+        // Flux 2, 1, 6, 0, 4 after the oldest one drops out
+        process(14);
+        CHECK(detector.getThreshold() == doctest::Approx(0.5 + 13 / 5.0));
+        
+        detector.setThreshold(0.5, 1, OnsetThreshold::MEDIAN);
+        CHECK(detector.getThreshold() == doctest::Approx(0.5 + 2));
+    }
+    
+    SUBCASE("the median follows the history over a long stream")
+    {
+        for (size_t thresholdSize : {5, 8})
+        {
+            OnsetDetector<float> detector(2, 100, OnsetDetectionFunction::SPECTRAL_FLUX, thresholdSize, 2);
+            detector.setThreshold(0, 1);
+            
+            // Rising magnitudes give a flux of every rise, with plenty of ties between them
+            srand(5);
+            float magnitude = 0;
+            vector<float> values;
+            for (auto frame = 0; frame < 300; ++frame)
+            {
+                magnitude += rand() % 8;
+                const float real[2] = {magnitude, 0};
+                const float imaginary[2] = {0, 0};
+                detector.process(real, imaginary);
+                values.emplace_back(detector.getDetectionFunction());
+                
+                vector<float> recent(values.end() - min(values.size(), thresholdSize), values.end());
+                sort(recent.begin(), recent.end());
+                const auto middle = recent.size() / 2;
+                const auto median = (recent.size() % 2) ? recent[middle] : (recent[middle - 1] + recent[middle]) / 2;
+                CHECK(detector.getThreshold() == doctest::Approx(median));
+            }
+        }
+    }
+    
+    SUBCASE("minimum interval and reset")
+    {
+        detector.setMinimumInterval(1000);
+        
+        size_t onsets = 0;
+        for (auto magnitude : {0, 0, 5, 5, 5, 10, 10, 10, 10, 10})
+            onsets += process(magnitude) ? 1 : 0;
+        
+        CHECK(onsets == 1);
+        
+        detector.reset();
+        for (auto magnitude : {0, 0, 5, 5, 5, 5})
+            onsets += process(magnitude) ? 1 : 0;
+        
+        CHECK(onsets == 2);
+    }
+    
+    SUBCASE("invalid arguments")
+    {
+        CHECK_THROWS_AS(OnsetDetector<float>(1024, 0), invalid_argument);
+        CHECK_THROWS_AS(OnsetDetector<float>(1024, 256, OnsetDetectionFunction::SPECTRAL_FLUX, 4, 2), invalid_argument);
+    }
+}
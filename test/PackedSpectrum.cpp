@@ -0,0 +1,80 @@
+#include <complex>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../PackedSpectrum.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Fill a packed spectrum with some bins, returning the bins
+static vector<complex<double>> fill(PackedSpectrum<double>& spectrum, double seed)
+{
+    vector<complex<double>> bins(spectrum.getBinCount());
+    for (size_t k = 0; k < bins.size(); ++k)
+    {
+        bins[k] = {cos(k * seed) + 0.5, (k == 0 || k == bins.size() - 1) ? 0 : sin(k * seed * 1.3)};
+        spectrum.setBin(k, bins[k]);
+    }
+    
+    return bins;
+}
+
+TEST_CASE("PackedSpectrum")
+{
+    const size_t size = 16;
+    PackedSpectrum<double> lhs(size);
+    PackedSpectrum<double> rhs(size);
+    
+    CHECK(lhs.size() == size);
+    CHECK(lhs.getBinCount() == size / 2 + 1);
+    
+    const auto lhsBins = fill(lhs, 0.7);
+    const auto rhsBins = fill(rhs, 1.9);
+    
+    SUBCASE("Bins")
+    {
+        for (size_t k = 0; k < lhsBins.size(); ++k)
+            CHECK(lhs.getBin(k) == lhsBins[k]);
+        
+        // DC and Nyquist come first, the imaginary parts are stored negated
+        CHECK(lhs.data[0] == lhsBins[0].real());
+        CHECK(lhs.data[1] == lhsBins[size / 2].real());
+        CHECK(lhs.data[2] == lhsBins[1].real());
+        CHECK(lhs.data[3] == -lhsBins[1].imag());
+    }
+    
+    SUBCASE("Multiply")
+    {
+        PackedSpectrum<double> output(size);
+        multiply(lhs, rhs, output);
+        
+        for (size_t k = 0; k < lhsBins.size(); ++k)
+        {
+            const auto expected = lhsBins[k] * rhsBins[k];
+            CHECK(output.getBin(k).real() == doctest::Approx(expected.real()));
+            CHECK(output.getBin(k).imag() == doctest::Approx(expected.imag()));
+        }
+        
+        // In-place
+        multiplyPacked(lhs.data.data(), rhs.data.data(), lhs.data.data(), size);
+        CHECK(lhs.data == output.data);
+    }
+    
+    SUBCASE("Multiply accumulate")
+    {
+        PackedSpectrum<double> accumulator(size);
+        const auto accumulatorBins = fill(accumulator, 0.3);
+        
+        multiplyAccumulate(lhs, rhs, accumulator);
+        multiplyAccumulate(lhs, lhs, accumulator);
+        
+        for (size_t k = 0; k < lhsBins.size(); ++k)
+        {
+            const auto expected = accumulatorBins[k] + lhsBins[k] * rhsBins[k] + lhsBins[k] * lhsBins[k];
+            CHECK(accumulator.getBin(k).real() == doctest::Approx(expected.real()));
+            CHECK(accumulator.getBin(k).imag() == doctest::Approx(expected.imag()));
+        }
+    }
+}
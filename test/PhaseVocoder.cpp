@@ -0,0 +1,148 @@
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../PhaseVocoder.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Run a signal through a vocoder in blocks, pulling output as it becomes available
+static vector<float> process(PhaseVocoder<float>& vocoder, const vector<float>& signal, size_t blockSize = 512)
+{
+    vector<float> result;
+    vector<float> block(blockSize);
+    for (size_t i = 0; i < signal.size(); i += blockSize)
+    {
+        vocoder.write(signal.data() + i, min(blockSize, signal.size() - i));
+        while (vocoder.getAvailable() > 0)
+            result.insert(result.end(), block.begin(), block.begin() + vocoder.read(block.data(), block.size()));
+    }
+    
+    return result;
+}
+
+//! Estimate the frequency of a sinusoid in cycles per sample, by counting upward zero crossings
+static double estimateFrequency(const vector<float>& signal, size_t begin, size_t end)
+{
+    size_t first = 0, last = 0, crossings = 0;
+    for (auto i = begin + 1; i < end; ++i)
+    {
+        if (signal[i - 1] < 0 && signal[i] >= 0)
+        {
+            if (crossings == 0)
+                first = i;
+            
+            last = i;
+            ++crossings;
+        }
+    }
+    
+    return (crossings - 1) / static_cast<double>(last - first);
+}
+
+TEST_CASE("PhaseVocoder")
+{
+    const double frequency = 0.0123;
+    vector<float> signal(48000);
+    for (size_t i = 0; i < signal.size(); ++i)
+        signal[i] = 0.5 * sin(2 * M_PI * frequency * i);
+    
+    SUBCASE("Without modification, the input comes out unchanged")
+    {
+        for (auto locking : {true, false})
+        {
+            PhaseVocoder<float> vocoder(1024, 256);
+            vocoder.setPhaseLocking(locking);
+            const auto output = process(vocoder, signal, 300);
+            
+            // Every frame is processed as soon as it's complete, after which a hop of samples is final
+            REQUIRE(output.size() == ((signal.size() - 1024) / 256 + 1) * 256);
+            for (size_t i = 1024; i < output.size(); ++i)
+                CHECK(output[i] == doctest::Approx(signal[i]).epsilon(1e-3));
+        }
+    }
+    
+    SUBCASE("Time-stretching keeps the frequency")
+    {
+        for (auto stretch : {0.5, 1.5, 2.0})
+        {
+            PhaseVocoder<float> vocoder(2048, 512);
+            vocoder.setTimeStretch(stretch);
+            CHECK(vocoder.getTimeStretch() == doctest::Approx(stretch).epsilon(0.01));
+            
+            const auto output = process(vocoder, signal);
+            CHECK(output.size() == doctest::Approx(signal.size() * stretch).epsilon(0.1));
+            CHECK(estimateFrequency(output, 4096, output.size() - 512) == doctest::Approx(frequency).epsilon(0.002));
+        }
+    }
+    
+    SUBCASE("Pitch-shifting scales the frequency")
+    {
+        for (auto shift : {0.75, 1.5})
+        {
+            PhaseVocoder<float> vocoder(2048, 512);
+            vocoder.setPitchShift(shift);
+            
+            const auto output = process(vocoder, signal);
+            CHECK(output.size() == doctest::Approx(signal.size()).epsilon(0.05));
+            CHECK(estimateFrequency(output, 4096, output.size() - 512) == doctest::Approx(frequency * shift).epsilon(0.01));
+        }
+    }
+    
+    SUBCASE("Transients")
+    {
+        // A steady tone is never a transient, one that starts after silence is
+        PhaseVocoder<float> vocoder(1024, 256);
+        vocoder.setTimeStretch(1.5);
+        
+        size_t transients = 0;
+        for (size_t i = 0; i < signal.size(); i += 128)
+        {
+            vocoder.write(signal.data() + i, 128);
+            transients += vocoder.isTransient();
+        }
+        
+        CHECK(transients == 0);
+        
+        vocoder.reset();
+        vector<float> burst(8192, 0);
+        copy(signal.begin(), signal.begin() + 4096, burst.begin() + 4096);
+        
+        for (size_t i = 0; i < burst.size(); i += 128)
+        {
+            vocoder.write(burst.data() + i, 128);
+            transients += vocoder.isTransient();
+        }
+        
+        CHECK(transients > 0);
+    }
+    
+    SUBCASE("Output queue")
+    {
+        // A queue sized for short reads wraps around, and grows when more is written ahead of reading
+        PhaseVocoder<float> reference(1024, 256);
+        PhaseVocoder<float> small(1024, 256, 64);
+        reference.setTimeStretch(1.5);
+        small.setTimeStretch(1.5);
+        
+        const auto expected = process(reference, signal, 700);
+        CHECK(process(small, signal, 64) == expected);
+        
+        small.reset();
+        CHECK(process(small, signal, 4000) == expected);
+    }
+    
+    SUBCASE("Invalid arguments")
+    {
+        CHECK_THROWS_AS(PhaseVocoder<float>(1024, 0), invalid_argument);
+        CHECK_THROWS_AS(PhaseVocoder<float>(1024, 1000), invalid_argument);
+        
+        PhaseVocoder<float> vocoder(1024, 256);
+        CHECK_THROWS_AS(vocoder.setTimeStretch(0), invalid_argument);
+        CHECK_THROWS_AS(vocoder.setPitchShift(-1), invalid_argument);
+    }
+}
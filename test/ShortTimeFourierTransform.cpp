@@ -0,0 +1,130 @@
+#include <cmath>
+#include <experimental/optional>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../ShortTimeFourierTransform.hpp"
+#include "../Window.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Check that two lists of spectra are exactly equal
+static void checkIdentical(const vector<Spectrum<float>>& lhs, const vector<Spectrum<float>>& rhs)
+{
+    REQUIRE(lhs.size() == rhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i)
+        CHECK(lhs[i].data == rhs[i].data);
+}
+
+//! A window whose samples can't be read, to make the transform of every frame throw
+struct ThrowingWindowIterator
+{
+    using iterator_category = input_iterator_tag;
+    using value_type = float;
+    using difference_type = ptrdiff_t;
+    using pointer = const float*;
+    using reference = float;
+    
+    float operator*() const { throw runtime_error("unreadable window"); }
+    ThrowingWindowIterator& operator++() { return *this; }
+};
+
+TEST_CASE("ShortTimeFourierTransform")
+{
+    vector<float> signal(5000);
+    for (size_t i = 0; i < signal.size(); ++i)
+        signal[i] = sin(i * 0.05f) + 0.3f * cos(i * 1.1f);
+    
+    SUBCASE("Frames")
+    {
+        const auto spectra = shortTimeFourierTransform(signal.begin(), signal.end(), 256, experimental::optional<float*>(), 100);
+        
+        // The last frames are zero-padded
+        REQUIRE(spectra.size() == 50);
+        CHECK(spectra[0].size() == 129);
+        
+        float sum = 0;
+        for (auto i = 4900; i < 5000; ++i)
+            sum += signal[i];
+        CHECK(spectra[49][0].real() == doctest::Approx(sum).epsilon(1e-4));
+    }
+    
+    SUBCASE("Parallel is identical to serial")
+    {
+        const auto window = createHanningWindow<float>(512);
+        const auto windowBegin = experimental::make_optional(window.begin());
+        const auto serial = shortTimeFourierTransform(signal.begin(), signal.end(), 512, windowBegin, 128);
+        
+        for (size_t threadCount : {0, 1, 2, 3, 8, 100})
+            checkIdentical(parallelShortTimeFourierTransform(signal.begin(), signal.end(), 512, windowBegin, 128, threadCount), serial);
+        
+        // Without window, and with frames that need the mixed radix transform
+        const auto mixed = shortTimeFourierTransform(signal.begin(), signal.end(), 480, experimental::optional<float*>(), 160);
+        checkIdentical(parallelShortTimeFourierTransform(signal.begin(), signal.end(), 480, experimental::optional<float*>(), 160, 3), mixed);
+    }
+    
+    SUBCASE("Errors")
+    {
+        Spectrogram<float> spectrogram;
+        CHECK_THROWS_AS(shortTimeFourierTransform(signal.begin(), signal.end(), 256, experimental::optional<float*>(), 0), invalid_argument);
+        CHECK_THROWS_AS(shortTimeFourierTransform(signal.begin(), signal.end(), 256, experimental::optional<float*>(), 0, spectrogram), invalid_argument);
+        CHECK_THROWS_AS(parallelShortTimeFourierTransform(signal.begin(), signal.end(), 256, experimental::optional<float*>(), 0, 2), invalid_argument);
+        CHECK_THROWS_AS(parallelShortTimeFourierTransform(signal.begin(), signal.end(), 256, experimental::optional<float*>(), 0, spectrogram, 2), invalid_argument);
+        CHECK_THROWS_AS(inverseShortTimeFourierTransform(vector<Spectrum<float>>(1, Spectrum<float>(vector<complex<float>>(129))), 256, vector<float>(), 0), invalid_argument);
+        
+        // An exception in any of the threads reaches the caller, after all of them are joined
+        const auto window = experimental::make_optional(ThrowingWindowIterator());
+        CHECK_THROWS_AS(parallelShortTimeFourierTransform(signal.begin(), signal.end(), 256, window, 100, spectrogram, 4), runtime_error);
+    }
+    
+    SUBCASE("Spectrogram")
+    {
+        const auto window = createHanningWindow<float>(512);
+        const auto windowBegin = experimental::make_optional(window.begin());
+        const auto spectra = shortTimeFourierTransform(signal.begin(), signal.end(), 512, windowBegin, 128);
+        
+        // Both layouts hold the same bins as the list of spectra
+        for (auto layout : {Spectrogram<float>::Layout::FRAME_MAJOR, Spectrogram<float>::Layout::BIN_MAJOR})
+        {
+            Spectrogram<float> serial(0, 0, layout);
+            shortTimeFourierTransform(signal.begin(), signal.end(), 512, windowBegin, 128, serial);
+            
+            Spectrogram<float> parallel(0, 0, layout);
+            parallelShortTimeFourierTransform(signal.begin(), signal.end(), 512, windowBegin, 128, parallel, 3);
+            
+            REQUIRE(serial.getFrameCount() == spectra.size());
+            REQUIRE(serial.getBinCount() == 257);
+            for (size_t f = 0; f < spectra.size(); ++f)
+            {
+                CHECK(serial.getSpectrum(f).data == spectra[f].data);
+                CHECK(parallel.getSpectrum(f).data == spectra[f].data);
+            }
+        }
+    }
+    
+    SUBCASE("Inverse")
+    {
+        // Reconstruction is exact up to the edges, except where the window is (nearly) zero
+        const auto window = createHanningWindow<float>(256);
+        const auto spectra = shortTimeFourierTransform(signal.begin(), signal.end(), 256, experimental::make_optional(window.begin()), 64);
+        const auto output = inverseShortTimeFourierTransform(spectra, 256, window, 64);
+        
+        REQUIRE(output.size() == (spectra.size() - 1) * 64 + 256);
+        CHECK(output[0] == 0);
+        for (size_t i = 8; i < signal.size(); ++i)
+            CHECK(output[i] == doctest::Approx(signal[i]).epsilon(1e-4));
+        
+        // The zero-padding of the last frames comes back as zeros
+        for (auto i = signal.size(); i < output.size() - 1; ++i)
+            CHECK(output[i] == doctest::Approx(0).epsilon(1e-4));
+        
+        // Without window
+        const auto rectangular = inverseShortTimeFourierTransform(shortTimeFourierTransform(signal.begin(), signal.end(), 480, experimental::optional<float*>(), 160), 480, {}, 160);
+        for (size_t i = 0; i < signal.size(); ++i)
+            CHECK(rectangular[i] == doctest::Approx(signal[i]).epsilon(1e-4));
+    }
+}
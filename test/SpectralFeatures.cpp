@@ -0,0 +1,168 @@
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../HighFrequencyContent.hpp"
+#include "../SpectralCentroid.hpp"
+#include "../SpectralFeatures.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Compute the features one definition at a time, in double precision
+template <typename T>
+static SpectralFeatures<double> computeReference(const vector<T>& magnitudes, const vector<T>& previous, double rolloffFraction)
+{
+    SpectralFeatures<double> features;
+    double sum = 0, logSum = 0;
+    for (size_t k = 0; k < magnitudes.size(); ++k)
+    {
+        const double power = double(magnitudes[k]) * magnitudes[k];
+        sum += magnitudes[k];
+        features.energy += power;
+        logSum += log(max(power, double(numeric_limits<T>::min())));
+        features.flux += max(double(magnitudes[k]) - (previous.empty() ? magnitudes[k] : previous[k]), 0.0);
+    }
+    
+    features.centroid = spectralCentroid(magnitudes.begin(), magnitudes.end());
+    for (size_t k = 0; k < magnitudes.size(); ++k)
+        features.spread += magnitudes[k] * (k - features.centroid) * (k - features.centroid);
+    
+    features.spread = sqrt(features.spread / sum);
+    features.flatness = exp(logSum / magnitudes.size()) / (features.energy / magnitudes.size());
+    
+    double cumulative = 0;
+    for (size_t k = 0; k < magnitudes.size(); ++k)
+    {
+        cumulative += double(magnitudes[k]) * magnitudes[k];
+        if (cumulative >= rolloffFraction * features.energy)
+        {
+            features.rolloff = k;
+            break;
+        }
+    }
+    
+    features.highFrequencyContentBrossier = highFrequencyContentBrossier(magnitudes.begin(), magnitudes.end());
+    features.highFrequencyContentMasri = highFrequencyContentMasri(magnitudes.begin(), magnitudes.end());
+    features.highFrequencyContentJensen = highFrequencyContentJensen(magnitudes.begin(), magnitudes.end());
+    
+    return features;
+}
+
+template <typename T>
+static void checkFeatures(const SpectralFeatures<T>& features, const SpectralFeatures<double>& reference, double epsilon)
+{
+    CHECK(features.centroid == doctest::Approx(reference.centroid).epsilon(epsilon));
+    CHECK(features.spread == doctest::Approx(reference.spread).epsilon(epsilon));
+    CHECK(abs(features.rolloff - reference.rolloff) <= 1);
+    CHECK(features.flatness == doctest::Approx(reference.flatness).epsilon(epsilon));
+    CHECK(features.flux == doctest::Approx(reference.flux).epsilon(epsilon));
+    CHECK(features.energy == doctest::Approx(reference.energy).epsilon(epsilon));
+    CHECK(features.highFrequencyContentBrossier == doctest::Approx(reference.highFrequencyContentBrossier).epsilon(epsilon));
+    CHECK(features.highFrequencyContentMasri == doctest::Approx(reference.highFrequencyContentMasri).epsilon(epsilon));
+    CHECK(features.highFrequencyContentJensen == doctest::Approx(reference.highFrequencyContentJensen).epsilon(epsilon));
+}
+
+template <typename T>
+static void checkSpectra(double epsilon)
+{
+    // Sizes around the vector and block widths, and those of common transforms
+    for (size_t size : {1, 2, 15, 16, 17, 63, 64, 65, 100, 513, 2049, 20000})
+    {
+        vector<T> magnitudes(size), previous(size);
+        for (size_t k = 0; k < size; ++k)
+        {
+            magnitudes[k] = 1.5 + sin(k * 0.37) + 0.5 * cos(k * 0.011);
+            previous[k] = 1.5 + sin(k * 0.29);
+        }
+        
+        checkFeatures(computeSpectralFeatures(magnitudes.data(), previous.data(), size, T(0.85)), computeReference(magnitudes, previous, 0.85), epsilon);
+        checkFeatures(computeSpectralFeatures(magnitudes.data(), nullptr, size, T(0.5)), computeReference(magnitudes, {}, 0.5), epsilon);
+    }
+}
+
+TEST_CASE("SpectralFeatures float")
+{
+    checkSpectra<float>(1e-4);
+}
+
+TEST_CASE("SpectralFeatures double")
+{
+    checkSpectra<double>(1e-9);
+}
+
+TEST_CASE("SpectralFeatures edge cases")
+{
+    SUBCASE("silence")
+    {
+        const vector<float> silence(1024, 0);
+        const auto features = computeSpectralFeatures(silence.data(), nullptr, silence.size());
+        CHECK(features.centroid == 0);
+        CHECK(features.flatness == 0);
+        CHECK(features.energy == 0);
+        CHECK(features.rolloff == 0);
+    }
+    
+    SUBCASE("white and tonal")
+    {
+        vector<float> white(1024, 2);
+        CHECK(computeSpectralFeatures(white.data(), nullptr, white.size()).flatness == doctest::Approx(1));
+        CHECK(computeSpectralFeatures(white.data(), nullptr, white.size()).spread == doctest::Approx(sqrt((1024.0 * 1024 - 1) / 12)));
+        
+        vector<float> tone(1024, 0);
+        tone[300] = 1;
+        const auto features = computeSpectralFeatures(tone.data(), nullptr, tone.size(), 0.01f);
+        CHECK(features.flatness < 1e-6);
+        CHECK(features.centroid == doctest::Approx(300));
+        CHECK(features.spread == doctest::Approx(0));
+        CHECK(features.rolloff == 300);
+    }
+    
+    SUBCASE("flux only counts rises")
+    {
+        const vector<float> previous = {1, 2, 3, 4};
+        const vector<float> current = {2, 2, 1, 6};
+        CHECK(computeSpectralFeatures(current.data(), previous.data(), 4).flux == doctest::Approx(3));
+    }
+}
+
+TEST_CASE("SpectralFeatures spectrogram")
+{
+    const size_t frameCount = 7;
+    const size_t binCount = 129;
+    
+    for (auto layout : {Spectrogram<float>::Layout::FRAME_MAJOR, Spectrogram<float>::Layout::BIN_MAJOR})
+    {
+        Spectrogram<float> spectrogram(frameCount, binCount, layout);
+        for (size_t frame = 0; frame < frameCount; ++frame)
+            for (size_t bin = 0; bin < binCount; ++bin)
+                spectrogram(frame, bin) = polar(float(1 + sin(bin * 0.1 + frame)), float(bin * frame * 0.3));
+        
+        vector<float> matrix(SPECTRAL_FEATURE_COUNT * frameCount);
+        computeSpectralFeatures(spectrogram, matrix.data());
+        
+        vector<float> previous;
+        for (size_t frame = 0; frame < frameCount; ++frame)
+        {
+            vector<float> magnitudes(binCount);
+            for (size_t bin = 0; bin < binCount; ++bin)
+                magnitudes[bin] = abs(spectrogram(frame, bin));
+            
+            const auto expected = computeSpectralFeatures(magnitudes.data(), previous.empty() ? nullptr : previous.data(), binCount);
+            const auto row = [&](SpectralFeature feature) { return matrix[static_cast<size_t>(feature) * frameCount + frame]; };
+            CHECK(row(SpectralFeature::CENTROID) == doctest::Approx(expected.centroid));
+            CHECK(row(SpectralFeature::SPREAD) == doctest::Approx(expected.spread));
+            CHECK(row(SpectralFeature::ROLLOFF) == expected.rolloff);
+            CHECK(row(SpectralFeature::FLATNESS) == doctest::Approx(expected.flatness));
+            CHECK(row(SpectralFeature::FLUX) == doctest::Approx(expected.flux));
+            CHECK(row(SpectralFeature::ENERGY) == doctest::Approx(expected.energy));
+            CHECK(row(SpectralFeature::HIGH_FREQUENCY_CONTENT_BROSSIER) == doctest::Approx(expected.highFrequencyContentBrossier));
+            CHECK(row(SpectralFeature::HIGH_FREQUENCY_CONTENT_MASRI) == doctest::Approx(expected.highFrequencyContentMasri));
+            CHECK(row(SpectralFeature::HIGH_FREQUENCY_CONTENT_JENSEN) == doctest::Approx(expected.highFrequencyContentJensen));
+            
+            previous = magnitudes;
+        }
+    }
+}
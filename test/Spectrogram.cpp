@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../Spectrogram.hpp"
+
+using namespace dsp;
+using namespace std;
+
+TEST_CASE("Spectrogram")
+{
+    Spectrogram<float> spectrogram(4, 3);
+    for (auto f = 0; f < 4; ++f)
+        for (auto b = 0; b < 3; ++b)
+            spectrogram(f, b) = {float(f), float(b)};
+    
+    SUBCASE("Frame-major storage")
+    {
+        CHECK(spectrogram.getFrameCount() == 4);
+        CHECK(spectrogram.getBinCount() == 3);
+        CHECK(spectrogram.data()[5] == complex<float>(1, 2));
+        
+        // Frames are contiguous
+        const auto frame = spectrogram.getFrame(2);
+        CHECK(frame.isContiguous());
+        CHECK(frame.size() == 3);
+        CHECK(frame.data() == spectrogram.data() + 6);
+        CHECK(frame[1] == complex<float>(2, 1));
+        
+        // Bin tracks are strided views into the same buffer
+        const auto track = spectrogram.getTrack(1);
+        CHECK(!track.isContiguous());
+        CHECK(track.size() == 4);
+        CHECK(track.stride() == 3);
+        CHECK(&track[3] == &spectrogram(3, 1));
+        
+        vector<complex<float>> copy(track.begin(), track.end());
+        const vector<complex<float>> expected{{0, 1}, {1, 1}, {2, 1}, {3, 1}};
+        CHECK(copy == expected);
+        CHECK(track.end() - track.begin() == 4);
+    }
+    
+    SUBCASE("Writing through the views")
+    {
+        auto track = spectrogram.getTrack(2);
+        fill(track.begin(), track.end(), complex<float>(7, 7));
+        
+        CHECK(spectrogram(0, 2) == complex<float>(7, 7));
+        CHECK(spectrogram(3, 2) == complex<float>(7, 7));
+        CHECK(spectrogram(3, 1) == complex<float>(3, 1));
+        
+        spectrogram.getFrame(1)[0] = {9, 9};
+        CHECK(spectrogram(1, 0) == complex<float>(9, 9));
+    }
+    
+    SUBCASE("Bin-major storage")
+    {
+        spectrogram.setLayout(Spectrogram<float>::Layout::BIN_MAJOR);
+        CHECK(spectrogram.getLayout() == Spectrogram<float>::Layout::BIN_MAJOR);
+        
+        // The bins keep their place, but now the tracks are contiguous
+        for (auto f = 0; f < 4; ++f)
+            for (auto b = 0; b < 3; ++b)
+                CHECK(spectrogram(f, b) == complex<float>(f, b));
+        
+        const auto track = spectrogram.getTrack(1);
+        CHECK(track.isContiguous());
+        CHECK(track.data() == spectrogram.data() + 4);
+        
+        const auto frame = spectrogram.getFrame(2);
+        CHECK(frame.stride() == 4);
+        const vector<complex<float>> expected{{2, 0}, {2, 1}, {2, 2}};
+        CHECK(spectrogram.getSpectrum(2).data == expected);
+        
+        // The last frame is strided up to the end of the storage, its iterators may not step beyond it
+        const auto last = spectrogram.getFrame(3);
+        const vector<complex<float>> reversed(make_reverse_iterator(last.end()), make_reverse_iterator(last.begin()));
+        const vector<complex<float>> expectedReversed{{3, 2}, {3, 1}, {3, 0}};
+        CHECK(reversed == expectedReversed);
+        
+        auto it = last.begin();
+        CHECK(2 + it == last.end() - 1);
+        CHECK(it < last.end());
+        CHECK(last.end() > it);
+        CHECK(it <= it);
+        CHECK(last.end() >= it + 3);
+        CHECK(it[2] == complex<float>(3, 2));
+        
+        // And back
+        spectrogram.setLayout(Spectrogram<float>::Layout::FRAME_MAJOR);
+        CHECK(spectrogram.data()[5] == complex<float>(1, 2));
+    }
+    
+    SUBCASE("Empty and out of range")
+    {
+        // Bins without frames give empty tracks, without touching the (empty) storage
+        Spectrogram<float> empty(0, 3);
+        CHECK(empty.getTrack(2).size() == 0);
+        CHECK(empty.getTrack(2).begin() == empty.getTrack(2).end());
+        CHECK_THROWS_AS(empty.getFrame(0), out_of_range);
+        CHECK_THROWS_AS(empty.getTrack(3), out_of_range);
+        
+        CHECK_THROWS_AS(spectrogram.getFrame(4), out_of_range);
+        CHECK_THROWS_AS(spectrogram.getTrack(3), out_of_range);
+    }
+}
@@ -0,0 +1,129 @@
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <experimental/optional>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../ShortTimeFourierTransform.hpp"
+#include "../SpectrogramFile.hpp"
+#include "../StreamingShortTimeFourierTransform.hpp"
+#include "../Window.hpp"
+
+using namespace dsp;
+using namespace std;
+
+TEST_CASE("SpectrogramFile")
+{
+    const auto path = "SpectrogramFileTest.spectrogram";
+    
+    vector<float> signal(5000);
+    for (size_t i = 0; i < signal.size(); ++i)
+        signal[i] = sin(i * 0.05f) + 0.3f * cos(i * 1.1f);
+    
+    const auto window = createHanningWindow<float>(512);
+    const auto spectra = shortTimeFourierTransform(signal.begin(), signal.end(), 512, experimental::make_optional(window.begin()), 128);
+    
+    SUBCASE("Streaming the short-time Fourier transform into a file")
+    {
+        {
+            SpectrogramFileWriter writer(path, 512, 128, 44100, window);
+            shortTimeFourierTransform(signal.begin(), signal.end(), writer);
+            CHECK(writer.getFrameCount() == spectra.size());
+        }
+        
+        SpectrogramFile file(path);
+        CHECK(file.getFrameSize() == 512);
+        CHECK(file.getHopSize() == 128);
+        CHECK(file.getSampleRate() == 44100);
+        CHECK(file.getWindow() == window);
+        REQUIRE(file.getFrameCount() == spectra.size());
+        REQUIRE(file.getBinCount() == 257);
+        
+        // The frames are bit-identical to the ones computed in memory
+        for (size_t f = 0; f < spectra.size(); ++f)
+        {
+            const auto frame = file.getFrame(f);
+            CHECK(frame.isContiguous());
+            CHECK(vector<complex<float>>(frame.begin(), frame.end()) == spectra[f].data);
+        }
+        
+        const auto track = file.getTrack(3);
+        REQUIRE(track.size() == spectra.size());
+        for (size_t f = 0; f < spectra.size(); ++f)
+            CHECK(track[f] == spectra[f][3]);
+        
+        CHECK_THROWS_AS(file.getFrame(spectra.size()), out_of_range);
+        CHECK_THROWS_AS(file.getTrack(257), out_of_range);
+        
+        // Moving keeps the mapping alive
+        auto moved = move(file);
+        CHECK(moved.getFrame(2)[5] == spectra[2][5]);
+    }
+    
+    SUBCASE("Split spectra from the streaming transform, without window")
+    {
+        StreamingShortTimeFourierTransform<float> stft(256, 256);
+        vector<complex<float>> firstFrame;
+        
+        {
+            SpectrogramFileWriter writer(path, 256, 256, 48000);
+            stft.write(signal.data(), 1024, [&](const float* real, const float* imaginary)
+            {
+                if (firstFrame.empty())
+                    for (auto k = 0; k < 129; ++k)
+                        firstFrame.emplace_back(real[k], imaginary[k]);
+                
+                writer.write(real, imaginary);
+            });
+            
+            writer.close();
+        }
+        
+        SpectrogramFile file(path);
+        CHECK(file.getWindow().empty());
+        REQUIRE(file.getFrameCount() == 4);
+        CHECK(vector<complex<float>>(file.getFrame(0).begin(), file.getFrame(0).end()) == firstFrame);
+    }
+    
+    SUBCASE("Invalid files")
+    {
+        CHECK_THROWS_AS(SpectrogramFile("SpectrogramFileTest.missing"), runtime_error);
+        
+        {
+            ofstream stream(path, ios::binary);
+            stream << "not a spectrogram, but long enough to hold a header of sixty-four bytes";
+        }
+        
+        CHECK_THROWS_AS(SpectrogramFile{path}, runtime_error);
+        CHECK_THROWS_AS(SpectrogramFileWriter(path, 512, 0, 44100.0), invalid_argument);
+        
+        // A 72 byte file with two bins per frame, whose frame count times the frame size overflows to zero
+        const auto writeHeader = [&](uint64_t frameCount, uint64_t windowSize)
+        {
+            // Version and reserved, frame size, hop size, bin count, frame count, sample rate, window size and 8 bytes of data
+            const uint64_t fields[8] = {1, 2, 1, 2, frameCount, 0, windowSize, 0};
+            ofstream stream(path, ios::binary);
+            stream.write("GRZSPECT", 8);
+            stream.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+        };
+        
+        writeHeader(0, 0);
+        CHECK(SpectrogramFile(path).getFrameCount() == 0);
+        CHECK(SpectrogramFile(path).getTrack(1).size() == 0);
+        CHECK_THROWS_AS(SpectrogramFile(path).getFrame(0), out_of_range);
+        
+        writeHeader(uint64_t(1) << 60, 0);
+        CHECK_THROWS_AS(SpectrogramFile{path}, runtime_error);
+        
+        // And a window that runs past the end of the file
+        writeHeader(0, uint64_t(1) << 62);
+        CHECK_THROWS_AS(SpectrogramFile{path}, runtime_error);
+    }
+    
+    remove(path);
+}
@@ -83,4 +83,56 @@ TEST_CASE("Spectrum")
         for (auto& value: imaginary)
             CHECK(value == doctest::Approx(0));
     }
-}
\ No newline at end of file
+    
+    SUBCASE("powers")
+    {
+        for (auto& value: spectrum.powers())
+            CHECK(value == doctest::Approx(25));
+    }
+    
+    SUBCASE("replace real and imaginary data")
+    {
+        spectrum.replaceRealData({1, 2, 3, 4});
+        spectrum.replaceImaginaryData({0, 0, 0, 0});
+        
+        CHECK(spectrum[1] == complex<float>(2, 0));
+        CHECK(spectrum.magnitudes()[3] == doctest::Approx(4));
+    }
+    
+    SUBCASE("cache")
+    {
+        // Repeated queries hand out the same cached array
+        const auto& magnitudes = spectrum.magnitudes();
+        CHECK(&spectrum.magnitudes() == &magnitudes);
+        CHECK(spectrum.phases()[0].value == doctest::Approx(0.9273));
+        CHECK(spectrum.powers()[0] == doctest::Approx(25));
+        
+        // Mutable access invalidates it
+        spectrum[0] = {0, 2};
+        CHECK(spectrum.magnitudes()[0] == doctest::Approx(2));
+        CHECK(spectrum.powers()[0] == doctest::Approx(4));
+        CHECK(spectrum.phases()[0].value == doctest::Approx(1.5708));
+        
+        for (auto& bin : spectrum)
+            bin *= 2;
+        
+        CHECK(spectrum.magnitudes()[1] == doctest::Approx(10));
+        
+        spectrum.replaceMagnitudes({1, 1, 1, 1});
+        CHECK(spectrum.magnitudes()[2] == doctest::Approx(1));
+        CHECK(spectrum.phases()[2].value == doctest::Approx(-0.9273));
+        
+        spectrum.replacePhases(vector<unit::radian<float>>(4, 0.f));
+        CHECK(spectrum.phases()[3].value == doctest::Approx(0));
+        CHECK(spectrum[3].real() == doctest::Approx(1));
+        
+        // Writing to the data directly needs an explicit invalidate
+        spectrum.data[0] = {3, 0};
+        spectrum.invalidate();
+        CHECK(spectrum.magnitudes()[0] == doctest::Approx(3));
+        
+        // A temporary hands out a copy instead of a dangling reference
+        for (auto& value : Spectrum<float>(vector<complex<float>>(2, {0, 1})).magnitudes())
+            CHECK(value == doctest::Approx(1));
+    }
+}
@@ -0,0 +1,171 @@
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../SplitSpectrum.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Return the largest absolute difference between two arrays
+template <typename T>
+static T getMaximumError(const vector<T>& lhs, const vector<T>& rhs)
+{
+    T error = 0;
+    for (size_t i = 0; i < lhs.size(); ++i)
+        error = max(error, abs(lhs[i] - rhs[i]));
+    
+    return error;
+}
+
+template <typename T>
+static void checkConversions(T exactTolerance)
+{
+    // Bins all around the unit circle, at several magnitudes, including the axes and zero
+    SplitSpectrum<T> spectrum(1003);
+    for (size_t k = 0; k < spectrum.size(); ++k)
+        spectrum.setBin(k, polar(T(pow(10, static_cast<int>(k % 7) - 3)), T(k * 0.37 - 180)));
+    
+    spectrum.setBin(0, {0, 0});
+    spectrum.setBin(1, {2, 0});
+    spectrum.setBin(2, {-2, 0});
+    spectrum.setBin(3, {0, 2});
+    spectrum.setBin(4, {0, -2});
+    spectrum.setBin(5, {-1, -1});
+    
+    const auto size = spectrum.size();
+    vector<T> expectedMagnitudes(size), expectedPhases(size), expectedPowers(size), expectedDecibels(size);
+    for (size_t k = 0; k < size; ++k)
+    {
+        const auto bin = spectrum.getBin(k);
+        expectedMagnitudes[k] = abs(bin);
+        expectedPhases[k] = arg(bin);
+        expectedPowers[k] = norm(bin);
+        expectedDecibels[k] = max(T(20) * log10(abs(bin)), T(-150));
+    }
+    
+    vector<T> output(size);
+    
+    SUBCASE("Powers")
+    {
+        spectrum.powers(output.data());
+        for (size_t k = 0; k < size; ++k)
+            CHECK(output[k] == doctest::Approx(expectedPowers[k]).epsilon(exactTolerance));
+    }
+    
+    SUBCASE("Magnitudes")
+    {
+        spectrum.magnitudes(output.data());
+        for (size_t k = 0; k < size; ++k)
+            CHECK(output[k] == doctest::Approx(expectedMagnitudes[k]).epsilon(exactTolerance));
+        
+        spectrum.magnitudes(output.data(), SpectrumAccuracy::FAST);
+        CHECK(output[0] == 0);
+        for (size_t k = 1; k < size; ++k)
+            CHECK(output[k] == doctest::Approx(expectedMagnitudes[k]).epsilon(1e-5));
+    }
+    
+    SUBCASE("Decibels")
+    {
+        spectrum.decibels(output.data(), -150);
+        CHECK(getMaximumError(output, expectedDecibels) < exactTolerance * 100);
+        CHECK(output[0] == doctest::Approx(-150));
+        
+        spectrum.decibels(output.data(), -150, SpectrumAccuracy::FAST);
+        CHECK(getMaximumError(output, expectedDecibels) < 1e-3);
+    }
+    
+    SUBCASE("Phases")
+    {
+        spectrum.phases(output.data());
+        CHECK(getMaximumError(output, expectedPhases) < exactTolerance * 4);
+        CHECK(output[0] == 0);
+        CHECK(output[2] == doctest::Approx(M_PI));
+        CHECK(output[3] == doctest::Approx(M_PI / 2));
+        CHECK(output[4] == doctest::Approx(-M_PI / 2));
+        CHECK(output[5] == doctest::Approx(-3 * M_PI / 4));
+        
+        spectrum.phases(output.data(), SpectrumAccuracy::FAST);
+        CHECK(getMaximumError(output, expectedPhases) < 2e-5);
+    }
+    
+    SUBCASE("Polar to cartesian")
+    {
+        // Unwrapped phases, as a phase vocoder accumulates them
+        vector<T> phases(size);
+        for (size_t k = 0; k < size; ++k)
+            phases[k] = expectedPhases[k] + T(2 * M_PI) * T(static_cast<int>(k % 100) - 50);
+        
+        for (auto accuracy : {SpectrumAccuracy::EXACT, SpectrumAccuracy::FAST})
+        {
+            SplitSpectrum<T> result(size);
+            result.setPolar(expectedMagnitudes.data(), phases.data(), accuracy);
+            
+            // Errors relative to the magnitude, against the phases as they're rounded to T
+            T error = 0;
+            for (size_t k = 0; k < size; ++k)
+            {
+                const auto expected = polar<long double>(expectedMagnitudes[k], phases[k]);
+                error = max<T>(error, abs(complex<long double>(result.getBin(k)) - expected) / expectedMagnitudes[k]);
+            }
+            
+            CHECK(error < ((accuracy == SpectrumAccuracy::EXACT) ? exactTolerance * 4 : 1e-4));
+        }
+        
+        // In place, from polar in the real and imaginary arrays
+        SplitSpectrum<T> inPlace(size);
+        inPlace.real = expectedMagnitudes;
+        inPlace.imaginary = expectedPhases;
+        inPlace.setPolar(inPlace.real.data(), inPlace.imaginary.data());
+        for (size_t k = 1; k < size; ++k)
+            CHECK(abs(inPlace.getBin(k) - spectrum.getBin(k)) / expectedMagnitudes[k] < exactTolerance * 4);
+    }
+}
+
+TEST_CASE("SplitSpectrum")
+{
+    SUBCASE("Conversion from and to interleaved spectra")
+    {
+        const Spectrum<float> interleaved = vector<complex<float>>{{3, 4}, {-3, 4}, {3, -4}};
+        SplitSpectrum<float> spectrum(interleaved);
+        
+        CHECK(spectrum.real == vector<float>({3, -3, 3}));
+        CHECK(spectrum.imaginary == vector<float>({4, 4, -4}));
+        CHECK(spectrum.toSpectrum().data == interleaved.data);
+    }
+    
+    SUBCASE("Multiply-accumulate")
+    {
+        // Enough bins for the vectors and a remainder
+        const size_t size = 37;
+        vector<float> lhsReal(size), lhsImaginary(size), rhsReal(size), rhsImaginary(size), real(size, 1), imaginary(size, -1);
+        for (size_t k = 0; k < size; ++k)
+        {
+            lhsReal[k] = k * 0.5f;
+            lhsImaginary[k] = 3 - static_cast<float>(k);
+            rhsReal[k] = sin(k);
+            rhsImaginary[k] = cos(k);
+        }
+        
+        multiplyAccumulate(lhsReal.data(), lhsImaginary.data(), rhsReal.data(), rhsImaginary.data(), real.data(), imaginary.data(), size);
+        for (size_t k = 0; k < size; ++k)
+        {
+            const auto expected = complex<float>(1, -1) + complex<float>(lhsReal[k], lhsImaginary[k]) * complex<float>(rhsReal[k], rhsImaginary[k]);
+            CHECK(real[k] == doctest::Approx(expected.real()));
+            CHECK(imaginary[k] == doctest::Approx(expected.imag()));
+        }
+    }
+}
+
+// Separate test cases, as the subcases of the conversions are only told apart by where they're written
+TEST_CASE("SplitSpectrum float conversions")
+{
+    checkConversions<float>(1e-6);
+}
+
+TEST_CASE("SplitSpectrum double conversions")
+{
+    checkConversions<double>(1e-14);
+}
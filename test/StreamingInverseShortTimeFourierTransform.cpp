@@ -0,0 +1,89 @@
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../StreamingInverseShortTimeFourierTransform.hpp"
+#include "../StreamingShortTimeFourierTransform.hpp"
+#include "../Window.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! Analyze and resynthesize a signal in blocks, returning the output stream
+static vector<float> resynthesize(const vector<float>& signal, size_t frameSize, size_t hopSize, const vector<float>& window, size_t blockSize)
+{
+    StreamingShortTimeFourierTransform<float> analysis(frameSize, hopSize, window);
+    StreamingInverseShortTimeFourierTransform<float> synthesis(frameSize, hopSize, window);
+    
+    vector<float> output;
+    vector<float> hop(hopSize);
+    for (size_t start = 0; start < signal.size(); start += blockSize)
+    {
+        analysis.write(signal.data() + start, min(blockSize, signal.size() - start), [&](const float* real, const float* imaginary)
+        {
+            synthesis.write(real, imaginary, hop.data());
+            output.insert(output.end(), hop.begin(), hop.end());
+        });
+    }
+    
+    return output;
+}
+
+TEST_CASE("StreamingInverseShortTimeFourierTransform")
+{
+    vector<float> signal(2000);
+    for (size_t i = 0; i < signal.size(); ++i)
+        signal[i] = sin(i * 0.05f) + 0.3f * cos(i * 1.1f);
+    
+    SUBCASE("Perfect reconstruction")
+    {
+        for (size_t hopSize : {16, 32, 40, 48})
+        {
+            const auto output = resynthesize(signal, 64, hopSize, createHanningWindow<float>(64), 37);
+            
+            // Each frame outputs one hop, the samples before the first full overlap miss earlier frames
+            REQUIRE(output.size() == ((signal.size() - 64) / hopSize + 1) * hopSize);
+            for (auto i = 64 - hopSize; i < output.size(); ++i)
+                CHECK(output[i] == doctest::Approx(signal[i]).epsilon(1e-4));
+        }
+        
+        // Without window, and with mixed radix frames
+        const auto output = resynthesize(signal, 60, 20, {}, 100);
+        for (size_t i = 40; i < output.size(); ++i)
+            CHECK(output[i] == doctest::Approx(signal[i]).epsilon(1e-4));
+    }
+    
+    SUBCASE("Flush")
+    {
+        // Without overlap, a frame comes out right away
+        StreamingInverseShortTimeFourierTransform<float> synthesis(8, 4);
+        CHECK(synthesis.getFrameSize() == 8);
+        CHECK(synthesis.getHopSize() == 4);
+        
+        vector<float> real = {8, 0, 0, 0, 0};
+        vector<float> imaginary(5, 0);
+        vector<float> output(4);
+        
+        // A DC spectrum of 8 is a frame of ones, weighted by half because two frames overlap every sample
+        synthesis.write(real.data(), imaginary.data(), output.data());
+        for (auto& x : output)
+            CHECK(x == doctest::Approx(0.5));
+        
+        synthesis.flush(output.data());
+        for (auto& x : output)
+            CHECK(x == doctest::Approx(0.5));
+        
+        // Flushing starts over
+        synthesis.write(real.data(), imaginary.data(), output.data());
+        CHECK(output[0] == doctest::Approx(0.5));
+    }
+    
+    SUBCASE("Invalid arguments")
+    {
+        CHECK_THROWS_AS(StreamingInverseShortTimeFourierTransform<float>(64, 0), std::invalid_argument);
+        CHECK_THROWS_AS(StreamingInverseShortTimeFourierTransform<float>(64, 65), std::invalid_argument);
+        CHECK_THROWS_AS(StreamingInverseShortTimeFourierTransform<float>(64, 16, vector<float>(32)), std::invalid_argument);
+    }
+}
@@ -0,0 +1,128 @@
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../FastFourierTransform.hpp"
+#include "../StreamingShortTimeFourierTransform.hpp"
+#include "../Window.hpp"
+
+using namespace dsp;
+using namespace std;
+
+//! The spectra of all frames in a signal, computed offline
+static vector<vector<float>> computeSpectra(const vector<float>& signal, size_t frameSize, size_t hopSize, const vector<float>& window)
+{
+    auto fft = createFastFourierTransform(frameSize);
+    vector<vector<float>> spectra;
+    
+    for (auto start = 0; start + frameSize <= signal.size(); start += hopSize)
+    {
+        vector<float> frame(signal.begin() + start, signal.begin() + start + frameSize);
+        for (size_t i = 0; i < frameSize; ++i)
+            frame[i] *= window.empty() ? 1 : window[i];
+        
+        vector<float> spectrum((frameSize / 2 + 1) * 2);
+        fft->forward(frame.data(), spectrum.data(), spectrum.data() + frameSize / 2 + 1);
+        spectra.emplace_back(spectrum);
+    }
+    
+    return spectra;
+}
+
+//! Stream a signal in blocks of a given size, collecting the spectra through the callback
+static vector<vector<float>> streamSpectra(StreamingShortTimeFourierTransform<float>& stft, const vector<float>& signal, size_t blockSize)
+{
+    const auto binCount = stft.getBinCount();
+    vector<vector<float>> spectra;
+    
+    for (size_t start = 0; start < signal.size(); start += blockSize)
+    {
+        const auto count = min(blockSize, signal.size() - start);
+        stft.write(signal.data() + start, count, [&](const float* real, const float* imaginary)
+        {
+            vector<float> spectrum(real, real + binCount);
+            spectrum.insert(spectrum.end(), imaginary, imaginary + binCount);
+            spectra.emplace_back(spectrum);
+        });
+    }
+    
+    return spectra;
+}
+
+static void checkSpectra(const vector<vector<float>>& spectra, const vector<vector<float>>& expected)
+{
+    REQUIRE(spectra.size() == expected.size());
+    for (size_t i = 0; i < spectra.size(); ++i)
+        for (size_t k = 0; k < spectra[i].size(); ++k)
+            CHECK(spectra[i][k] == doctest::Approx(expected[i][k]));
+}
+
+TEST_CASE("StreamingShortTimeFourierTransform")
+{
+    vector<float> signal(1000);
+    for (size_t i = 0; i < signal.size(); ++i)
+        signal[i] = sin(i * 0.1f) + 0.5f * cos(i * 0.77f);
+    
+    SUBCASE("Block sizes")
+    {
+        const auto window = createHanningWindow<float>(64);
+        const auto expected = computeSpectra(signal, 64, 16, window);
+        
+        StreamingShortTimeFourierTransform<float> stft(64, 16, window);
+        CHECK(stft.getFrameSize() == 64);
+        CHECK(stft.getHopSize() == 16);
+        CHECK(stft.getBinCount() == 33);
+        
+        for (size_t blockSize : {1, 7, 16, 100, 1000})
+        {
+            stft.reset();
+            checkSpectra(streamSpectra(stft, signal, blockSize), expected);
+        }
+    }
+    
+    SUBCASE("Hop larger than the frame")
+    {
+        StreamingShortTimeFourierTransform<float> stft(32, 50);
+        checkSpectra(streamSpectra(stft, signal, 13), computeSpectra(signal, 32, 50, {}));
+    }
+    
+    SUBCASE("Non power of two frames")
+    {
+        StreamingShortTimeFourierTransform<float> stft(60, 20);
+        checkSpectra(streamSpectra(stft, signal, 33), computeSpectra(signal, 60, 20, {}));
+    }
+    
+    SUBCASE("Pull")
+    {
+        StreamingShortTimeFourierTransform<float> stft(64, 32);
+        const auto expected = computeSpectra(signal, 64, 32, {});
+        
+        vector<float> real(33), imaginary(33);
+        CHECK(!stft.read(real.data(), imaginary.data()));
+        
+        // A frame completes at sample 64, after which the writing stops
+        CHECK(stft.write(signal.data(), 100) == 64);
+        CHECK(stft.isReady());
+        REQUIRE(stft.read(real.data(), imaginary.data()));
+        CHECK(!stft.isReady());
+        
+        for (auto k = 0; k < 33; ++k)
+        {
+            CHECK(real[k] == doctest::Approx(expected[0][k]));
+            CHECK(imaginary[k] == doctest::Approx(expected[0][33 + k]));
+        }
+        
+        // The next one a hop later
+        CHECK(stft.write(signal.data() + 64, 36) == 32);
+        REQUIRE(stft.read(real.data(), imaginary.data()));
+        CHECK(real[3] == doctest::Approx(expected[1][3]));
+    }
+    
+    SUBCASE("Invalid arguments")
+    {
+        CHECK_THROWS_AS(StreamingShortTimeFourierTransform<float>(64, 0), std::invalid_argument);
+        CHECK_THROWS_AS(StreamingShortTimeFourierTransform<float>(64, 16, vector<float>(32)), std::invalid_argument);
+    }
+}
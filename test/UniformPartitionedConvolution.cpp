@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest.h"
+
+#include "../Convolution.hpp"
+#include "../UniformPartitionedConvolution.hpp"
+
+#include "ConvolutionFixtures.hpp"
+
+using namespace dsp;
+using namespace std;
+
+template <typename T>
+static void checkBlocks(size_t blockSize, size_t kernelSize, T tolerance)
+{
+    const auto input = createNoise<T>(blockSize * 40, 3);
+    const auto kernel = createKernel<T>(kernelSize);
+    const auto expected = convolveReference(input, kernel);
+    
+    UniformPartitionedConvolution<T> convolution(blockSize, kernel.begin(), kernel.end());
+    CHECK(convolution.getPartitions().getPartitionCount() == max<size_t>((kernelSize + blockSize - 1) / blockSize, 1));
+    
+    vector<T> output(input.size());
+    for (size_t i = 0; i < input.size(); i += blockSize)
+        convolution.processBlock(input.data() + i, output.data() + i);
+    
+    CHECK(getRelativeError(output, expected) < tolerance);
+}
+
+TEST_CASE("UniformPartitionedConvolution")
+{
+    SUBCASE("Blocks equal direct convolution")
+    {
+        checkBlocks<float>(64, 1000, 1e-5f);
+        checkBlocks<float>(64, 1024, 1e-5f);
+        checkBlocks<float>(256, 3, 1e-5f);
+        checkBlocks<float>(1, 5, 1e-5f);
+        checkBlocks<double>(128, 2000, 1e-12);
+    }
+    
+    SUBCASE("Streaming in uneven chunks, delayed by a block")
+    {
+        const size_t blockSize = 128;
+        const auto input = createNoise<float>(10000, 5);
+        const auto kernel = createKernel<float>(700);
+        auto expected = convolveReference(input, kernel);
+        expected.resize(input.size() - blockSize);
+        
+        UniformPartitionedConvolution<float> convolution(blockSize, kernel.begin(), kernel.end());
+        CHECK(convolution.getLatency() == blockSize);
+        
+        // In place, which the output is allowed to be
+        auto output = input;
+        for (size_t i = 0, chunk = 1; i < output.size(); i += chunk, chunk = chunk * 7 % 301 + 1)
+            convolution.process(output.data() + i, output.data() + i, min(chunk, output.size() - i));
+        
+        for (size_t i = 0; i < blockSize; ++i)
+            CHECK(output[i] == 0);
+        
+        output.erase(output.begin(), output.begin() + blockSize);
+        CHECK(getRelativeError(output, expected) < 1e-5f);
+    }
+    
+    SUBCASE("Shared partitions, kernel changes and reset")
+    {
+        const auto input = createNoise<float>(2048, 11);
+        const auto kernel = createKernel<float>(300);
+        const auto partitions = make_shared<const ConvolutionPartitions<float>>(64, kernel.data(), kernel.size());
+        
+        UniformPartitionedConvolution<float> left(partitions);
+        UniformPartitionedConvolution<float> right(partitions);
+        vector<float> leftOutput(input.size()), rightOutput(input.size());
+        for (size_t i = 0; i < input.size(); i += 64)
+        {
+            left.processBlock(input.data() + i, leftOutput.data() + i);
+            right.processBlock(input.data() + i, rightOutput.data() + i);
+        }
+        
+        CHECK(leftOutput == rightOutput);
+        
+        // A longer kernel, after a reset, convolves from scratch
+        const auto longer = createKernel<float>(900);
+        left.setKernel(longer.begin(), longer.end());
+        left.reset();
+        CHECK(left.getPartitions().getPartitionCount() == 15);
+        
+        for (size_t i = 0; i < input.size(); i += 64)
+            left.processBlock(input.data() + i, leftOutput.data() + i);
+        
+        CHECK(getRelativeError(leftOutput, convolveReference(input, longer)) < 1e-5f);
+        
+        const auto other = make_shared<const ConvolutionPartitions<float>>(32, kernel.data(), kernel.size());
+        CHECK_THROWS_AS(left.setPartitions(other), std::invalid_argument);
+        CHECK_THROWS_AS(ConvolutionPartitions<float>(0, kernel.data(), kernel.size()), std::invalid_argument);
+    }
+}
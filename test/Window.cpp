@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <stdexcept>
 #include <vector>
 
 #include "doctest.h"
@@ -141,4 +142,28 @@ TEST_CASE("Window")
             CHECK(window[5] == doctest::Approx(1));
         }
     }
+    
+    SUBCASE("Synthesis")
+    {
+        // Overlap-adding analysis times synthesis window gives one everywhere the windows overlap, for any window and hop
+        for (size_t hopSize : {16, 21, 32, 48})
+        {
+            for (auto& window : {createHanningWindow<double>(64), createHammingWindow<double>(64), createRectangularWindow<double>(64)})
+            {
+                const auto synthesis = createSynthesisWindow(window, hopSize);
+                REQUIRE(synthesis.size() == 64);
+                
+                for (size_t n = 0; n < hopSize; ++n)
+                {
+                    double sum = 0;
+                    for (auto m = n; m < 64; m += hopSize)
+                        sum += window[m] * synthesis[m];
+                    
+                    CHECK(sum == doctest::Approx(1));
+                }
+            }
+        }
+        
+        CHECK_THROWS_AS(createSynthesisWindow(createHanningWindow<double>(64), 0), invalid_argument);
+    }
 }